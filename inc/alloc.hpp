@@ -134,7 +134,7 @@ struct allocator {
     }
 
     inline void destroy(T* p) noexcept {
-        p->~U();
+        p->~T();
     }
 
     // comparison operators (required for allocator compatibility)
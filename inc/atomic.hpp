@@ -3,12 +3,19 @@
 #ifndef HERMES_COROUTINE_ENGINE_ATOMIC
 #define HERMES_COROUTINE_ENGINE_ATOMIC
 
+#include <cstddef>
 #include <atomic>
 
 #include "logging.hpp"
 
 namespace hce {
 
+/**
+ The assumed size of a CPU cache line. Atomics written by different threads 
+ are aligned to this size to prevent false sharing.
+ */
+constexpr std::size_t cache_line_size = 64;
+
 /**
 @brief core mechanism for atomic synchronization. 
 
@@ -4,15 +4,25 @@
 #define HERMES_COROUTINE_ENGINE_BLOCKING
 
 #include <memory>
+#include <string>
+#include <sstream>
+#include <optional>
+#include <vector>
 #include <type_traits>
+#include <algorithm>
+#include <limits>
 #include <thread>
+#include <atomic>
+#include <condition_variable>
 
 #include "base.hpp"
 #include "utility.hpp"
 #include "alloc.hpp"
 #include "logging.hpp"
 #include "atomic.hpp"
+#include "chrono.hpp"
 #include "circular_buffer.hpp"
+#include "list.hpp"
 #include "synchronized_list.hpp"
 #include "coroutine.hpp"
 #include "scheduler.hpp"
@@ -29,6 +39,28 @@ namespace blocking {
  */
 size_t reusable_block_worker_cache_size();
 
+/**
+ @brief the maximum count of worker threads executing blocking calls at once
+
+ A limit of `0` (the default) places no cap on the count of workers, a worker 
+ is spawned whenever a blocking call finds no idle worker. Otherwise blocking 
+ calls made while this many workers are busy are queued until a worker is 
+ available, and blocking calls which wait on each other can deadlock if more 
+ of them than the limit are in flight at once. Setting this equal to 
+ `reusable_block_worker_cache_size()` produces a fixed size pool.
+ */
+size_t worker_limit();
+
+/**
+ @brief how long idle workers beyond the reusable cache size wait for more work
+
+ Idle workers in excess of `reusable_block_worker_cache_size()` exit after 
+ waiting this long without receiving an operation, so bursts of blocking calls 
+ can reuse threads without permanently keeping them. A duration of `0` makes 
+ excess workers exit as soon as they are idle.
+ */
+hce::chrono::duration worker_keepalive();
+
 }
 }
 
@@ -107,18 +139,22 @@ struct async_partial :
 
     inline bool on_ready() { return ready_; }
 
-    // this will never be called *except* in cases where m!=nullptr
-    inline void on_resume(void* m) { 
-        t_ = std::unique_ptr<T>((T*)m);
-        ready_ = true;
-    }
+    // the result is emplaced by the worker before resume() is called
+    inline void on_resume(void* m) { ready_ = true; }
 
     inline T get_result() { return std::move(*t_); }
 
+protected:
+    // store the result inline, avoiding a separate allocation
+    template <typename... As>
+    inline void emplace_result(As&&... as) { 
+        t_.emplace(std::forward<As>(as)...); 
+    }
+
 private:
     hce::spinlock lk_;
     bool ready_;
-    std::unique_ptr<T> t_;
+    std::optional<T> t_;
 };
 
 template <>
@@ -145,8 +181,177 @@ private:
     bool ready_;
 };
 
+/*
+ A blocking operation handed to a worker. Operations are embedded in the 
+ awaitable which they resume, so queueing an operation never allocates. 
+ */
+struct operation {
+    // execute the operation, after which ctx may have been deallocated
+    void (*run)(void* ctx) = nullptr;
+    void* ctx = nullptr;
+    operation* next = nullptr;
+};
+
+// intrusive FIFO of operations
+struct operation_queue {
+    inline size_t size() const { return size_; }
+
+    inline void push(operation* op) {
+        op->next = nullptr;
+
+        if(back_) [[likely]] {
+            back_->next = op;
+        } else [[unlikely]] {
+            front_ = op;
+        }
+
+        back_ = op;
+        ++size_;
+    }
+
+    inline operation* pop() {
+        operation* op = front_;
+        front_ = op->next;
+
+        if(!front_) [[likely]] {
+            back_ = nullptr;
+        }
+
+        --size_;
+        return op;
+    }
+
+private:
+    operation* front_ = nullptr;
+    operation* back_ = nullptr;
+    size_t size_ = 0;
+};
+
+// shared state of an `hce::blocking::lane`
+struct lane_context : public printable {
+    lane_context(std::string n, size_t l) : 
+        label(std::move(n)), 
+        limit(l ? l : 1),
+        active(0)
+    { }
+
+    static inline std::string info_name() { 
+        return "hce::blocking::detail::lane_context"; 
+    }
+
+    inline std::string name() const { return lane_context::info_name(); }
+
+    inline std::string content() const { 
+        std::stringstream ss;
+        ss << label << ", limit:" << limit;
+        return ss.str();
+    }
+
+    // `name()` is reserved by `printable`
+    const std::string label;
+    const size_t limit;
+
+    // synchronizes active and pending
+    hce::spinlock lk;
+
+    // count of this lane's operations sent to workers 
+    size_t active;
+
+    // operations waiting for an active operation to complete
+    operation_queue pending;
+};
+
+// types of a batch of blocking calls made with `block_all()`
+template <typename Range, typename Callable>
+struct batch_traits {
+    typedef std::decay_t<Range> range;
+    typedef std::decay_t<Callable> callable;
+    typedef decltype(*std::begin(std::declval<range&>())) element;
+    typedef hce::function_return_type<callable&, element> result;
+    typedef std::conditional_t<
+        std::is_void<result>::value, 
+        void, 
+        std::vector<result>> type;
+};
+
 }
 
+/**
+ @brief a bulkhead limiting the concurrency of a group of blocking calls 
+
+ Blocking calls made from coroutines with `hce::block(lane, cb, args...)` 
+ execute on the same worker threads as every other blocking call, but at 
+ most `limit()` of a lane's calls are handed to workers at once. Calls beyond 
+ the limit wait in the lane's queue without occupying a thread until one of 
+ the lane's active calls completes. This prevents a flood of slow calls to 
+ one dependency from consuming every worker and starving other callers.
+
+ The total count of blocking worker threads in the process, regardless of 
+ lanes, is capped by `hce::config::blocking::worker_limit()` if it is nonzero.
+
+ Like `hce::block()`, calls made outside of a coroutine execute immediately on 
+ the calling thread and are not limited by the lane.
+
+ Copies of a lane share the same limit and queue.
+ */
+struct lane : public printable {
+    lane() = default;
+    lane(const lane& rhs) = default;
+    lane(lane&& rhs) = default;
+    virtual ~lane() { }
+
+    lane& operator=(const lane& rhs) = default;
+    lane& operator=(lane&& rhs) = default;
+
+    /**
+     @brief construct a lane 
+     @param name the lane's label, used for logging and debugging 
+     @param limit the maximum count of the lane's concurrent blocking calls, a limit of `0` is treated as `1`
+     @return the constructed lane 
+     */
+    static inline lane make(std::string name, size_t limit) {
+        HCE_MIN_FUNCTION_ENTER("hce::blocking::lane::make", name, limit);
+        lane l;
+        l.context_ = std::make_shared<detail::lane_context>(
+            std::move(name), 
+            limit);
+        return l;
+    }
+
+    static inline std::string info_name() { return "hce::blocking::lane"; }
+    inline std::string name() const { return lane::info_name(); }
+
+    inline std::string content() const { 
+        return context_ ? context_->content() : std::string();
+    }
+
+    /// return whether the lane has an allocated context
+    inline explicit operator bool() const { return (bool)context_; }
+
+    /// return the lane's label 
+    inline const std::string& label() const { return context_->label; }
+
+    /// return the maximum count of the lane's concurrent blocking calls
+    inline size_t limit() const { return context_->limit; }
+
+    /// return the count of the lane's calls handed to workers 
+    inline size_t active() const { 
+        std::lock_guard<hce::spinlock> lk(context_->lk);
+        return context_->active; 
+    }
+
+    /// return the count of the lane's calls waiting for an active call
+    inline size_t queued() const { 
+        std::lock_guard<hce::spinlock> lk(context_->lk);
+        return context_->pending.size(); 
+    }
+
+private:
+    std::shared_ptr<detail::lane_context> context_;
+
+    friend struct service;
+};
+
 /**
  @brief singleton service maintaining worker threads for executing blocking calls
 
@@ -155,20 +360,41 @@ private:
  - their memory cost is larger than most user objects (due to stack size and `thread_local`s)
  - they require system calls for startup and shutdown 
 
- Instead this mechanism launches threads which listen for tasks over a private 
- synchronized queue, shutting down only when necessary.
+ Instead this mechanism maintains a bounded pool of worker threads which pull 
+ operations from a single shared queue, shutting down only when necessary.
 
  Several layers of optimization exist in order to limit the amount of worker 
  threads that need to get created/destroyed as well as limiting process-wide 
  lock contention:
- - block() checks if the current thread is a scheduler. If it isn't, the Callable 
- is immediately invoked.
- - a thread_local, lockless cache is used to hold reusable worker threads 
- capable of invoking Callables which can be drawn upon to invoke Callables.
- - a process-wide pool of reusable workers is maintained by this object which 
- can be drawn upon to invoke Callables.
- - if none of the previous options are available a new worker thread is 
- created/destroyed as necessary to execute the Callable
+ - block() checks if the current thread is a coroutine. If it isn't, the 
+ Callable is immediately invoked.
+ - a thread_local cache of workers owned by the calling scheduler's thread 
+ is checked first. Its size is limited by 
+ `hce::scheduler::config::reusable_block_worker_limit`. Operations are handed 
+ directly to a cached worker, and the worker returns to the cache when the 
+ awaitable is destroyed. The cache is lock-free and the worker's handoff 
+ spinlock is only shared with the calling thread, so this path never takes 
+ this service's lock.
+ - operations are handed to an idle process-wide worker thread if one is 
+ available
+ - if no worker is idle a new worker is spawned, unless a nonzero 
+ `hce::config::blocking::worker_limit()` has been reached. In that case the 
+ operation is queued until a worker finishes its current operation.
+ - when a worker finds the queue empty it waits for more operations. Idle 
+ workers in excess of 
+ `hce::config::blocking::reusable_block_worker_cache_size()` exit when 
+ `hce::config::blocking::worker_keepalive()` elapses without receiving an 
+ operation, trimming the pool one worker at a time after bursts.
+
+ Because operations beyond a worker limit are queued, a blocking operation 
+ which can only complete after another queued blocking operation executes can 
+ deadlock if the limit is reached. A limit should be set high enough for the 
+ count of blocking operations a process can have waiting on each other at once. 
+ There is no limit by default.
+
+ Operations can be grouped into an `hce::blocking::lane` to bound how many 
+ workers a group can occupy at once, while the worker limit bounds the total 
+ count of worker threads in the process.
  */
 struct service : public hce::printable {
     static inline std::string info_name() { return ("hce::blocking::service"); }
@@ -183,16 +409,99 @@ struct service : public hce::printable {
      This value is determined by:
      hce::config::blocking::reusable_block_worker_cache_size()
 
-     This value represents the process-wide limit of reusable worker threads 
+     This value represents the process-wide limit of idle worker threads 
      maintained by this `service` object. This value only represents the count 
-     of threads this mechanism will *persist* between calls to `block()`. As 
-     many worker threads as necessary will be spawned and destroyed.
+     of threads this mechanism will *persist* between calls to `block()`. 
 
-     @return the maximum count of `block()` worker threads the service will persist
+     @return the maximum count of idle `block()` worker threads the service will persist
      */
     inline size_t worker_cache_size() const { 
-        HCE_LOW_METHOD_BODY("worker_cache_size",worker_cache_.size());
-        return worker_cache_.size();
+        HCE_LOW_METHOD_BODY("worker_cache_size",worker_cache_size_);
+        return worker_cache_size_;
+    }
+
+    /**
+     This value is determined by:
+     hce::config::blocking::worker_limit()
+
+     unless changed by `set_worker_limit()`.
+
+     @return the maximum count of worker threads which can exist at once, or `0` if there is no limit
+     */
+    inline size_t worker_limit() const { 
+        size_t l;
+
+        {
+            std::lock_guard<hce::spinlock> lk(lk_);
+            l = worker_limit_;
+        }
+
+        HCE_LOW_METHOD_BODY("worker_limit",l);
+        return l;
+    }
+
+    /**
+     @brief change the maximum count of worker threads which can exist at once
+
+     Workers are spawned for queued operations if the limit is raised or 
+     removed. Lowering the limit does not stop busy workers, the worker count 
+     drops as workers go idle and are trimmed.
+
+     @param limit the new limit, or `0` for no limit
+     */
+    inline void set_worker_limit(size_t limit) {
+        HCE_LOW_METHOD_ENTER("set_worker_limit",limit);
+        std::unique_lock<spinlock> lk(lk_);
+        worker_limit_ = limit;
+
+        // spawn workers for operations which no idle worker will take
+        size_t pending = operations_.size() > wakeups_ 
+            ? operations_.size() - wakeups_ 
+            : 0;
+        size_t spawns = std::min(pending, worker_room_());
+        counters_.spawns += spawns;
+        worker_count_ += spawns;
+        lk.unlock();
+
+        while(spawns) {
+            spawn_();
+            --spawns;
+        }
+    }
+
+    /**
+     This value is determined by:
+     hce::config::blocking::worker_keepalive() 
+     
+     unless changed by `set_worker_keepalive()`.
+
+     @return how long idle workers beyond the worker cache size persist
+     */
+    inline hce::chrono::duration worker_keepalive() const { 
+        hce::chrono::duration d;
+
+        {
+            std::lock_guard<hce::spinlock> lk(lk_);
+            d = worker_keepalive_;
+        }
+
+        HCE_LOW_METHOD_BODY("worker_keepalive",d);
+        return d;
+    }
+
+    /**
+     @brief change how long idle workers beyond the worker cache size persist
+
+     Workers which are already idle apply the new keepalive to the time they 
+     became idle.
+
+     @param keepalive the new keepalive
+     */
+    inline void set_worker_keepalive(hce::chrono::duration keepalive) {
+        HCE_LOW_METHOD_ENTER("set_worker_keepalive",keepalive);
+        std::lock_guard<hce::spinlock> lk(lk_);
+        worker_keepalive_ = keepalive;
+        cv_.notify_all();
     }
 
     /**
@@ -203,7 +512,7 @@ struct service : public hce::printable {
 
         {
             std::lock_guard<hce::spinlock> lk(lk_);
-            c = worker_active_count_ + worker_cache_.used();
+            c = worker_count_;
         }
 
         HCE_LOW_METHOD_BODY("worker_count",c);
@@ -211,15 +520,81 @@ struct service : public hce::printable {
     }
 
     /**
-     @brief shutdown, join, destruct and deallocate all workers in the process-wide cache 
+     @return the count of blocking operations waiting for a worker thread
+     */
+    inline size_t queued() const {
+        size_t c;
+
+        {
+            std::lock_guard<hce::spinlock> lk(lk_);
+            c = operations_.size();
+        }
+
+        HCE_LOW_METHOD_BODY("queued",c);
+        return c; 
+    }
+
+    /**
+     @brief worker reuse counters info struct
+     */
+    struct counters {
+        size_t hits; // operations handed to an idle worker
+        size_t misses; // operations which found no idle worker
+        size_t spawns; // worker threads launched
+        size_t trims; // idle workers which exited after their keepalive
+        size_t local_hits; // operations handed to a scheduler cached worker
+    };
+
+    /**
+     @return the service's worker reuse counters
+     */
+    inline counters get_counters() const {
+        std::lock_guard<hce::spinlock> lk(lk_);
+        counters c = counters_;
+
+        for(auto& cache : local_caches_) {
+            c.local_hits += cache->hits.load(std::memory_order_relaxed);
+        }
+
+        return c;
+    }
+
+    /**
+     @brief reset all worker reuse counters for fresh calculation
+     */
+    inline void reset_counters() {
+        std::lock_guard<hce::spinlock> lk(lk_);
+        counters_ = counters{ 0, 0, 0, 0, 0 };
+
+        for(auto& cache : local_caches_) {
+            cache->hits.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     @brief shutdown, join, destruct and deallocate all idle process-wide workers 
+
+     Workers cached by scheduler threads are unaffected.
      */
     inline void clear_worker_cache() {
         HCE_LOW_METHOD_ENTER("clear");
 
-        std::lock_guard<spinlock> lk(lk_);
-        while(worker_cache_.used()) {
-            worker_cache_.pop();
+        std::unique_lock<spinlock> lk(lk_);
+
+        // convert every idle worker into a retiring worker
+        retiring_ += idle_;
+        idle_ = 0;
+        cv_.notify_all();
+
+        // wait for the retiring workers to exit
+        while(retiring_) {
+            lk.unlock();
+            std::this_thread::yield();
+            lk.lock();
         }
+
+        lk.unlock();
+        reap_();
     }
 
     /**
@@ -243,7 +618,7 @@ struct service : public hce::printable {
      `block()`, or if called outside of an `hce` coroutine, the Callable will be 
      executed immediately on the *current* thread.
 
-     Otherwise the user Callable will execute on a dedicated thread, and won't 
+     Otherwise the user Callable will execute on a worker thread, and won't 
      have direct access to the caller's local scheduler or coroutine. IE, 
      `hce::scheduler::in()` and `hce::coroutine::in()` will return `false`. 
      Access to the source scheduler will have to be manually given by user code 
@@ -268,59 +643,196 @@ struct service : public hce::printable {
 
         return block_(
             std::integral_constant<bool,isv::value>(),
+            nullptr,
             std::forward<Callable>(cb),
             std::forward<As>(as)...);
     }
 
-private:
-    // block worker thread 
-    struct worker : public printable {
-        worker() : thd_(worker::run_, &operations_) { 
-            HCE_LOW_CONSTRUCTOR();
+    /**
+     @brief execute a Callable on a worker thread, limited by a lane 
+
+     Behaves like `block(cb, as...)`, except that the Callable is queued in 
+     the lane without occupying a thread while `l.limit()` of the lane's calls 
+     are already active.
+
+     @param l the lane limiting the call's concurrency
+     @param cb a function, Functor, lambda or std::function
+     @param as arguments to cb
+     @return an awaitable returning the result of the Callable 
+     */
+    template <typename Callable, typename... As>
+    inline awt<hce::function_return_type<Callable,As...>> 
+    block(hce::blocking::lane l, Callable&& cb, As&&... as) {
+        typedef hce::function_return_type<Callable,As...> RETURN_TYPE;
+        using isv = typename std::is_void<RETURN_TYPE>;
+
+        HCE_LOW_METHOD_ENTER("block",l,hce::callable_to_string(cb));
+
+        return block_(
+            std::integral_constant<bool,isv::value>(),
+            std::move(l.context_),
+            std::forward<Callable>(cb),
+            std::forward<As>(as)...);
+    }
+
+    /**
+     @brief execute a Callable on worker threads for every element of a range
+
+     Every element's operation is submitted at once and fanned out across 
+     available workers. The returned awaitable is resumed a single time, when 
+     all of the operations have completed, so the awaiting coroutine is only 
+     rescheduled once per batch instead of once per element.
+
+     The range is moved or copied into the awaitable and the Callable is 
+     invoked concurrently by multiple workers with each element of the range, 
+     so it must be safe to call from multiple threads at once.
+
+     If not called from a coroutine the operations are executed sequentially 
+     on the calling thread.
+
+     @param r a range of elements to pass to the Callable
+     @param cb a function, Functor or lambda accepting an element of r
+     @return an awaitable returning a vector of results in the order of r, or void if the Callable returns void
+     */
+    template <typename Range, typename Callable>
+    inline awt<typename detail::batch_traits<Range,Callable>::type>
+    block_all(Range&& r, Callable&& cb) {
+        typedef detail::batch_traits<Range,Callable> traits;
+        typedef typename traits::type T;
+        typedef typename traits::result R;
+
+        HCE_LOW_METHOD_ENTER("block_all",hce::callable_to_string(cb));
+
+        if(!hce::coroutine::in()) {
+            HCE_MIN_METHOD_BODY("block_all","executing on current thread");
+
+            if constexpr(std::is_void<R>::value) {
+                for(auto&& e : r) { cb(e); }
+                return hce::awt<void>(new service::sync<void>);
+            } else {
+                T results;
+
+                for(auto&& e : r) { results.push_back(cb(e)); }
+
+                return hce::awt<T>(new service::sync<T>(std::move(results)));
+            }
         }
 
-        virtual ~worker() { 
-            HCE_LOW_DESTRUCTOR(); 
-            operations_.close();
-            thd_.join();
+        auto bi = new service::batch<
+            R,
+            typename traits::range,
+            typename traits::callable>(
+                std::forward<Range>(r),
+                std::forward<Callable>(cb));
+
+        if(bi->empty()) [[unlikely]] {
+            // nothing to execute
+            bi->complete();
+        } else [[likely]] {
+            HCE_MIN_METHOD_BODY("block_all","executing on worker threads");
+            schedule_(bi->operations());
         }
 
+        return hce::awt<T>(bi);
+    }
+
+private:
+    // block worker thread 
+    struct worker : public printable {
+        worker() { HCE_LOW_CONSTRUCTOR(); }
+        virtual ~worker() { HCE_LOW_DESTRUCTOR(); }
+
         static inline std::string info_name() { 
             return "hce::blocking::service::worker"; 
         }
 
         inline std::string name() const { return worker::info_name(); }
 
-        // schedule an operation 
-        inline void schedule(std::unique_ptr<hce::thunk>&& operation) { 
-            operations_.push_back(std::move(operation));
+        // hand an operation to a worker owned by a scheduler's local cache
+        inline void assign(detail::operation* op) {
+            std::lock_guard<hce::spinlock> lk(lk_);
+            operation_ = op;
+            cv_.notify_one();
+        }
+
+        // tell a worker owned by a local cache to exit when it is idle
+        inline void retire() {
+            std::lock_guard<hce::spinlock> lk(lk_);
+            retire_ = true;
+            cv_.notify_one();
+        }
+
+        // execute assigned operations until retired
+        inline void run_local() {
+            std::unique_lock<hce::spinlock> lk(lk_);
+
+            while(true) {
+                if(operation_) [[likely]] {
+                    detail::operation* op = operation_;
+                    operation_ = nullptr;
+                    lk.unlock();
+                    op->run(op->ctx);
+                    lk.lock();
+                } else if(retire_) [[unlikely]] {
+                    break;
+                } else [[likely]] {
+                    cv_.wait(lk);
+                }
+            }
         }
 
+        // operating system thread, set by the thread which spawned the worker
+        std::thread thd;
+
+        // true if owned by a local cache, set before the thread launches
+        bool local = false;
+
     private:
-        // worker thread scheduler run function
-        static inline void run_(
-                synchronized_list<std::unique_ptr<hce::thunk>>* operations) 
-        {
-            std::unique_ptr<hce::thunk> operation;
+        // synchronizes operation handoff to a local worker, which only 
+        // contends between the worker and its owning scheduler thread
+        hce::spinlock lk_;
+        std::condition_variable_any cv_;
+        detail::operation* operation_ = nullptr;
+        bool retire_ = false;
+    };
 
-            while(operations->pop(operation)) [[likely]] {
-                // execute operations sequentially until recv() returns false
-                (*operation)();
+    /*
+     A scheduler thread's cache of workers. Idle workers are stored in a stack 
+     of `limit` atomic slots which only the owning thread pushes and pops, 
+     `top` is the owning thread's count of filled slots. Retiring the cache 
+     from another thread exchanges every slot with `retired_slot()`, so the 
+     owning thread detects retirement from the value its own exchange returns 
+     and no lock is needed on either side. Workers are counted in `owned` from 
+     spawn until they are retired, whether idle or busy. 
+     */
+    struct local_cache {
+        local_cache(size_t l) : 
+            limit(l), 
+            owned(0), 
+            hits(0), 
+            orphaned(false),
+            idle(new std::atomic<worker*>[l]),
+            top(0)
+        { 
+            for(size_t i = 0; i < limit; ++i) {
+                idle[i].store(nullptr, std::memory_order_relaxed);
             }
         }
 
-        // Blocking operation queue. No reason to use thread_local cache
-        // for hce::thunk, because it would be essentially doing a one-way 
-        // memory steal from the scheduler thread to the block thread.
-        //
-        // However, it's fine that the object itself use the 
-        // `pool_allocator` as its allocator, because list node memory will 
-        // be managed and reused inside the object no matter which thread 
-        // allocates the initial memory.
-        hce::synchronized_list<std::unique_ptr<hce::thunk>> operations_;
+        // the value of a slot after the cache has been retired
+        static inline worker* retired_slot() { 
+            return reinterpret_cast<worker*>(std::uintptr_t(1));
+        }
+
+        const size_t limit;
+        std::atomic<size_t> owned; 
+        std::atomic<size_t> hits;
+
+        // set when the cache's workers have been retired
+        std::atomic<bool> orphaned;
 
-        // operating system thread
-        std::thread thd_;
+        std::unique_ptr<std::atomic<worker*>[]> idle;
+        size_t top; // only accessed by the owning thread
     };
 
     // awaitable implementation for returning an immediately available value
@@ -349,25 +861,31 @@ private:
         inline std::string name() const { return sync<T>::info_name(); }
     };
 
-    // awaitable implementation for returning an asynchronously available value
-    template <typename T>
+    /*
+     Awaitable implementation for returning an asynchronously available value. 
+     The Callable and its result are stored inline, making this awaitable the 
+     only allocation required for a blocking call.
+     */
+    template <typename T, typename Callable>
     struct async : public 
            scheduler::reschedule<hce::blocking::detail::async_partial<T>>
     {
-        async() : 
+        async(Callable&& cb, std::shared_ptr<detail::lane_context>&& l) : 
             scheduler::reschedule<hce::blocking::detail::async_partial<T>>(),
-            // on construction get a worker
-            wkr_(service::get().checkout_worker_())
+            cb_(std::move(cb)),
+            lane_(std::move(l))
         { 
             HCE_MED_CONSTRUCTOR();
+            op_.run = &async<T,Callable>::run_;
+            op_.ctx = this;
         }
 
         virtual ~async() {
             HCE_MED_DESTRUCTOR();
 
-            // return the worker to its scheduler
-            if(wkr_) [[likely]] { 
-                service::get().checkin_worker_(std::move(wkr_));
+            // return a local worker to its scheduler's cache
+            if(wkr_) [[likely]] {
+                service::checkin_local_(cache_.get(), wkr_);
             }
         }
         
@@ -375,18 +893,172 @@ private:
             return type::templatize<T>("hce::blocking::service::async"); 
         }
 
-        inline std::string name() const { return async<T>::info_name(); }
+        inline std::string name() const { 
+            return async<T,Callable>::info_name(); 
+        }
+
+        inline detail::operation* op() { return &op_; }
+
+        inline detail::lane_context* lane() { return lane_.get(); }
 
-        // return the contractor's worker
-        inline service::worker& worker() { return *wkr_; }
+        // hold a local worker until the awaitable is destroyed
+        inline void checkout(const std::shared_ptr<local_cache>& c, 
+                             service::worker* w) {
+            cache_ = c;
+            wkr_ = w;
+        }
+
+    private:
+        // executed by a worker thread
+        static inline void run_(void* ctx) {
+            auto a = static_cast<async<T,Callable>*>(ctx);
+
+            if constexpr(std::is_void<T>::value) {
+                (*(a->cb_))();
+            } else {
+                a->emplace_result((*(a->cb_))());
+            }
+
+            // the Callable must be destroyed before resuming because the 
+            // awaitable can be deallocated as soon as the awaiter resumes
+            a->cb_.reset();
+
+            if(a->lane_) [[unlikely]] {
+                service::release_lane_(*(a->lane_));
+            }
+
+            a->resume(nullptr);
+        }
+
+        std::optional<Callable> cb_;
+        std::shared_ptr<detail::lane_context> lane_;
+        detail::operation op_;
+        // keeps the cache alive if its thread exits before the awaitable is 
+        // destroyed
+        std::shared_ptr<local_cache> cache_;
+        service::worker* wkr_ = nullptr;
+    };
+
+    /*
+     Awaitable implementation for a batch of blocking calls made by 
+     `block_all()`. Each element's operation is embedded in the awaitable and 
+     the awaiter is resumed by whichever worker completes the last operation.
+     */
+    template <typename R, typename Range, typename Callable>
+    struct batch : public 
+           scheduler::reschedule<hce::blocking::detail::async_partial<
+               std::conditional_t<std::is_void<R>::value,void,std::vector<R>>>>
+    {
+        typedef std::conditional_t<
+            std::is_void<R>::value,
+            void,
+            std::vector<R>> result_type;
+
+        template <typename RANGE, typename CALLABLE>
+        batch(RANGE&& r, CALLABLE&& cb) : 
+            scheduler::reschedule<
+                hce::blocking::detail::async_partial<result_type>>(),
+            range_(std::forward<RANGE>(r)),
+            cb_(std::forward<CALLABLE>(cb))
+        { 
+            HCE_MED_CONSTRUCTOR();
+
+            for(auto it = std::begin(range_); it != std::end(range_); ++it) {
+                elements_.push_back(element{ {}, this, elements_.size(), it });
+            }
+
+            // operations are linked after the element vector stops growing
+            for(auto& e : elements_) {
+                e.op.run = &batch<R,Range,Callable>::run_;
+                e.op.ctx = &e;
+                operations_.push(&(e.op));
+            }
+
+            if constexpr(!std::is_void<R>::value) {
+                results_.resize(elements_.size());
+            }
+
+            remaining_.store(elements_.size(), std::memory_order_relaxed);
+        }
+
+        virtual ~batch() { HCE_MED_DESTRUCTOR(); }
+        
+        static inline std::string info_name() { 
+            return type::templatize<R>("hce::blocking::service::batch"); 
+        }
+
+        inline std::string name() const { 
+            return batch<R,Range,Callable>::info_name(); 
+        }
+
+        inline bool empty() const { return elements_.empty(); }
+
+        // the batch's operations, to be handed to workers
+        inline detail::operation_queue& operations() { return operations_; }
+
+        // resume the awaiter with the batch's results
+        inline void complete() {
+            if constexpr(!std::is_void<R>::value) {
+                result_type results;
+                results.reserve(results_.size());
+
+                for(auto& r : results_) {
+                    results.push_back(std::move(*r));
+                }
+
+                this->emplace_result(std::move(results));
+            }
+
+            this->resume(nullptr);
+        }
 
     private:
-        std::unique_ptr<service::worker> wkr_;
+        typedef decltype(std::begin(std::declval<Range&>())) iterator;
+
+        struct element {
+            detail::operation op;
+            batch<R,Range,Callable>* parent;
+            size_t index;
+            iterator it;
+        };
+
+        // executed by a worker thread
+        static inline void run_(void* ctx) {
+            auto e = static_cast<element*>(ctx);
+            auto b = e->parent;
+
+            if constexpr(std::is_void<R>::value) {
+                b->cb_(*(e->it));
+            } else {
+                b->results_[e->index].emplace(b->cb_(*(e->it)));
+            }
+
+            // only the worker completing the final operation can touch the 
+            // batch afterwards, as it can be deallocated once resumed
+            if(b->remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                b->complete();
+            }
+        }
+
+        Range range_;
+        Callable cb_;
+        std::vector<element> elements_;
+        detail::operation_queue operations_;
+        std::vector<std::optional<
+            std::conditional_t<std::is_void<R>::value,bool,R>>> results_;
+        std::atomic<size_t> remaining_;
     };
 
     service() :
-        worker_active_count_(0),
-        worker_cache_(config::blocking::reusable_block_worker_cache_size())
+        running_(true),
+        worker_cache_size_(config::blocking::reusable_block_worker_cache_size()),
+        worker_limit_(config::blocking::worker_limit()),
+        worker_keepalive_(config::blocking::worker_keepalive()),
+        worker_count_(0),
+        idle_(0),
+        wakeups_(0),
+        retiring_(0),
+        counters_{ 0, 0, 0, 0, 0 }
     { 
         service::instance_ = this;
         HCE_HIGH_CONSTRUCTOR();
@@ -395,73 +1067,423 @@ private:
     virtual ~service() { 
         HCE_HIGH_DESTRUCTOR(); 
         service::instance_ = nullptr;
+
+        std::unique_lock<spinlock> lk(lk_);
+
+        // retire workers cached by scheduler threads, which will not touch 
+        // their caches again
+        for(auto& cache : local_caches_) {
+            retire_local_cache_(*cache);
+        }
+
+        local_caches_.clear();
+
+        // workers finish any queued operations before exiting
+        running_ = false;
+        cv_.notify_all();
+
+        while(worker_count_) {
+            lk.unlock();
+            std::this_thread::yield();
+            lk.lock();
+        }
+
+        lk.unlock();
+        reap_();
     }
 
-    // retrieve a worker thread from the service to execute blocking operations on
-    inline std::unique_ptr<worker> checkout_worker_() {
-        // attempt to pull from the thread_local cache first
-        std::unique_ptr<worker> w;
+    // return how many more workers can be spawned, lock must be held
+    inline size_t worker_room_() const {
+        if(!worker_limit_) [[likely]] {
+            return std::numeric_limits<size_t>::max();
+        } else if(worker_count_ < worker_limit_) {
+            return worker_limit_ - worker_count_;
+        } else [[unlikely]] {
+            return 0;
+        }
+    }
 
+    // schedule an operation to be executed on a worker thread
+    inline void schedule_(detail::operation* op) {
         std::unique_lock<spinlock> lk(lk_);
-        ++worker_active_count_; // update checked out thread count
-        
-        // check if we have any workers in reserve
-        if(worker_cache_.empty()) [[unlikely]] {
-            // need to start a new worker thread but don't need to hold the lock 
+        operations_.push(op);
+
+        if(idle_) [[likely]] {
+            // hand the operation to an idle worker
+            ++counters_.hits;
+            --idle_;
+            ++wakeups_;
+            cv_.notify_one();
+        } else if(worker_room_()) [[unlikely]] {
+            // reserve the new worker's place while the lock is held
+            ++counters_.misses;
+            ++counters_.spawns;
+            ++worker_count_;
             lk.unlock();
+            spawn_();
+        } else {
+            ++counters_.misses;
+            HCE_TRACE_METHOD_BODY(
+                "schedule_",
+                "worker limit reached, queued operations: ",
+                operations_.size());
+        }
+    }
 
-            // as a fallback generate a new worker thread 
-            w.reset(new worker());
-            HCE_TRACE_METHOD_BODY("checkout_worker_","allocated ",w.get());
-        } else [[likely]] {
-            // get the first available worker
-            w = std::move(worker_cache_.front());
-            worker_cache_.pop();
-            lk.unlock();
+    // schedule a batch of operations to be executed on worker threads
+    inline void schedule_(detail::operation_queue& ops) {
+        std::unique_lock<spinlock> lk(lk_);
+        size_t count = ops.size();
+        size_t spawns = 0;
 
-            HCE_TRACE_METHOD_BODY("checkout_worker_","reused ",w.get());
+        while(ops.size()) {
+            operations_.push(ops.pop());
         }
 
-        return w;
+        // hand as many operations as possible to idle workers
+        size_t wakeups = std::min(count, idle_);
+        counters_.hits += wakeups;
+        idle_ -= wakeups;
+        wakeups_ += wakeups;
+        count -= wakeups;
+
+        for(size_t i = 0; i < wakeups; ++i) {
+            cv_.notify_one();
+        }
+
+        // spawn workers for the remainder, up to the worker limit 
+        spawns = std::min(count, worker_room_());
+
+        counters_.misses += count;
+        counters_.spawns += spawns;
+        worker_count_ += spawns;
+        lk.unlock();
+
+        while(spawns) {
+            spawn_();
+            --spawns;
+        }
     }
 
-    // return a worker to the service when blocking operation is completed
-    inline void checkin_worker_(std::unique_ptr<worker>&& w) {
+    // launch a new worker thread, whose place in worker_count_ is reserved
+    inline worker* spawn_(bool local=false) {
+        // join any workers which have exited since the last spawn
+        reap_();
+
+        worker* w = new worker;
+        w->local = local;
+        std::thread thd(&service::run_, this, w);
+
+        // the thread handle must be set before the worker can be reaped
         std::lock_guard<spinlock> lk(lk_);
-        --worker_active_count_; // update checked out thread count
-        
-        if(worker_cache_.full()) {
-            HCE_TRACE_METHOD_BODY("checkin_worker_","discarded ",w.get());
-        } else { 
-            HCE_TRACE_METHOD_BODY("checkin_worker_","cached ",w.get());
-            worker_cache_.push(std::move(w)); // reuse worker
+        w->thd = std::move(thd);
+        HCE_TRACE_METHOD_BODY("spawn_","spawned ",w);
+        return w;
+    }
+
+    /*
+     Return the calling thread's local worker cache. The cache is constructed 
+     the first time a thread calls this, with a limit taken from the 
+     thread's scheduler. The returned `std::shared_ptr` is released when the 
+     thread exits, retiring the cached workers.
+     */
+    static std::shared_ptr<local_cache>& tl_local_cache_();
+
+    inline std::shared_ptr<local_cache>& local_cache_() {
+        auto& c = tl_local_cache_();
+
+        if(!c || c->orphaned.load(std::memory_order_acquire)) [[unlikely]] {
+            size_t limit = hce::scheduler::in() 
+                ? hce::scheduler::local().reusable_block_worker_limit()
+                : 0;
+
+            c = std::make_shared<local_cache>(limit);
+
+            if(limit) {
+                std::lock_guard<spinlock> lk(lk_);
+                local_caches_.push_back(c);
+            }
         }
+
+        return c;
+    }
+
+    // return a worker from the local cache or nullptr if none are available
+    inline worker* checkout_local_(local_cache* c) {
+        if(c->top) [[likely]] {
+            --(c->top);
+            worker* w = c->idle[c->top].exchange(nullptr, 
+                                                 std::memory_order_acq_rel);
+
+            if(w != local_cache::retired_slot()) [[likely]] {
+                c->hits.fetch_add(1, std::memory_order_relaxed);
+                return w;
+            } else [[unlikely]] {
+                // the cache was retired, leave the slot marked
+                c->idle[c->top].store(w, std::memory_order_relaxed);
+                return nullptr;
+            }
+        }
+
+        if(c->owned.load(std::memory_order_relaxed) < c->limit) {
+            {
+                std::lock_guard<spinlock> lk(lk_);
+
+                if(!worker_room_()) [[unlikely]] {
+                    return nullptr;
+                }
+
+                ++counters_.misses;
+                ++counters_.spawns;
+                ++worker_count_;
+            }
+
+            ++(c->owned);
+            return spawn_(true);
+        } else [[unlikely]] {
+            return nullptr;
+        }
+    }
+
+    // return a local worker when its awaitable is destroyed
+    static inline void checkin_local_(local_cache* c, worker* w) {
+        if(tl_local_cache_().get() == c && 
+           c->top < c->limit &&
+           !c->orphaned.load(std::memory_order_acquire)) [[likely]] 
+        {
+            auto& slot = c->idle[c->top];
+
+            if(!slot.exchange(w, std::memory_order_acq_rel)) [[likely]] {
+                // if the cache is retired after this point the retiring 
+                // thread takes the worker from the slot
+                ++(c->top);
+                return;
+            } else {
+                // the cache was retired before the push, take the worker 
+                // back unless the retiring thread already did
+                if(slot.exchange(local_cache::retired_slot(), 
+                                 std::memory_order_acq_rel) != w) 
+                {
+                    return;
+                }
+            }
+        }
+
+        // the awaitable was destroyed on another thread, or the cache has 
+        // been retired
+        --(c->owned);
+        w->retire();
+    }
+
+    // retire a local cache's idle workers
+    static inline void retire_local_cache_(local_cache& c) {
+        c.orphaned.store(true, std::memory_order_release);
+
+        for(size_t i = 0; i < c.limit; ++i) {
+            worker* w = c.idle[i].exchange(local_cache::retired_slot(), 
+                                           std::memory_order_acq_rel);
+
+            if(w && w != local_cache::retired_slot()) {
+                w->retire();
+                --(c.owned);
+            }
+        }
+    }
+
+    // called when a thread with a local worker cache exits
+    static inline void release_local_cache_(std::shared_ptr<local_cache>& c) {
+        if(c && c->limit && service::instance_) [[likely]] {
+            service& s = *(service::instance_);
+            std::lock_guard<spinlock> lk(s.lk_);
+            auto it = std::find(s.local_caches_.begin(), 
+                                s.local_caches_.end(), 
+                                c);
+
+            if(it != s.local_caches_.end()) {
+                s.local_caches_.erase(it);
+            }
+
+            s.retire_local_cache_(*c);
+        }
+    }
+
+    // send an operation to a local worker if possible, else to the 
+    // process-wide operation queue
+    template <typename Async>
+    inline void dispatch_(Async* ai) {
+        detail::lane_context* l = ai->lane();
+
+        if(l) [[unlikely]] {
+            std::lock_guard<spinlock> lk(l->lk);
+
+            if(l->active >= l->limit) {
+                // wait for one of the lane's active operations to complete
+                HCE_MIN_METHOD_BODY("block","queued on lane ",*l);
+                l->pending.push(ai->op());
+                return;
+            }
+
+            ++(l->active);
+        }
+
+        auto& c = local_cache_();
+        worker* w = c->limit ? checkout_local_(c.get()) : nullptr;
+
+        if(w) [[likely]] {
+            HCE_MIN_METHOD_BODY("block","executing on local worker ",w);
+            ai->checkout(c, w);
+            w->assign(ai->op());
+        } else [[unlikely]] {
+            HCE_MIN_METHOD_BODY("block","executing on worker thread");
+            schedule_(ai->op());
+        }
+    }
+
+    // called by a worker when a lane's operation completes
+    static inline void release_lane_(detail::lane_context& l) {
+        detail::operation* op = nullptr;
+
+        {
+            std::lock_guard<spinlock> lk(l.lk);
+
+            if(l.pending.size()) {
+                // the next operation inherits the completed operation's place
+                op = l.pending.pop();
+            } else {
+                --(l.active);
+            }
+        }
+
+        if(op) {
+            service::get().schedule_(op);
+        }
+    }
+
+    // join and deallocate workers which have exited
+    inline void reap_() {
+        hce::list<worker*> exited;
+
+        {
+            std::lock_guard<spinlock> lk(lk_);
+            size_t count = exited_.size();
+
+            while(count) {
+                worker* w = exited_.front();
+                exited_.pop();
+
+                // a worker can exit before its spawner sets its thread handle
+                if(w->thd.joinable()) [[likely]] {
+                    exited.push_back(w);
+                } else [[unlikely]] {
+                    exited_.push_back(w);
+                }
+
+                --count;
+            }
+        }
+
+        while(exited.size()) {
+            std::unique_ptr<worker> w(exited.front());
+            exited.pop();
+            w->thd.join();
+            HCE_TRACE_METHOD_BODY("reap_","joined ",w.get());
+        }
+    }
+
+    // worker thread run function
+    inline void run_(worker* w) {
+        if(w->local) [[likely]] {
+            w->run_local();
+
+            std::lock_guard<spinlock> lk(lk_);
+            --worker_count_;
+            exited_.push_back(w);
+            return;
+        }
+
+        std::unique_lock<spinlock> lk(lk_);
+
+        while(true) {
+            if(operations_.size()) [[likely]] {
+                detail::operation* op = operations_.pop();
+                lk.unlock();
+
+                // execute the operation outside the lock
+                op->run(op->ctx);
+
+                lk.lock();
+            } else if(!running_) [[unlikely]] {
+                break;
+            } else if(idle_ >= worker_cache_size_ && 
+                      worker_keepalive_ <= hce::chrono::duration(0)) [[unlikely]] 
+            {
+                // excess workers exit immediately without a keepalive
+                ++counters_.trims;
+                break;
+            } else [[likely]] {
+                // wait for an operation to be handed to this worker
+                ++idle_;
+                auto idle_since = hce::chrono::now();
+
+                while(!wakeups_ && !retiring_ && running_) {
+                    if(idle_ <= worker_cache_size_) [[likely]] {
+                        // this worker is within the cache size, wait forever
+                        cv_.wait(lk);
+                    } else if(cv_.wait_until(
+                                  lk, 
+                                  idle_since + worker_keepalive_) == 
+                              std::cv_status::timeout && 
+                              !wakeups_ && 
+                              !retiring_ &&
+                              idle_ > worker_cache_size_) 
+                    {
+                        // trim this excess worker
+                        break;
+                    }
+                }
+
+                if(wakeups_) [[likely]] {
+                    --wakeups_;
+                } else if(retiring_) [[unlikely]] {
+                    --retiring_;
+                    break;
+                } else if(running_) [[unlikely]] {
+                    --idle_;
+                    ++counters_.trims;
+                    HCE_TRACE_METHOD_BODY("run_","trimmed idle worker ",w);
+                    break;
+                } else {
+                    // service is shutting down
+                    --idle_;
+                }
+            }
+        }
+
+        --worker_count_;
+        exited_.push_back(w);
     }
 
     template <typename Callable, typename... As>
     inline hce::awt<hce::function_return_type<Callable,As...>>
-    block_(std::false_type, Callable&& cb, As&&... as) {
+    block_(std::false_type, 
+           std::shared_ptr<detail::lane_context>&& l, 
+           Callable&& cb, 
+           As&&... as) 
+    {
         typedef hce::function_return_type<Callable,As...> T;
 
         if(hce::coroutine::in()) {
-            // construct an asynchronous awaitable implementation
-            auto ai = new service::async<T>();
-            auto& wkr = ai->worker();
-            HCE_MIN_METHOD_BODY("block","executing on ",wkr);
-            
-            hce::thunk* th = new hce::thunk;
-
-            hce::alloc::construct_thunk_ptr(
-                th,
-                [ai,
-                 cb=std::forward<Callable>(cb),
-                 ... as=std::forward<As>(as)]() mutable -> void {
-                    // pass the allocated T to the async and resume it
-                    ai->resume(new T(cb(std::forward<As>(as)...)));
-                });
-
-            // construct the operation and send to the worker
-            wkr.schedule(std::unique_ptr<hce::thunk>(th));
+            auto fn = [cb=std::forward<Callable>(cb),
+                       ... as=std::forward<As>(as)]() mutable -> T {
+                return cb(std::forward<As>(as)...);
+            };
+
+            // construct an asynchronous awaitable implementation containing 
+            // the operation and send it to a worker
+            auto ai = new service::async<T,decltype(fn)>(
+                std::move(fn),
+                std::move(l));
+            dispatch_(ai);
 
             // return an awaitable to await the result of the blocking call
             return hce::awt<T>(ai);
@@ -478,24 +1500,21 @@ private:
     // void return specialization 
     template <typename Callable, typename... As>
     inline hce::awt<void>
-    block_(std::true_type, Callable&& cb, As&&... as) {
+    block_(std::true_type, 
+           std::shared_ptr<detail::lane_context>&& l, 
+           Callable&& cb, 
+           As&&... as) 
+    {
         if(hce::coroutine::in()) {
-            auto ai = new service::async<void>();
-            auto& wkr = ai->worker(); 
-            HCE_MIN_METHOD_BODY("block","executing on ",wkr);
-
-            hce::thunk* th = new hce::thunk;
-
-            hce::alloc::construct_thunk_ptr(
-                th, 
-                [ai,
-                 cb=std::forward<Callable>(cb),
-                 ... as=std::forward<As>(as)]() mutable -> void {
-                    cb(std::forward<As>(as)...);
-                    ai->resume(nullptr);
-                });
-
-            wkr.schedule(std::unique_ptr<hce::thunk>(th));
+            auto fn = [cb=std::forward<Callable>(cb),
+                       ... as=std::forward<As>(as)]() mutable -> void {
+                cb(std::forward<As>(as)...);
+            };
+
+            auto ai = new service::async<void,decltype(fn)>(
+                std::move(fn),
+                std::move(l));
+            dispatch_(ai);
             return hce::awt<void>(ai);
         } else {
             HCE_MIN_METHOD_BODY("block","executing on current thread");
@@ -506,18 +1525,48 @@ private:
 
     static service* instance_;
 
-    // synchronize checkin/checkout of workers
+    // synchronize the operation queue and worker accounting
     mutable hce::spinlock lk_;
 
-    // count of threads executing blocking operations
-    size_t worker_active_count_; 
+    // idle workers wait on this for wakeups, retirement or shutdown
+    std::condition_variable_any cv_;
 
-    /*
-     Queue of reusable block workers threads. When a blocking operation 
-     finishes, and the thread_local worker cache is full, the worker thread that 
-     executed the operation will be placed in this queue if there is room. 
-     */
-    hce::circular_buffer<std::unique_ptr<worker>> worker_cache_;
+    // false when the service is shutting down
+    bool running_;
+
+    // count of idle workers which persist between blocking calls
+    const size_t worker_cache_size_;
+
+    // maximum count of workers
+    size_t worker_limit_;
+
+    // how long idle workers beyond the cache size persist
+    hce::chrono::duration worker_keepalive_;
+
+    // count of live workers, including spawning workers
+    size_t worker_count_; 
+
+    // count of workers waiting for operations
+    size_t idle_;
+
+    // count of waiting workers which have been handed an operation
+    size_t wakeups_;
+
+    // count of waiting workers which have been told to exit
+    size_t retiring_;
+
+    // worker reuse statistics
+    counters counters_;
+
+    // Blocking operation queue shared by all workers. Operations are owned by 
+    // their awaitables, which are allocated by the calling coroutine's thread.
+    detail::operation_queue operations_;
+
+    // workers which have exited and need to be joined
+    hce::list<worker*> exited_;
+
+    // scheduler thread worker caches with a non-zero limit
+    std::vector<std::shared_ptr<local_cache>> local_caches_;
 
     friend hce::lifecycle;
 };
@@ -539,6 +1588,38 @@ block(Callable&& cb, Args&&... args) {
         std::forward<Args>(args)...);
 }
 
+/**
+ @brief call a Callable on a thread that is not running a coroutine, limited by a lane
+ @param l a lane limiting the concurrency of its blocking calls
+ @param cb a Callable function, function pointer, Functor or lambda
+ @param as arguments for the callable
+ @return an awaitable for the result of the callable
+ */
+template <typename Callable, typename... Args>
+inline hce::awt<hce::function_return_type<Callable,Args...>> 
+block(hce::blocking::lane l, Callable&& cb, Args&&... args) {
+    HCE_MED_FUNCTION_ENTER("hce::block",l);
+    return blocking::service::get().block(
+        std::move(l),
+        std::forward<Callable>(cb),
+        std::forward<Args>(args)...);
+}
+
+/**
+ @brief call a Callable on threads that are not running a coroutine for every element of a range
+ @param r a range of elements 
+ @param cb a Callable accepting an element of the range
+ @return an awaitable for a vector of the results of the callable
+ */
+template <typename Range, typename Callable>
+inline hce::awt<typename blocking::detail::batch_traits<Range,Callable>::type> 
+block_all(Range&& r, Callable&& cb) {
+    HCE_MED_FUNCTION_ENTER("hce::block_all");
+    return blocking::service::get().block_all(
+        std::forward<Range>(r),
+        std::forward<Callable>(cb));
+}
+
 }
 
 #endif
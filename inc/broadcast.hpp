@@ -0,0 +1,509 @@
+//SPDX-License-Identifier: MIT
+//Author: Blayne Dennis
+#ifndef HERMES_COROUTINE_ENGINE_BROADCAST
+#define HERMES_COROUTINE_ENGINE_BROADCAST
+
+// c++
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+
+// local
+#include "utility.hpp"
+#include "logging.hpp"
+#include "atomic.hpp"
+#include "alloc.hpp"
+#include "list.hpp"
+#include "coroutine.hpp"
+#include "scheduler.hpp"
+#include "channel.hpp"
+
+namespace hce {
+
+/**
+ @brief communication object which publishes each sent value to every subscriber
+
+ A broadcast stores published values once, in a ring shared by all of its
+ subscribers, and each subscriber reads the ring from its own position:
+ ```
+ auto b = hce::broadcast<int>::make(64);
+ auto sub1 = b.subscribe();
+ auto sub2 = b.subscribe();
+
+ co_await b.send(3);
+
+ int i;
+ co_await sub1.recv(i); // i == 3
+
+ std::shared_ptr<const int> p;
+ co_await sub2.recv(p); // *p == 3, without copying the value
+ ```
+
+ A subscriber receives the values sent after it subscribed. Values are stored
+ as `std::shared_ptr<const T>`, so receiving a shared pointer never copies the
+ value, and received pointers remain valid after the ring overwrites them.
+
+ When the slowest subscriber has not received the oldest of `capacity`
+ values in the ring, the `overflow` policy of the broadcast decides what a
+ send does:
+ - `block`: the send waits until the slowest subscriber receives a value
+ - `lag`: the slowest subscribers skip their oldest value, which is counted by
+   their `lagged()`
+ - `drop`: the slowest subscribers are unsubscribed, and their receives fail
+
+ Like `hce::chan<T>`, copies of a broadcast or a subscriber share the same
+ context. A subscriber is unsubscribed when its last copy is destroyed.
+ */
+template <typename T, typename LOCK=hce::spinlock>
+struct broadcast : public printable {
+    typedef T value_type;
+
+    /// what a send does when the slowest subscriber is a full ring behind
+    enum class overflow {
+        block, /// wait for the slowest subscriber
+        lag, /// skip the oldest value of the slowest subscribers
+        drop /// unsubscribe the slowest subscribers
+    };
+
+private:
+    struct context;
+    struct subscription;
+
+public:
+    /// a subscription to the values of a broadcast
+    struct subscriber : public printable {
+        subscriber() = default;
+        subscriber(const subscriber&) = default;
+        subscriber(subscriber&&) = default;
+
+        inline virtual ~subscriber(){ }
+
+        subscriber& operator=(const subscriber&) = default;
+        subscriber& operator=(subscriber&&) = default;
+
+        static inline std::string info_name() {
+            return broadcast<T,LOCK>::info_name() + "::subscriber";
+        }
+
+        inline std::string name() const { return subscriber::info_name(); }
+
+        inline std::string content() const {
+            std::stringstream ss;
+            ss << subscription_.get();
+            return ss.str();
+        }
+
+        /// return whether the subscriber has an allocated subscription
+        inline explicit operator bool() const {
+            return (bool)(subscription_);
+        }
+
+        /// return the count of values which are available to receive
+        inline size_t used() const {
+            HCE_MIN_METHOD_ENTER("used");
+            auto& ctx = *(subscription_->ctx);
+            std::lock_guard<LOCK> lk(ctx.lk);
+            return subscription_->dropped ? 0 : ctx.head - subscription_->cursor;
+        }
+
+        /// return the count of values skipped because of the `lag` policy
+        inline size_t lagged() const {
+            HCE_MIN_METHOD_ENTER("lagged");
+            std::lock_guard<LOCK> lk(subscription_->ctx->lk);
+            return subscription_->lagged;
+        }
+
+        /// return true if unsubscribed because of the `drop` policy
+        inline bool dropped() const {
+            HCE_MIN_METHOD_ENTER("dropped");
+            std::lock_guard<LOCK> lk(subscription_->ctx->lk);
+            return subscription_->dropped;
+        }
+
+        /**
+         @brief receive a copy of the next value
+
+         The awaitable returns true on success, else false if the broadcast
+         is closed and the subscriber has received every value, or if the
+         subscriber was dropped.
+         */
+        inline hce::awt<bool> recv(T& t) {
+            HCE_MIN_METHOD_ENTER("recv",(void*)&t);
+            return hce::awt<bool>(new recv_interface(
+                *subscription_,
+                &broadcast<T,LOCK>::copy_value_,
+                (void*)&t));
+        }
+
+        /// receive the next value without copying it
+        inline hce::awt<bool> recv(std::shared_ptr<const T>& p) {
+            HCE_MIN_METHOD_ENTER("recv",(void*)&p);
+            return hce::awt<bool>(new recv_interface(
+                *subscription_,
+                &channel::detail::pointer_send<const std::shared_ptr<const T>&>,
+                (void*)&p));
+        }
+
+    private:
+        subscriber(std::shared_ptr<subscription> s) :
+            subscription_(std::move(s))
+        { }
+
+        std::shared_ptr<subscription> subscription_;
+        friend struct broadcast<T,LOCK>;
+    };
+
+    broadcast() = default;
+    broadcast(const broadcast<T,LOCK>&) = default;
+    broadcast(broadcast<T,LOCK>&&) = default;
+
+    inline virtual ~broadcast(){ }
+
+    broadcast<T,LOCK>& operator=(const broadcast<T,LOCK>&) = default;
+    broadcast<T,LOCK>& operator=(broadcast<T,LOCK>&&) = default;
+
+    static inline std::string info_name() {
+        return type::templatize<T,LOCK>("hce::broadcast");
+    }
+
+    inline std::string name() const { return broadcast<T,LOCK>::info_name(); }
+
+    inline std::string content() const {
+        std::stringstream ss;
+        ss << context_.get();
+        return ss.str();
+    }
+
+    /// return whether the broadcast has an allocated context
+    inline explicit operator bool() const { return (bool)(context_); }
+
+    /**
+     @brief construct the broadcast's context
+     @param capacity the count of values the slowest subscriber can fall behind
+     @param o the overflow policy
+     */
+    inline broadcast<T,LOCK>& construct(
+            size_t capacity,
+            overflow o=overflow::block) {
+        HCE_MIN_METHOD_ENTER("construct",capacity);
+        context_ = std::make_shared<context>(capacity, o);
+        return *this;
+    }
+
+    /**
+     @brief inline construct a new broadcast and its context
+     @return the constructed broadcast
+     */
+    static inline broadcast<T,LOCK> make(
+            size_t capacity,
+            overflow o=overflow::block) {
+        HCE_MIN_FUNCTION_ENTER(broadcast<T,LOCK>::info_name() + "::make",capacity);
+        broadcast<T,LOCK> b;
+        b.construct(capacity, o);
+        return b;
+    }
+
+    /// return the count of values the slowest subscriber can fall behind
+    inline size_t size() const {
+        HCE_MIN_METHOD_ENTER("size");
+        return context_->capacity;
+    }
+
+    /// return the count of subscribers
+    inline size_t subscribers() const {
+        HCE_MIN_METHOD_ENTER("subscribers");
+        std::lock_guard<LOCK> lk(context_->lk);
+        return context_->subscriptions.size();
+    }
+
+    /// return true if the broadcast is closed, else false
+    inline bool closed() const {
+        HCE_MIN_METHOD_ENTER("closed");
+        std::lock_guard<LOCK> lk(context_->lk);
+        return context_->closed_flag;
+    }
+
+    /**
+     @brief close the broadcast
+
+     Parked sends fail. Subscribers can still receive the values they have
+     not received, after which their receives fail.
+     */
+    inline void close() {
+        HCE_MIN_METHOD_ENTER("close");
+        auto& ctx = *context_;
+        std::lock_guard<LOCK> lk(ctx.lk);
+
+        if(!ctx.closed_flag) [[likely]] {
+            ctx.closed_flag = true;
+
+            while(channel::detail::claim_front(ctx.parked_send)) {
+                ctx.parked_send.front()->resume(nullptr);
+                ctx.parked_send.pop();
+            }
+
+            for(auto s : ctx.subscriptions) {
+                while(channel::detail::claim_front(s->parked_recv)) {
+                    s->parked_recv.front()->resume(nullptr);
+                    s->parked_recv.pop();
+                }
+            }
+        }
+    }
+
+    /**
+     @brief subscribe to values sent after this call
+     @return a new subscriber
+     */
+    inline subscriber subscribe() {
+        HCE_MIN_METHOD_ENTER("subscribe");
+        auto s = std::make_shared<subscription>(context_);
+        auto& ctx = *context_;
+        std::lock_guard<LOCK> lk(ctx.lk);
+        s->cursor = ctx.head;
+        ctx.subscriptions.push_back(s.get());
+        return subscriber(std::move(s));
+    }
+
+    /// publish a copy of a lvalue, awaitable returning true on success, else false
+    inline hce::awt<bool> send(const T& t) {
+        HCE_MIN_METHOD_ENTER("send");
+        return send(std::make_shared<const T>(t));
+    }
+
+    /// publish a rvalue, awaitable returning true on success, else false
+    inline hce::awt<bool> send(T&& t) {
+        HCE_MIN_METHOD_ENTER("send");
+        return send(std::make_shared<const T>(std::move(t)));
+    }
+
+    /// publish a shared value without copying it
+    inline hce::awt<bool> send(std::shared_ptr<const T> p) {
+        HCE_MIN_METHOD_ENTER("send");
+        return hce::awt<bool>(new send_interface(*context_, std::move(p)));
+    }
+
+private:
+    typedef hce::list<channel::detail::parked<hce::awaitable::interface>> PARKED;
+    typedef std::shared_ptr<const T> slot;
+
+    struct context {
+        context(size_t c, overflow o) :
+            capacity(c ? c : 1),
+            policy(o),
+            mask(channel::detail::ring_size(capacity) - 1),
+            ring(new slot[mask + 1])
+        { }
+
+        // return true if the slowest subscriber is a full ring behind
+        inline bool full() const {
+            for(auto s : subscriptions) {
+                if(head - s->cursor >= capacity) { return true; }
+            }
+
+            return false;
+        }
+
+        // make room in the ring according to the overflow policy
+        inline void make_room() {
+            const size_t oldest = head - capacity + 1;
+
+            if(policy == overflow::lag) {
+                for(auto s : subscriptions) {
+                    if(s->cursor < oldest) {
+                        s->lagged += oldest - s->cursor;
+                        s->cursor = oldest;
+                    }
+                }
+            } else {
+                auto it = std::remove_if(
+                    subscriptions.begin(),
+                    subscriptions.end(),
+                    [&](subscription* s) {
+                        if(s->cursor < oldest) {
+                            s->dropped = true;
+                            return true;
+                        } else {
+                            return false;
+                        }
+                    });
+
+                subscriptions.erase(it, subscriptions.end());
+            }
+        }
+
+        // store the value of a send at the head of the ring
+        inline void publish(channel::detail::transfer& tx) {
+            tx.send(&(ring[head & mask]));
+            ++head;
+
+            for(auto s : subscriptions) { resume_recv(*s); }
+        }
+
+        // resume parked receivers of a subscription while it has values
+        inline void resume_recv(subscription& s) {
+            while(s.cursor < head && channel::detail::claim_front(s.parked_recv)) {
+                s.parked_recv.front()->resume((void*)&(ring[s.cursor & mask]));
+                s.parked_recv.pop();
+                ++s.cursor;
+            }
+        }
+
+        // publish parked sends while the ring has room
+        inline void resume_send() {
+            while(!full() && channel::detail::claim_front(parked_send)) {
+                parked_send.front()->resume((void*)&(ring[head & mask]));
+                parked_send.pop();
+                ++head;
+
+                for(auto s : subscriptions) { resume_recv(*s); }
+            }
+        }
+
+        mutable LOCK lk;
+        const size_t capacity;
+        const overflow policy;
+        const size_t mask;
+        std::unique_ptr<slot[]> ring;
+        size_t head = 0; // sequence of the next published value
+        bool closed_flag = false;
+        std::vector<subscription*> subscriptions;
+        PARKED parked_send;
+    };
+
+    struct subscription {
+        subscription(std::shared_ptr<context> c) : ctx(std::move(c)) { }
+
+        ~subscription() {
+            std::lock_guard<LOCK> lk(ctx->lk);
+            auto& subs = ctx->subscriptions;
+            auto it = std::find(subs.begin(), subs.end(), this);
+
+            if(it != subs.end()) [[likely]] {
+                subs.erase(it);
+                ctx->resume_send();
+            }
+        }
+
+        std::shared_ptr<context> ctx;
+        size_t cursor = 0; // sequence of the next value to receive
+        size_t lagged = 0;
+        bool dropped = false;
+        PARKED parked_recv;
+    };
+
+    struct send_interface : public channel::detail::base_send_interface<LOCK> {
+        send_interface(context& c, slot p) :
+            channel::detail::base_send_interface<LOCK>(
+                c.lk,
+                channel::detail::transfer(
+                    &channel::detail::pointer_send<slot&&>,
+                    &value_)),
+            ctx_(c),
+            value_(std::move(p))
+        { }
+
+        static inline std::string info_name() {
+            return broadcast<T,LOCK>::info_name() + "::send_interface";
+        };
+
+        inline std::string name() const { return send_interface::info_name(); }
+
+        inline bool on_ready() {
+            if(ctx_.closed_flag) [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("send","closed");
+                return true;
+            } else if(ctx_.subscriptions.empty()) [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("send","no subscribers");
+                this->success = true;
+                return true;
+            } else if(ctx_.full()) [[unlikely]] {
+                if(ctx_.policy == overflow::block) {
+                    HCE_TRACE_METHOD_BODY("send","blocked");
+                    ctx_.parked_send.push_back(this);
+                    return false;
+                } else {
+                    HCE_TRACE_METHOD_BODY("send","overflow");
+                    ctx_.make_room();
+                }
+            }
+
+            HCE_TRACE_METHOD_BODY("send","done");
+            ctx_.publish(this->tx);
+            this->success = true;
+            return true;
+        }
+
+    private:
+        context& ctx_;
+        slot value_;
+    };
+
+    struct recv_interface : public channel::detail::base_recv_interface<LOCK> {
+        recv_interface(
+                subscription& s,
+                void (*op)(void*,void*),
+                void* destination) :
+            channel::detail::base_recv_interface<LOCK>(s.ctx->lk, destination),
+            sub_(s),
+            op_(op)
+        { }
+
+        static inline std::string info_name() {
+            return broadcast<T,LOCK>::info_name() + "::recv_interface";
+        };
+
+        inline std::string name() const { return recv_interface::info_name(); }
+
+        inline bool on_ready() {
+            auto& ctx = *(sub_.ctx);
+
+            if(sub_.dropped) [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("recv","dropped");
+                return true;
+            } else if(sub_.cursor < ctx.head) [[likely]] {
+                HCE_TRACE_METHOD_BODY("recv","done");
+                op_(this->destination, &(ctx.ring[sub_.cursor & ctx.mask]));
+                ++sub_.cursor;
+                this->success = true;
+                ctx.resume_send();
+                return true;
+            } else if(ctx.closed_flag) [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("recv","closed");
+                return true;
+            } else [[likely]] {
+                HCE_TRACE_METHOD_BODY("recv","blocked");
+                sub_.parked_recv.push_back(this);
+                return false;
+            }
+        }
+
+        // m is the ring slot of the received value
+        inline void on_resume(void* m) {
+            HCE_TRACE_METHOD_BODY("on_resume",m);
+
+            if(m) [[likely]] {
+                op_(this->destination, m);
+                this->success = true;
+            }
+        }
+
+    private:
+        subscription& sub_;
+        void (*op_)(void*,void*);
+    };
+
+    // copy a published value into a T
+    static inline void copy_value_(void* destination, void* source) {
+        *((T*)destination) = **((slot*)source);
+    }
+
+    std::shared_ptr<context> context_;
+};
+
+}
+
+#endif
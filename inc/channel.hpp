@@ -5,7 +5,11 @@
 
 // c++
 #include <typeinfo>
+#include <cstdint>
+#include <algorithm>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 // local
 #include "utility.hpp"
@@ -15,8 +19,11 @@
 #include "alloc.hpp"
 #include "circular_buffer.hpp"
 #include "list.hpp"
+#include "segmented_queue.hpp"
+#include "chrono.hpp"
 #include "coroutine.hpp"
 #include "scheduler.hpp"
+#include "timer.hpp"
 
 namespace hce {
 namespace channel {
@@ -28,6 +35,78 @@ enum result {
     success /// channel operation success
 };
 
+namespace detail {
+
+struct selector;
+struct select_case;
+
+/*
+ Type erased range of values which are moved by `interface<T>::send_n()`, 
+ front to back.
+ */
+template <typename T>
+struct source {
+    virtual ~source(){}
+
+    /// return true if no values remain
+    virtual bool empty() const = 0;
+
+    /// return the next value
+    virtual T& front() = 0;
+
+    /// advance to the next value
+    virtual void pop() = 0;
+};
+
+template <typename T, typename IT>
+struct iterator_source : public source<T> {
+    iterator_source(IT first, IT last) : 
+        first_(std::move(first)), 
+        last_(std::move(last)) 
+    { }
+
+    inline bool empty() const { return first_ == last_; }
+    inline T& front() { return *first_; }
+    inline void pop() { ++first_; }
+
+private:
+    IT first_;
+    IT last_;
+};
+
+/*
+ Type erased range of values which are assigned by `interface<T>::recv_n()`.
+ */
+template <typename T>
+struct sink {
+    virtual ~sink(){}
+
+    /// return true if no more values can be assigned
+    virtual bool full() const = 0;
+
+    /// assign the next value
+    virtual void push(T&& t) = 0;
+};
+
+template <typename T, typename IT>
+struct iterator_sink : public sink<T> {
+    iterator_sink(IT out, size_t max) : out_(std::move(out)), remaining_(max) { }
+
+    inline bool full() const { return remaining_ == 0; }
+
+    inline void push(T&& t) { 
+        *out_ = std::move(t); 
+        ++out_;
+        --remaining_;
+    }
+
+private:
+    IT out_;
+    size_t remaining_;
+};
+
+}
+
 /**
  @brief interface for coroutine-safe channel implementations
  */
@@ -66,6 +145,53 @@ struct interface : public printable {
     /// receive a value, awaitable returning true on success, else false
     virtual hce::awt<bool> recv(T& t) = 0;
 
+    /**
+     @brief send a lvalue copy, giving up if the timeout is reached first
+
+     The awaitable returns true on success, else false if the channel was 
+     closed or the timeout was reached before the value could be sent.
+     */
+    virtual hce::awt<bool> send(
+        const T& t, 
+        const hce::chrono::time_point& timeout) = 0;
+
+    /**
+     @brief send a rvalue copy, giving up if the timeout is reached first
+
+     The awaitable returns true on success, else false if the channel was 
+     closed or the timeout was reached before the value could be sent.
+     */
+    virtual hce::awt<bool> send(
+        T&& t, 
+        const hce::chrono::time_point& timeout) = 0;
+
+    /**
+     @brief receive a value, giving up if the timeout is reached first
+
+     The awaitable returns true on success, else false if the channel was 
+     closed or the timeout was reached before a value could be received.
+     */
+    virtual hce::awt<bool> recv(
+        T& t, 
+        const hce::chrono::time_point& timeout) = 0;
+
+    /// send a lvalue copy, giving up if the duration elapses first
+    inline hce::awt<bool> send(
+            const T& t, 
+            const hce::chrono::duration& dur) {
+        return send(t, hce::chrono::now() + dur);
+    }
+
+    /// send a rvalue copy, giving up if the duration elapses first
+    inline hce::awt<bool> send(T&& t, const hce::chrono::duration& dur) {
+        return send(std::move(t), hce::chrono::now() + dur);
+    }
+
+    /// receive a value, giving up if the duration elapses first
+    inline hce::awt<bool> recv(T& t, const hce::chrono::duration& dur) {
+        return recv(t, hce::chrono::now() + dur);
+    }
+
     /// attempt to send a lvalue copy
     virtual hce::yield<channel::result> try_send(const T& t) = 0;
 
@@ -74,6 +200,85 @@ struct interface : public printable {
 
     /// attempt receive a value
     virtual hce::yield<channel::result> try_recv(T& t) = 0;
+
+    /**
+     @brief move as many values from a range as the channel can accept at once
+
+     The operation waits until at least one value can be sent. Only parked 
+     operations which are completed by the sent values are resumed.
+
+     The awaitable returns the count of values sent, which is 0 if the channel 
+     is closed or the range is empty.
+     */
+    virtual hce::awt<size_t> send_n(std::unique_ptr<detail::source<T>> s) = 0;
+
+    /**
+     @brief receive as many values as are available at once
+
+     The operation waits until at least one value can be received. Only parked 
+     operations which are completed by the received values are resumed.
+
+     The awaitable returns the count of values received, which is 0 if the 
+     channel is closed (and, if buffered, empty) or the range is full.
+     */
+    virtual hce::awt<size_t> recv_n(std::unique_ptr<detail::sink<T>> s) = 0;
+
+    /**
+     @brief construct a send of a lvalue copy as a case of an `hce::select`
+
+     This is called by `hce::select`, and is not intended to be called 
+     directly.
+     */
+    virtual std::unique_ptr<detail::select_case> select_send(
+        const T& t, 
+        detail::selector& sel, 
+        size_t index) = 0;
+
+    /// construct a send of a rvalue copy as a case of an `hce::select`
+    virtual std::unique_ptr<detail::select_case> select_send(
+        T&& t, 
+        detail::selector& sel, 
+        size_t index) = 0;
+
+    /// construct a receive as a case of an `hce::select`
+    virtual std::unique_ptr<detail::select_case> select_recv(
+        T& t, 
+        detail::selector& sel, 
+        size_t index) = 0;
+
+    /**
+     @brief move as many values from [first,last) as the channel can accept at once
+
+     The values must remain valid until the awaitable completes. Values which 
+     are not sent are left in the range.
+
+     @param first iterator to the first value
+     @param last iterator past the last value
+     @return an awaitable returning the count of values sent
+     */
+    template <typename IT>
+    inline hce::awt<size_t> send_n(IT first, IT last) {
+        return send_n(std::unique_ptr<detail::source<T>>(
+            new detail::iterator_source<T,IT>(
+                std::move(first), 
+                std::move(last))));
+    }
+
+    /**
+     @brief receive up to max values at once
+
+     The output must remain valid until the awaitable completes. `T` must be 
+     default constructible.
+
+     @param out output iterator the values are assigned to
+     @param max the maximum count of values to receive
+     @return an awaitable returning the count of values received
+     */
+    template <typename IT>
+    inline hce::awt<size_t> recv_n(IT out, size_t max) {
+        return recv_n(std::unique_ptr<detail::sink<T>>(
+            new detail::iterator_sink<T,IT>(std::move(out), max)));
+    }
 };
 
 namespace detail {
@@ -159,12 +364,322 @@ private:
     void* source_;
 };
 
+/*
+ Claim shared by the cases of an `hce::select`, whose operations are parked on 
+ several channels at once. A case must claim its select before it completes, 
+ and only the first claim succeeds. Cases which lose are dropped from their 
+ parked lists by whichever operation encounters them next, or removed by the 
+ select when it completes.
+
+ A claim can be held tentatively (`busy`) while its holder attempts an 
+ operation which can fail, such as popping from a lockfree ring. A holder 
+ never acquires a lock while its claim is busy, and when 2 selects are claimed 
+ together they are claimed in address order, so spinning on a busy claim 
+ always terminates.
+ */
+struct selector {
+    enum state {
+        waiting = 0, //< the select is suspended, or about to suspend
+        registering = 1, //< the select is parking its cases
+        busy = 2, //< a claim is being attempted
+        done = 4 //< the select has been claimed
+    };
+
+    /// the awaitable resumed when a case completes after the select suspends
+    inline void owner(hce::awaitable::interface* o) { owner_ = o; }
+
+    /// begin parking cases
+    inline void start() {
+        completed_.store(false, std::memory_order_relaxed);
+        state_.store(registering, std::memory_order_release);
+    }
+
+    /// return true if the select has been claimed
+    inline bool claimed() const { 
+        return state_.load(std::memory_order_acquire) & done; 
+    }
+
+    /// tentatively claim the select, returning false if it was already claimed
+    inline bool acquire() {
+        int s = state_.load(std::memory_order_relaxed);
+
+        while(true) {
+            if(s & done) [[unlikely]] { 
+                return false; 
+            } else if(s & busy) [[unlikely]] { 
+                s = state_.load(std::memory_order_relaxed); 
+            } else if(state_.compare_exchange_weak(
+                        s, 
+                        s | busy, 
+                        std::memory_order_acquire, 
+                        std::memory_order_relaxed)) [[likely]] {
+                return true;
+            }
+        }
+    }
+
+    /// complete a tentative claim
+    inline void commit() {
+        const int s = state_.load(std::memory_order_relaxed);
+        state_.store((s & registering) | done, std::memory_order_release);
+    }
+
+    /// give up a tentative claim
+    inline void release() {
+        const int s = state_.load(std::memory_order_relaxed);
+        state_.store(s & registering, std::memory_order_release);
+    }
+
+    /// claim the select, returning false if it was already claimed
+    inline bool claim() {
+        if(acquire()) [[likely]] {
+            commit();
+            return true;
+        } else [[unlikely]] { return false; }
+    }
+
+    /**
+     Finish parking cases. Returns true if the select must suspend, else false 
+     if a case was claimed while the cases were being parked.
+     */
+    inline bool park() {
+        int s = registering;
+
+        while(!state_.compare_exchange_weak(
+                s, 
+                waiting, 
+                std::memory_order_acq_rel, 
+                std::memory_order_acquire)) 
+        {
+            if(s & done) [[unlikely]] { return false; }
+            s = registering;
+        }
+
+        return true;
+    }
+
+    /**
+     Called by the claimer when the claimed case is complete. If the select 
+     has suspended its owner is resumed, otherwise the select is still parking 
+     its cases and will observe the completion itself.
+     */
+    inline void notify(size_t index) {
+        winner_ = index;
+
+        if(state_.load(std::memory_order_relaxed) & registering) [[unlikely]] {
+            completed_.store(true, std::memory_order_release);
+        } else [[likely]] {
+            owner_->resume(nullptr);
+        }
+    }
+
+    /// wait for a case claimed while parking cases to complete
+    inline void wait() const {
+        while(!completed_.load(std::memory_order_acquire)) { }
+    }
+
+    /// return the index of the completed case
+    inline size_t winner() const { return winner_; }
+
+private:
+    std::atomic<int> state_{waiting};
+    std::atomic<bool> completed_{false};
+    hce::awaitable::interface* owner_ = nullptr;
+    size_t winner_ = 0;
+};
+
+/// result of claiming a parked operation
+enum claim_result {
+    claimed, /// the parked operation can be completed
+    stale, /// the parked operation's select was already claimed
+    lost /// the claiming operation's select was already claimed
+};
+
+/*
+ A parked operation, which is a case of an `hce::select` if `sel` is not null. 
+ Parked lists compare and dereference entries as their operation pointer.
+ */
+template <typename OP>
+struct parked {
+    parked(OP* o, selector* s=nullptr) : op(o), sel(s) { }
+
+    inline OP* operator->() const { return op; }
+    inline bool operator==(const parked<OP>& rhs) const { return op == rhs.op; }
+
+    /**
+     Claim the parked operation so that it can be completed, on behalf of an 
+     operation which is a case of select `self` if it is not null.
+     */
+    inline claim_result claim(selector* self=nullptr) {
+        if(!sel) [[likely]] {
+            if(!self || self->claim()) [[likely]] { return claimed; }
+            else [[unlikely]] { return lost; }
+        } else if(!self) [[likely]] {
+            return sel->claim() ? claimed : stale;
+        } else [[unlikely]] {
+            // both are selects, claim them in address order
+            const bool self_first = self < sel;
+            selector* first = self_first ? self : sel;
+            selector* second = self_first ? sel : self;
+
+            if(!first->acquire()) { return self_first ? lost : stale; }
+
+            if(!second->acquire()) { 
+                first->release();
+                return self_first ? stale : lost; 
+            }
+
+            first->commit();
+            second->commit();
+            return claimed;
+        }
+    }
+
+    /// tentatively claim the parked operation, see `selector::acquire()`
+    inline bool acquire() { return !sel || sel->acquire(); }
+
+    /// complete a tentative claim
+    inline void commit() { if(sel) [[unlikely]] { sel->commit(); } }
+
+    /// give up a tentative claim
+    inline void release() { if(sel) [[unlikely]] { sel->release(); } }
+
+    OP* op;
+    selector* sel;
+};
+
+/*
+ Claim the first parked operation which can be completed, on behalf of an 
+ operation which is a case of select `self` if it is not null. Operations of 
+ claimed selects are dropped. Operations of select `self` are moved to the back 
+ of the list, because a select cannot complete with itself.
+
+ Returns true if the front of the list was claimed, else false if nothing 
+ could be claimed or select `self` was already claimed.
+ */
+template <typename LIST>
+inline bool claim_front(LIST& parked, selector* self=nullptr) {
+    size_t own = 0;
+
+    while(parked.size() > own) {
+        auto p = parked.front();
+
+        if(self && p.sel == self) [[unlikely]] {
+            parked.pop();
+            parked.push_back(p);
+            ++own;
+            continue;
+        }
+
+        switch(p.claim(self)) {
+            case claimed:
+                return true;
+            case stale:
+                parked.pop();
+                break;
+            case lost:
+                return false;
+        }
+    }
+
+    return false;
+}
+
+/*
+ Partial implementation of a channel operation which can be a case of an 
+ `hce::select`, in which case it must claim the select before it completes.
+ */
+struct selectable {
+    /// claim the select, if any, returning false if it was already claimed
+    inline bool claim() { return !sel || sel->claim(); }
+
+    /// attempt an operation which can fail, only claiming the select if it succeeds
+    template <typename F>
+    inline bool attempt(F&& f) {
+        if(!sel) [[likely]] { 
+            return f(); 
+        } else if(!sel->acquire()) [[unlikely]] { 
+            return false; 
+        } else if(f()) {
+            sel->commit();
+            return true;
+        } else {
+            sel->release();
+            return false;
+        }
+    }
+
+    /// the operation completed, notify the select, if any
+    inline void notify() { if(sel) [[unlikely]] { sel->notify(index); } }
+
+    /// the operation failed because the channel is closed
+    inline void fail() { if(claim()) [[likely]] { notify(); } }
+
+    selector* sel = nullptr;
+    size_t index = 0;
+};
+
+/*
+ Type erased case of an `hce::select`, constructed by a channel.
+ */
+struct select_case {
+    virtual ~select_case(){}
+
+    /// attempt the operation, parking it if it cannot complete immediately
+    virtual void ready() = 0;
+
+    /// remove the operation from its channel if it is still parked
+    virtual void cancel() = 0;
+
+    /// return true if the operation completed successfully
+    virtual bool succeeded() = 0;
+};
+
+/*
+ Implementation of a select case for an INTERFACE which derives `selectable`, 
+ and which parks itself on a LIST guarded by LOCK.
+ */
+template <typename LOCK, typename LIST, typename INTERFACE>
+struct selecting : public INTERFACE, public select_case {
+    template <typename... As>
+    selecting(LOCK& lk, 
+              LIST& parked, 
+              selector& s, 
+              size_t index, 
+              As&&... as) :
+        INTERFACE(std::forward<As>(as)...),
+        lk_(lk),
+        parked_(parked)
+    { 
+        this->sel = &s;
+        this->index = index;
+    }
+
+    inline void ready() {
+        this->lock();
+        this->on_ready();
+        this->unlock();
+    }
+
+    inline void cancel() {
+        std::lock_guard<LOCK> lk(lk_);
+        parked_.remove(this);
+    }
+
+    inline bool succeeded() { return this->get_result(); }
+
+private:
+    LOCK& lk_;
+    LIST& parked_;
+};
+
 template <typename LOCK>
 struct base_send_interface : 
     public hce::scheduler::reschedule<
         hce::awaitable::lockable<
             LOCK,
-            awt_interface<bool>>>
+            awt_interface<bool>>>,
+    public selectable
 {
     base_send_interface(LOCK& lk, transfer t) : 
         hce::scheduler::reschedule<
@@ -185,6 +700,8 @@ struct base_send_interface :
             tx.send(m);
             success = true;
         }
+
+        this->notify();
     }
 
     inline bool get_result() { 
@@ -201,7 +718,8 @@ struct base_recv_interface :
     public hce::scheduler::reschedule<
         hce::awaitable::lockable<
             LOCK,
-            awt_interface<bool>>>
+            awt_interface<bool>>>,
+    public selectable
 {
     base_recv_interface(LOCK& lk, void* d) : 
         hce::scheduler::reschedule<
@@ -222,6 +740,8 @@ struct base_recv_interface :
             ((transfer*)m)->send(destination);
             success = true;
         }
+
+        this->notify();
     }
 
     inline bool get_result() { 
@@ -233,6 +753,108 @@ struct base_recv_interface :
     void* destination = nullptr;
 };
 
+// round a ring capacity up to a power of 2 so indices can be masked
+inline size_t ring_size(size_t capacity) {
+    size_t sz = 1;
+    while(sz < capacity) { sz <<= 1; }
+    return sz;
+}
+
+/*
+ Partial implementation of a batch operation, whose awaitable returns the count 
+ of values transferred.
+ */
+template <typename LOCK>
+struct base_batch_interface : 
+    public hce::scheduler::reschedule<
+        hce::awaitable::lockable<
+            LOCK,
+            awt_interface<size_t>>>
+{
+    base_batch_interface(LOCK& lk) : 
+        hce::scheduler::reschedule<
+            hce::awaitable::lockable<
+                LOCK,
+                awt_interface<size_t>>>(
+                    lk,
+                    hce::awaitable::await::policy::defer,
+                    hce::awaitable::resume::policy::no_lock)
+    { }
+
+    inline size_t get_result() { 
+        HCE_MIN_METHOD_BODY("get_result",count);
+        return count; 
+    }
+
+    size_t count = 0;
+};
+
+/*
+ Partial implementation of a channel operation which races against a timeout.
+
+ INTERFACE is a channel send or receive implementation which pushes itself 
+ onto a parked list when it cannot complete immediately. When that happens a 
+ timer is started whose handler removes the operation from the parked list 
+ and resumes it with a failure result. 
+
+ Whichever side loses the race is cancelled cleanly. The timeout handler does 
+ nothing if the operation is no longer parked, and the destructor cancels the 
+ timer (timer::service::cancel() will not return while the handler is 
+ executing, so the handler never observes a destroyed operation).
+ */
+template <typename LOCK, typename LIST, typename INTERFACE>
+struct deadline : public INTERFACE {
+    template <typename... As>
+    deadline(LOCK& lk, 
+             LIST& parked, 
+             const hce::chrono::time_point& timeout, 
+             As&&... as) : 
+        INTERFACE(std::forward<As>(as)...),
+        lk_(lk),
+        parked_(parked),
+        timeout_(timeout)
+    { }
+
+    virtual ~deadline() {
+        if(sid_) [[unlikely]] { hce::timer::service::get().cancel(sid_); }
+    }
+
+    inline bool on_ready() {
+        if(INTERFACE::on_ready()) [[likely]] {
+            return true;
+        } else [[unlikely]] {
+            HCE_TRACE_METHOD_BODY("on_ready","parked until ",timeout_);
+            hce::timer::service::get().start(
+                sid_, 
+                timeout_, 
+                &deadline<LOCK,LIST,INTERFACE>::timeout_handler_, 
+                this);
+            return false;
+        }
+    }
+
+private:
+    static inline void timeout_handler_(void* arg, bool timeout) {
+        if(timeout) [[likely]] {
+            auto d = static_cast<deadline<LOCK,LIST,INTERFACE>*>(arg);
+            std::lock_guard<LOCK> lk(d->lk_);
+
+            // only resume the operation if the channel has not already
+            if(d->parked_.remove(d)) [[likely]] { 
+                HCE_TRACE_FUNCTION_BODY(
+                    "hce::channel::detail::deadline::timeout_handler_",
+                    "timed out");
+                d->resume(nullptr); 
+            }
+        }
+    }
+
+    LOCK& lk_;
+    LIST& parked_;
+    const hce::chrono::time_point timeout_;
+    hce::sid sid_;
+};
+
 }
 
 /// unbuffered interface implementation
@@ -240,6 +862,22 @@ template <typename T, typename LOCK=hce::spinlock, typename ALLOCATOR=hce::pool_
 struct unbuffered : public interface<T> {
     typedef T value_type;
 
+    using interface<T>::send;
+    using interface<T>::recv;
+    using interface<T>::send_n;
+    using interface<T>::recv_n;
+
+private:
+    struct send_interface;
+    struct recv_interface;
+
+public:
+    /// awaitable returned by `embedded_send()`
+    typedef hce::awaitable::embedded<send_interface> send_awaitable;
+
+    /// awaitable returned by `embedded_recv()`
+    typedef hce::awaitable::embedded<recv_interface> recv_awaitable;
+
     unbuffered() {
         HCE_LOW_CONSTRUCTOR(); 
     }
@@ -296,12 +934,12 @@ struct unbuffered : public interface<T> {
         if(!closed_flag_) [[likely]] {
             closed_flag_ = true;
 
-            while(parked_send_.size()) { 
+            while(detail::claim_front(parked_send_)) { 
                 parked_send_.front()->resume(nullptr); 
                 parked_send_.pop();
             }
 
-            while(parked_recv_.size()) { 
+            while(detail::claim_front(parked_recv_)) { 
                 parked_recv_.front()->resume(nullptr); 
                 parked_recv_.pop();
             }
@@ -328,6 +966,72 @@ struct unbuffered : public interface<T> {
         return hce::awt<bool>(new recv_interface(*this, (void*)&r));
     }
 
+    /**
+     @brief send a lvalue copy with an awaitable embedded in the caller
+
+     Unlike `send()` the operation is not allocated. It is constructed in place 
+     in the returned awaitable, which must be `co_await`ed (or converted to 
+     `bool` by a thread) where it is returned.
+
+     @param s the value to send
+     @return an awaitable returning true if the value was sent, else false
+     */
+    inline send_awaitable embedded_send(const T& s) {
+        HCE_LOW_METHOD_ENTER("embedded_send",(void*)&s);
+        return send_awaitable(
+            *this,
+            detail::transfer(detail::pointer_send<const T&>,&s));
+    }
+
+    /// send a rvalue copy with an awaitable embedded in the caller
+    inline send_awaitable embedded_send(T&& s) {
+        HCE_LOW_METHOD_ENTER("embedded_send",(void*)&s);
+        return send_awaitable(
+            *this,
+            detail::transfer(detail::pointer_send<T&&>,&s));
+    }
+
+    /// receive a value with an awaitable embedded in the caller
+    inline recv_awaitable embedded_recv(T& r) {
+        HCE_LOW_METHOD_ENTER("embedded_recv",(void*)&r);
+        return recv_awaitable(*this, (void*)&r);
+    }
+
+    inline awt<bool> send(
+            const T& s, 
+            const hce::chrono::time_point& timeout) {
+        HCE_LOW_METHOD_ENTER("send",(void*)&s,timeout);
+
+        return hce::awt<bool>(new timed_send_interface(
+            lk_, 
+            parked_send_, 
+            timeout,
+            *this, 
+            detail::transfer(detail::pointer_send<const T&>,&s)));
+    }
+
+    inline awt<bool> send(T&& s, const hce::chrono::time_point& timeout) {
+        HCE_LOW_METHOD_ENTER("send",(void*)&s,timeout);
+
+        return hce::awt<bool>(new timed_send_interface(
+            lk_, 
+            parked_send_, 
+            timeout,
+            *this, 
+            detail::transfer(detail::pointer_send<T&&>,&s)));
+    }
+
+    inline awt<bool> recv(T& r, const hce::chrono::time_point& timeout) {
+        HCE_LOW_METHOD_ENTER("recv",(void*)&r,timeout);
+
+        return hce::awt<bool>(new timed_recv_interface(
+            lk_, 
+            parked_recv_, 
+            timeout,
+            *this, 
+            (void*)&r));
+    }
+
     inline hce::yield<result> try_send(const T& s) {
         HCE_LOW_METHOD_ENTER("try_send",(void*)&s);
         return try_send_(s);
@@ -345,14 +1049,70 @@ struct unbuffered : public interface<T> {
 
         if(closed_flag_) [[unlikely]] { 
             return { result::closed }; 
-        } else if(parked_send_.size()) [[likely]] {
+        } else if(detail::claim_front(parked_send_)) [[likely]] {
             parked_send_.front()->resume((void*)&r);
+            parked_send_.pop();
 
             // return an awaitable which immediately returns true
             return { result::success }; 
         } else [[unlikely]] { return { result::failure }; }
     }
 
+    inline awt<size_t> send_n(std::unique_ptr<detail::source<T>> s) {
+        HCE_LOW_METHOD_ENTER("send_n");
+        return hce::awt<size_t>(new send_n_interface(*this, std::move(s)));
+    }
+
+    inline awt<size_t> recv_n(std::unique_ptr<detail::sink<T>> s) {
+        HCE_LOW_METHOD_ENTER("recv_n");
+        return hce::awt<size_t>(new recv_n_interface(*this, std::move(s)));
+    }
+
+    inline std::unique_ptr<detail::select_case> select_send(
+            const T& s, 
+            detail::selector& sel, 
+            size_t index) {
+        HCE_LOW_METHOD_ENTER("select_send",(void*)&s,index);
+
+        return std::unique_ptr<detail::select_case>(new select_send_interface(
+            lk_, 
+            parked_send_, 
+            sel,
+            index,
+            *this, 
+            detail::transfer(detail::pointer_send<const T&>,&s)));
+    }
+
+    inline std::unique_ptr<detail::select_case> select_send(
+            T&& s, 
+            detail::selector& sel, 
+            size_t index) {
+        HCE_LOW_METHOD_ENTER("select_send",(void*)&s,index);
+
+        return std::unique_ptr<detail::select_case>(new select_send_interface(
+            lk_, 
+            parked_send_, 
+            sel,
+            index,
+            *this, 
+            detail::transfer(detail::pointer_send<T&&>,&s)));
+    }
+
+    inline std::unique_ptr<detail::select_case> select_recv(
+            T& r, 
+            detail::selector& sel, 
+            size_t index) {
+        HCE_LOW_METHOD_ENTER("select_recv",(void*)&r,index);
+
+        return std::unique_ptr<detail::select_case>(new select_recv_interface(
+            lk_, 
+            parked_recv_, 
+            sel,
+            index,
+            *this, 
+            (void*)&r));
+    }
+
 private:
     typedef unbuffered<T,LOCK,ALLOCATOR> PARENT;
 
@@ -374,16 +1134,18 @@ private:
         inline bool on_ready() {
             if(parent_.closed_flag_) [[unlikely]] {
                 HCE_TRACE_METHOD_BODY("send","closed");
+                this->fail();
                 return true;
-            } else if(parent_.parked_recv_.size()) [[likely]] {
+            } else if(detail::claim_front(parent_.parked_recv_, this->sel)) [[likely]] {
                 HCE_TRACE_METHOD_BODY("send","done");
                 parent_.parked_recv_.front()->resume((void*)&(this->tx));
                 parent_.parked_recv_.pop();
                 this->success = true;
+                this->notify();
                 return true;
             } else [[unlikely]] {
                 HCE_TRACE_METHOD_BODY("send","blocked");
-                parent_.parked_send_.push_back(this);
+                parent_.parked_send_.push_back({ this, this->sel });
                 return false;
             }
         }
@@ -408,23 +1170,142 @@ private:
         inline bool on_ready() {
             if(parent_.closed_flag_) [[unlikely]] { 
                 HCE_TRACE_METHOD_BODY("recv","closed");
+                this->fail();
                 return true;
-            } else if(parent_.parked_send_.size()) [[likely]] {
+            } else if(detail::claim_front(parent_.parked_send_, this->sel)) [[likely]] {
                 HCE_TRACE_METHOD_BODY("recv","resume");
                 parent_.parked_send_.front()->resume(this->destination);
                 parent_.parked_send_.pop();
                 this->success = true;
+                this->notify();
                 return true;
             } else [[unlikely]] {
                 HCE_TRACE_METHOD_BODY("recv","block for transfer");
+                parent_.parked_recv_.push_back({ this, this->sel });
+                return false;
+            }
+        }
+
+    private:
+        PARENT& parent_;
+    };
+
+    struct send_n_interface : public detail::base_batch_interface<LOCK> {
+        send_n_interface(PARENT& p, std::unique_ptr<detail::source<T>> s) :
+            detail::base_batch_interface<LOCK>(p.lk_),
+            parent_(p),
+            source_(std::move(s))
+        { }
+
+        static inline std::string info_name() {
+            return unbuffered<T,LOCK,ALLOCATOR>::info_name() + 
+                   "::send_n_interface";
+        };
+
+        inline std::string name() const { return send_n_interface::info_name(); }
+
+        inline bool on_ready() {
+            if(parent_.closed_flag_ || source_->empty()) [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("send_n","closed or empty");
+                return true;
+            } 
+
+            // each parked receiver takes a single value
+            while(!source_->empty() && detail::claim_front(parent_.parked_recv_)) {
+                detail::transfer tx(detail::pointer_send<T&&>,&(source_->front()));
+                parent_.parked_recv_.front()->resume((void*)&tx);
+                parent_.parked_recv_.pop();
+                source_->pop();
+                ++(this->count);
+            }
+
+            if(this->count) [[likely]] {
+                HCE_TRACE_METHOD_BODY("send_n","done");
+                return true;
+            } else [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("send_n","blocked");
+                parent_.parked_send_.push_back(this);
+                return false;
+            }
+        }
+
+        inline void on_resume(void* m) {
+            HCE_MIN_METHOD_ENTER("on_resume",m);
+
+            if(m) [[likely]] {
+                // m is destination
+                *((T*)m) = std::move(source_->front());
+                source_->pop();
+                this->count = 1;
+            }
+        }
+
+    private:
+        PARENT& parent_;
+        std::unique_ptr<detail::source<T>> source_;
+    };
+
+    struct recv_n_interface : public detail::base_batch_interface<LOCK> {
+        recv_n_interface(PARENT& p, std::unique_ptr<detail::sink<T>> s) :
+            detail::base_batch_interface<LOCK>(p.lk_),
+            parent_(p),
+            sink_(std::move(s))
+        { }
+
+        static inline std::string info_name() {
+            return unbuffered<T,LOCK,ALLOCATOR>::info_name() + 
+                   "::recv_n_interface";
+        };
+
+        inline std::string name() const { return recv_n_interface::info_name(); }
+
+        inline bool on_ready() {
+            if(parent_.closed_flag_ || sink_->full()) [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("recv_n","closed or full");
+                return true;
+            } 
+
+            // each parked sender gives a single value
+            while(!sink_->full() && detail::claim_front(parent_.parked_send_)) {
+                T t;
+                parent_.parked_send_.front()->resume((void*)&t);
+                parent_.parked_send_.pop();
+                sink_->push(std::move(t));
+                ++(this->count);
+            }
+
+            if(this->count) [[likely]] {
+                HCE_TRACE_METHOD_BODY("recv_n","done");
+                return true;
+            } else [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("recv_n","blocked");
                 parent_.parked_recv_.push_back(this);
                 return false;
             }
         }
 
+        inline void on_resume(void* m) {
+            HCE_MIN_METHOD_ENTER("on_resume",m);
+
+            if(m) [[likely]] {
+                // m is transfer struct
+                T t;
+                ((detail::transfer*)m)->send(&t);
+                sink_->push(std::move(t));
+                this->count = 1;
+            }
+        }
+
     private:
         PARENT& parent_;
+        std::unique_ptr<detail::sink<T>> sink_;
     };
+
+    typedef hce::list<detail::parked<hce::awaitable::interface>,ALLOCATOR> PARKED;
+    typedef detail::deadline<LOCK,PARKED,send_interface> timed_send_interface;
+    typedef detail::deadline<LOCK,PARKED,recv_interface> timed_recv_interface;
+    typedef detail::selecting<LOCK,PARKED,send_interface> select_send_interface;
+    typedef detail::selecting<LOCK,PARKED,recv_interface> select_recv_interface;
     
     template <typename U>
     inline hce::yield<result> try_send_(U&& s) {
@@ -433,7 +1314,7 @@ private:
         if(closed_flag_) [[unlikely]] { 
             HCE_TRACE_METHOD_BODY("try_send","closed");
             return { result::closed }; 
-        } else if(parked_recv_.size()) [[likely]] {
+        } else if(detail::claim_front(parked_recv_)) [[likely]] {
             HCE_TRACE_METHOD_BODY("try_send","done");
             detail::transfer tx(detail::pointer_send<U>,&s);
             parked_recv_.front()->resume((void*)(&tx));
@@ -445,8 +1326,8 @@ private:
 
     mutable LOCK lk_;
     bool closed_flag_ = false;
-    hce::list<awt<bool>::interface*,ALLOCATOR> parked_send_;
-    hce::list<awt<bool>::interface*,ALLOCATOR> parked_recv_;
+    PARKED parked_send_;
+    PARKED parked_recv_;
 };
 
 /// buffered interface implementation
@@ -454,6 +1335,22 @@ template <typename T, typename LOCK=hce::spinlock, typename ALLOCATOR=hce::pool_
 struct buffered : public interface<T> {
     typedef T value_type;
 
+    using interface<T>::send;
+    using interface<T>::recv;
+    using interface<T>::send_n;
+    using interface<T>::recv_n;
+
+private:
+    struct send_interface;
+    struct recv_interface;
+
+public:
+    /// awaitable returned by `embedded_send()`
+    typedef hce::awaitable::embedded<send_interface> send_awaitable;
+
+    /// awaitable returned by `embedded_recv()`
+    typedef hce::awaitable::embedded<recv_interface> recv_awaitable;
+
     buffered(int sz) : 
         buf_(sz ? (size_t)sz : (size_t)1),
         parked_send_(),
@@ -520,12 +1417,12 @@ struct buffered : public interface<T> {
         if(!closed_flag_) [[unlikely]] {
             closed_flag_ = true;
 
-            while(parked_send_.size()) { 
+            while(detail::claim_front(parked_send_)) { 
                 parked_send_.front()->resume(nullptr); 
                 parked_send_.pop();
             }
 
-            while(parked_recv_.size()) { 
+            while(detail::claim_front(parked_recv_)) { 
                 parked_recv_.front()->resume(nullptr); 
                 parked_recv_.pop();
             }
@@ -552,6 +1449,63 @@ struct buffered : public interface<T> {
         return hce::awt<bool>(new recv_interface(*this, (void*)&r));
     }
 
+    /// see `unbuffered::embedded_send()`
+    inline send_awaitable embedded_send(const T& s) {
+        HCE_LOW_METHOD_ENTER("embedded_send",(void*)&s);
+        return send_awaitable(
+            *this,
+            detail::transfer(detail::circular_buffer_send<const T&>,(void*)&s));
+    }
+
+    /// see `unbuffered::embedded_send()`
+    inline send_awaitable embedded_send(T&& s) {
+        HCE_LOW_METHOD_ENTER("embedded_send",(void*)&s);
+        return send_awaitable(
+            *this,
+            detail::transfer(detail::circular_buffer_send<T&&>,(void*)&s));
+    }
+
+    /// see `unbuffered::embedded_recv()`
+    inline recv_awaitable embedded_recv(T& r) {
+        HCE_LOW_METHOD_ENTER("embedded_recv",(void*)&r);
+        return recv_awaitable(*this, (void*)&r);
+    }
+
+    inline awt<bool> send(
+            const T& s, 
+            const hce::chrono::time_point& timeout) {
+        HCE_LOW_METHOD_ENTER("send",(void*)&s,timeout);
+
+        return hce::awt<bool>(new timed_send_interface(
+            lk_, 
+            parked_send_, 
+            timeout,
+            *this, 
+            detail::transfer(detail::circular_buffer_send<const T&>,(void*)&s)));
+    }
+
+    inline awt<bool> send(T&& s, const hce::chrono::time_point& timeout) {
+        HCE_LOW_METHOD_ENTER("send",(void*)&s,timeout);
+
+        return hce::awt<bool>(new timed_send_interface(
+            lk_, 
+            parked_send_, 
+            timeout,
+            *this, 
+            detail::transfer(detail::circular_buffer_send<T&&>,(void*)&s)));
+    }
+
+    inline awt<bool> recv(T& r, const hce::chrono::time_point& timeout) {
+        HCE_LOW_METHOD_ENTER("recv",(void*)&r,timeout);
+
+        return hce::awt<bool>(new timed_recv_interface(
+            lk_, 
+            parked_recv_, 
+            timeout,
+            *this, 
+            (void*)&r));
+    }
+
     inline hce::yield<result> try_send(const T& t) {
         HCE_LOW_METHOD_ENTER("try_send",(void*)&t);
         return try_send_(t);
@@ -583,17 +1537,68 @@ struct buffered : public interface<T> {
             HCE_TRACE_METHOD_BODY("try_recv","done");
             r = std::move(buf_.front());
             buf_.pop();
-
-            if(parked_send_.size()) [[unlikely]] {
-                parked_send_.front()->resume((void*)&buf_);
-                parked_send_.pop();
-            }
+            resume_send_();
 
             // return an awaitable which immediately returns true
             return { result::success }; 
         }
     }
 
+    inline awt<size_t> send_n(std::unique_ptr<detail::source<T>> s) {
+        HCE_LOW_METHOD_ENTER("send_n");
+        return hce::awt<size_t>(new send_n_interface(*this, std::move(s)));
+    }
+
+    inline awt<size_t> recv_n(std::unique_ptr<detail::sink<T>> s) {
+        HCE_LOW_METHOD_ENTER("recv_n");
+        return hce::awt<size_t>(new recv_n_interface(*this, std::move(s)));
+    }
+
+    inline std::unique_ptr<detail::select_case> select_send(
+            const T& s, 
+            detail::selector& sel, 
+            size_t index) {
+        HCE_LOW_METHOD_ENTER("select_send",(void*)&s,index);
+
+        return std::unique_ptr<detail::select_case>(new select_send_interface(
+            lk_, 
+            parked_send_, 
+            sel,
+            index,
+            *this, 
+            detail::transfer(detail::circular_buffer_send<const T&>,(void*)&s)));
+    }
+
+    inline std::unique_ptr<detail::select_case> select_send(
+            T&& s, 
+            detail::selector& sel, 
+            size_t index) {
+        HCE_LOW_METHOD_ENTER("select_send",(void*)&s,index);
+
+        return std::unique_ptr<detail::select_case>(new select_send_interface(
+            lk_, 
+            parked_send_, 
+            sel,
+            index,
+            *this, 
+            detail::transfer(detail::circular_buffer_send<T&&>,(void*)&s)));
+    }
+
+    inline std::unique_ptr<detail::select_case> select_recv(
+            T& r, 
+            detail::selector& sel, 
+            size_t index) {
+        HCE_LOW_METHOD_ENTER("select_recv",(void*)&r,index);
+
+        return std::unique_ptr<detail::select_case>(new select_recv_interface(
+            lk_, 
+            parked_recv_, 
+            sel,
+            index,
+            *this, 
+            (void*)&r));
+    }
+
 private:
     typedef buffered<T,LOCK,ALLOCATOR> PARENT;
 
@@ -613,22 +1618,18 @@ private:
         inline bool on_ready() {
             if(parent_.closed_flag_) [[unlikely]] {
                 HCE_TRACE_METHOD_BODY("send","closed");
-                return false;
-            } else if(parent_.buf_.full()) [[unlikely]] {
+                this->fail();
+                return true;
+            } else if(parent_.buf_.full() || !this->claim()) [[unlikely]] {
                 HCE_TRACE_METHOD_BODY("send","blocked");
-                parent_.parked_send_.push_back(this);
+                parent_.parked_send_.push_back({ this, this->sel });
                 return false;
             } else [[likely]] {
                 HCE_TRACE_METHOD_BODY("send","done");
                 this->tx.send(&(parent_.buf_));
                 this->success = true;
-
-                if(parent_.parked_recv_.size()) [[unlikely]] {
-                    detail::transfer tx(detail::circular_buffer_recv<T>,&(parent_.buf_));
-                    parent_.parked_recv_.front()->resume((void*)&(tx));
-                    parent_.parked_recv_.pop();
-                }
-
+                this->notify();
+                parent_.resume_recv_();
                 return true;
             }
         }
@@ -651,13 +1652,14 @@ private:
         inline std::string name() const { return recv_interface::info_name(); }
 
         inline bool on_ready() {
-            if(parent_.buf_.empty()) [[unlikely]] {
+            if(parent_.buf_.empty() || !this->claim()) [[unlikely]] {
                 if(parent_.closed_flag_ ) [[unlikely]] {
                     HCE_TRACE_METHOD_BODY("recv","closed");
+                    this->fail();
                     return true;
                 } else [[likely]] {
                     HCE_TRACE_METHOD_BODY("recv","blocked");
-                    parent_.parked_recv_.push_back(this);
+                    parent_.parked_recv_.push_back({ this, this->sel });
                     return false;
                 }
             } else [[likely]] {
@@ -665,20 +1667,147 @@ private:
                 detail::transfer tx(detail::circular_buffer_recv<T>,&(parent_.buf_));
                 tx.send(this->destination);
                 this->success = true;
+                this->notify();
+                parent_.resume_send_();
+                return true;
+            }
+        }
+
+    private:
+        PARENT& parent_;
+    };
+
+    struct send_n_interface : public detail::base_batch_interface<LOCK> {
+        send_n_interface(PARENT& p, std::unique_ptr<detail::source<T>> s) :
+            detail::base_batch_interface<LOCK>(p.lk_),
+            parent_(p),
+            source_(std::move(s))
+        { }
+
+        static inline std::string info_name() {
+            return buffered<T,LOCK,ALLOCATOR>::info_name() + 
+                   "::send_n_interface";
+        };
+
+        inline std::string name() const { return send_n_interface::info_name(); }
+
+        inline bool on_ready() {
+            if(parent_.closed_flag_ || source_->empty()) [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("send_n","closed or empty");
+                return true;
+            } else if(parent_.buf_.full()) [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("send_n","blocked");
+                parent_.parked_send_.push_back(this);
+                return false;
+            } else [[likely]] {
+                HCE_TRACE_METHOD_BODY("send_n","done");
+                push_(&(parent_.buf_));
+                parent_.resume_recv_();
+                return true;
+            }
+        }
 
-                if(parent_.parked_send_.size()) [[unlikely]] {
-                    parent_.parked_send_.front()->resume((void*)&(parent_.buf_));
-                    parent_.parked_send_.pop();
+        inline void on_resume(void* m) {
+            HCE_MIN_METHOD_ENTER("on_resume",m);
+
+            // m is the buffer, which has room for at least one value
+            if(m) [[likely]] { push_((hce::circular_buffer<T>*)m); }
+        }
+
+    private:
+        inline void push_(hce::circular_buffer<T>* buf) {
+            while(!buf->full() && !source_->empty()) {
+                buf->push(std::move(source_->front()));
+                source_->pop();
+                ++(this->count);
+            }
+        }
+
+        PARENT& parent_;
+        std::unique_ptr<detail::source<T>> source_;
+    };
+
+    struct recv_n_interface : public detail::base_batch_interface<LOCK> {
+        recv_n_interface(PARENT& p, std::unique_ptr<detail::sink<T>> s) :
+            detail::base_batch_interface<LOCK>(p.lk_),
+            parent_(p),
+            sink_(std::move(s))
+        { }
+
+        static inline std::string info_name() {
+            return buffered<T,LOCK,ALLOCATOR>::info_name() + 
+                   "::recv_n_interface";
+        };
+
+        inline std::string name() const { return recv_n_interface::info_name(); }
+
+        inline bool on_ready() {
+            if(sink_->full()) [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("recv_n","full");
+                return true;
+            } else if(parent_.buf_.empty()) [[unlikely]] {
+                if(parent_.closed_flag_ ) [[unlikely]] {
+                    HCE_TRACE_METHOD_BODY("recv_n","closed");
+                    return true;
+                } else [[likely]] {
+                    HCE_TRACE_METHOD_BODY("recv_n","blocked");
+                    parent_.parked_recv_.push_back(this);
+                    return false;
+                }
+            } else [[likely]] {
+                HCE_TRACE_METHOD_BODY("recv_n","done");
+
+                while(!parent_.buf_.empty() && !sink_->full()) {
+                    sink_->push(std::move(parent_.buf_.front()));
+                    parent_.buf_.pop();
+                    ++(this->count);
                 }
 
+                parent_.resume_send_();
                 return true;
             }
         }
 
+        inline void on_resume(void* m) {
+            HCE_MIN_METHOD_ENTER("on_resume",m);
+
+            if(m) [[likely]] {
+                // m is transfer struct
+                T t;
+                ((detail::transfer*)m)->send(&t);
+                sink_->push(std::move(t));
+                this->count = 1;
+            }
+        }
+
     private:
         PARENT& parent_;
+        std::unique_ptr<detail::sink<T>> sink_;
     };
 
+    typedef hce::list<detail::parked<hce::awaitable::interface>,ALLOCATOR> PARKED;
+    typedef detail::deadline<LOCK,PARKED,send_interface> timed_send_interface;
+    typedef detail::deadline<LOCK,PARKED,recv_interface> timed_recv_interface;
+    typedef detail::selecting<LOCK,PARKED,send_interface> select_send_interface;
+    typedef detail::selecting<LOCK,PARKED,recv_interface> select_recv_interface;
+
+    // resume parked receivers with a value each until the buffer is empty
+    inline void resume_recv_() {
+        while(!buf_.empty() && detail::claim_front(parked_recv_)) {
+            detail::transfer tx(detail::circular_buffer_recv<T>,&buf_);
+            parked_recv_.front()->resume((void*)&tx);
+            parked_recv_.pop();
+        }
+    }
+
+    // resume parked senders with the buffer until it is full
+    inline void resume_send_() {
+        while(!buf_.full() && detail::claim_front(parked_send_)) {
+            parked_send_.front()->resume((void*)&buf_);
+            parked_send_.pop();
+        }
+    }
+
     template <typename U>
     inline hce::yield<result> try_send_(U&& s) {
         std::lock_guard<LOCK> lk(lk_);
@@ -689,11 +1818,7 @@ private:
         } else if(!buf_.full()) [[likely]] {
             HCE_TRACE_METHOD_BODY("try_send","done");
             buf_.push(std::forward<U>(s));
-
-            if(parked_recv_.size()) [[unlikely]] {
-                parked_recv_.front()->resume((void*)&buf_);
-                parked_recv_.pop();
-            }
+            resume_recv_();
 
             return { result::success }; 
         } else [[unlikely]] { 
@@ -705,15 +1830,36 @@ private:
     mutable LOCK lk_;
     bool closed_flag_ = false;
     hce::circular_buffer<T> buf_;
-    hce::list<awt<bool>::interface*,ALLOCATOR> parked_send_;
-    hce::list<awt<bool>::interface*,ALLOCATOR> parked_recv_;
+    PARKED parked_send_;
+    PARKED parked_recv_;
 };
 
-/// unlimited interface implementation
+/**
+ @brief unlimited interface implementation
+
+ Values are queued in an `hce::segmented_queue`, so memory is allocated once 
+ per segment of values rather than once per value.
+ */
 template <typename T, typename LOCK=hce::spinlock, typename ALLOCATOR=hce::pool_allocator<T>>
 struct unlimited : public interface<T> {
     typedef T value_type;
 
+    using interface<T>::send;
+    using interface<T>::recv;
+    using interface<T>::send_n;
+    using interface<T>::recv_n;
+
+private:
+    struct send_interface;
+    struct recv_interface;
+
+public:
+    /// awaitable returned by `embedded_send()`
+    typedef hce::awaitable::embedded<send_interface> send_awaitable;
+
+    /// awaitable returned by `embedded_recv()`
+    typedef hce::awaitable::embedded<recv_interface> recv_awaitable;
+
     unlimited() { 
         HCE_LOW_CONSTRUCTOR();
     }
@@ -773,8 +1919,8 @@ struct unlimited : public interface<T> {
         if(!closed_flag_) [[unlikely]] {
             closed_flag_ = true;
 
-            while(parked_recv_.size()) { 
-                HCE_TRACE_METHOD_BODY("close","closing parked recv:",parked_recv_.front());
+            while(detail::claim_front(parked_recv_)) { 
+                HCE_TRACE_METHOD_BODY("close","closing parked recv:",parked_recv_.front().op);
                 parked_recv_.front()->resume(nullptr); 
                 parked_recv_.pop();
             }
@@ -785,14 +1931,14 @@ struct unlimited : public interface<T> {
         HCE_LOW_METHOD_ENTER("send",(void*)&s);
         return awt<bool>(new send_interface(
             *this, 
-            detail::transfer(detail::list_send<const T&,hce::list<T,ALLOCATOR>>,&s)));
+            detail::transfer(detail::list_send<const T&,QUEUE>,&s)));
     }
 
     inline awt<bool> send(T&& s) {
         HCE_LOW_METHOD_ENTER("send",(void*)&s);
         return awt<bool>(new send_interface(
             *this, 
-            detail::transfer(detail::list_send<T&&,hce::list<T,ALLOCATOR>>,&s)));
+            detail::transfer(detail::list_send<T&&,QUEUE>,&s)));
     }
 
     /**
@@ -804,6 +1950,52 @@ struct unlimited : public interface<T> {
         return awt<bool>(new recv_interface(*this, (void*)&r));
     }
 
+    /// see `unbuffered::embedded_send()`
+    inline send_awaitable embedded_send(const T& s) {
+        HCE_LOW_METHOD_ENTER("embedded_send",(void*)&s);
+        return send_awaitable(
+            *this,
+            detail::transfer(detail::list_send<const T&,QUEUE>,&s));
+    }
+
+    /// see `unbuffered::embedded_send()`
+    inline send_awaitable embedded_send(T&& s) {
+        HCE_LOW_METHOD_ENTER("embedded_send",(void*)&s);
+        return send_awaitable(
+            *this,
+            detail::transfer(detail::list_send<T&&,QUEUE>,&s));
+    }
+
+    /// see `unbuffered::embedded_recv()`
+    inline recv_awaitable embedded_recv(T& r) {
+        HCE_LOW_METHOD_ENTER("embedded_recv",(void*)&r);
+        return recv_awaitable(*this, (void*)&r);
+    }
+
+    /// unlimited sends never block, so the timeout is never reached
+    inline awt<bool> send(
+            const T& s, 
+            const hce::chrono::time_point& timeout) {
+        HCE_LOW_METHOD_ENTER("send",(void*)&s,timeout);
+        return send(s);
+    }
+
+    /// unlimited sends never block, so the timeout is never reached
+    inline awt<bool> send(T&& s, const hce::chrono::time_point& timeout) {
+        HCE_LOW_METHOD_ENTER("send",(void*)&s,timeout);
+        return send(std::move(s));
+    }
+
+    inline awt<bool> recv(T& r, const hce::chrono::time_point& timeout) {
+        HCE_LOW_METHOD_ENTER("recv",(void*)&r,timeout);
+        return awt<bool>(new timed_recv_interface(
+            lk_, 
+            parked_recv_, 
+            timeout,
+            *this, 
+            (void*)&r));
+    }
+
     inline hce::yield<result> try_send(const T& t) {
         HCE_LOW_METHOD_ENTER("try_send",(void*)&t);
         return try_send_(t);
@@ -841,6 +2033,63 @@ struct unlimited : public interface<T> {
         }
     }
 
+    /// unlimited sends never block, so every value is sent unless closed
+    inline awt<size_t> send_n(std::unique_ptr<detail::source<T>> s) {
+        HCE_LOW_METHOD_ENTER("send_n");
+        return hce::awt<size_t>(new send_n_interface(*this, std::move(s)));
+    }
+
+    inline awt<size_t> recv_n(std::unique_ptr<detail::sink<T>> s) {
+        HCE_LOW_METHOD_ENTER("recv_n");
+        return hce::awt<size_t>(new recv_n_interface(*this, std::move(s)));
+    }
+
+    inline std::unique_ptr<detail::select_case> select_send(
+            const T& s, 
+            detail::selector& sel, 
+            size_t index) {
+        HCE_LOW_METHOD_ENTER("select_send",(void*)&s,index);
+
+        // sends never park, so there is nothing to cancel on the parked list
+        return std::unique_ptr<detail::select_case>(new select_send_interface(
+            lk_, 
+            parked_recv_, 
+            sel,
+            index,
+            *this, 
+            detail::transfer(detail::list_send<const T&,QUEUE>,&s)));
+    }
+
+    inline std::unique_ptr<detail::select_case> select_send(
+            T&& s, 
+            detail::selector& sel, 
+            size_t index) {
+        HCE_LOW_METHOD_ENTER("select_send",(void*)&s,index);
+
+        return std::unique_ptr<detail::select_case>(new select_send_interface(
+            lk_, 
+            parked_recv_, 
+            sel,
+            index,
+            *this, 
+            detail::transfer(detail::list_send<T&&,QUEUE>,&s)));
+    }
+
+    inline std::unique_ptr<detail::select_case> select_recv(
+            T& r, 
+            detail::selector& sel, 
+            size_t index) {
+        HCE_LOW_METHOD_ENTER("select_recv",(void*)&r,index);
+
+        return std::unique_ptr<detail::select_case>(new select_recv_interface(
+            lk_, 
+            parked_recv_, 
+            sel,
+            index,
+            *this, 
+            (void*)&r));
+    }
+
 private:
     typedef unlimited<T,LOCK,ALLOCATOR> PARENT;
 
@@ -860,18 +2109,17 @@ private:
         inline bool on_ready() { 
             if(parent_.closed_flag_) [[unlikely]] {
                 HCE_TRACE_METHOD_BODY("send","closed");
+                this->fail();
                 return true;
-            } else [[likely]] {
+            } else if(this->claim()) [[likely]] {
                 HCE_TRACE_METHOD_BODY("send","done");
                 this->tx.send(&(parent_.queue_));
                 this->success = true;
-
-                if(parent_.parked_recv_.size()) [[unlikely]] {
-                    detail::transfer tx(&detail::list_recv<T,hce::list<T,ALLOCATOR>>,&(parent_.queue_));
-                    parent_.parked_recv_.front()->resume((void*)&tx);
-                    parent_.parked_recv_.pop();
-                }
-
+                this->notify();
+                parent_.resume_recv_();
+                return true;
+            } else [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("send","select completed another case");
                 return true;
             }
         }
@@ -894,20 +2142,22 @@ private:
         inline std::string name() const { return recv_interface::info_name(); }
 
         inline bool on_ready() {
-            if(parent_.queue_.empty()) [[unlikely]] {
+            if(parent_.queue_.empty() || !this->claim()) [[unlikely]] {
                 if(parent_.closed_flag_ ) [[unlikely]] {
                     HCE_TRACE_METHOD_BODY("recv","closed");
+                    this->fail();
                     return true;
                 } else [[likely]] {
                     HCE_TRACE_METHOD_BODY("recv","blocked");
-                    parent_.parked_recv_.push_back(this);
+                    parent_.parked_recv_.push_back({ this, this->sel });
                     return false;
                 }
             } else [[likely]] {
                 HCE_TRACE_METHOD_BODY("recv_","done");
-                detail::transfer tx(&detail::list_recv<T,hce::list<T,ALLOCATOR>>,&(parent_.queue_));
+                detail::transfer tx(&detail::list_recv<T,QUEUE>,&(parent_.queue_));
                 tx.send(this->destination);
                 this->success = true;
+                this->notify();
                 return true;
             }
         }
@@ -915,51 +2165,1968 @@ private:
     private:
         PARENT& parent_;
     };
-    
-    template <typename U>
-    inline hce::yield<result> try_send_(U&& s) {
-        std::lock_guard<LOCK> lk(lk_);
 
-        if(closed_flag_) [[unlikely]] { 
-            HCE_TRACE_METHOD_BODY("try_send","closed");
-            return { result::closed }; 
-        } else [[likely]] {
-            HCE_TRACE_METHOD_BODY("try_send","done");
-            queue_.push_back(std::forward<U>(s));
+    struct send_n_interface : public detail::base_batch_interface<LOCK> {
+        send_n_interface(PARENT& p, std::unique_ptr<detail::source<T>> s) :
+            detail::base_batch_interface<LOCK>(p.lk_),
+            parent_(p),
+            source_(std::move(s))
+        { }
 
-            if(parked_recv_.size()) [[unlikely]] {
-                detail::transfer tx(&detail::list_recv<T,hce::list<T,ALLOCATOR>>, &queue_);
-                parked_recv_.front()->resume((void*)&tx);
-                parked_recv_.pop();
-            }
+        static inline std::string info_name() {
+            return unlimited<T,LOCK,ALLOCATOR>::info_name() + 
+                   "::send_n_interface";
+        };
 
-            // return an awaitable which immediately returns true
-            return { result::success }; 
-        } 
-    }
+        inline std::string name() const { return send_n_interface::info_name(); }
 
-    mutable LOCK lk_;
-    bool closed_flag_ = false;
-    hce::list<T,ALLOCATOR> queue_;
+        inline bool on_ready() { 
+            if(parent_.closed_flag_) [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("send_n","closed");
+                return true;
+            } else [[likely]] {
+                HCE_TRACE_METHOD_BODY("send_n","done");
 
-    // send() never blocks, so only has parked recv queue
-    hce::list<awt<bool>::interface*,ALLOCATOR> parked_recv_;
-};
+                while(!source_->empty()) {
+                    parent_.queue_.push_back(std::move(source_->front()));
+                    source_->pop();
+                    ++(this->count);
+                }
 
-}
+                // resume parked receivers with a value each
+                parent_.resume_recv_();
+                return true;
+            }
+        }
 
-/** 
- @brief communication object which can represent any object which implements channel::interface<T>
+        // unlimited sends never park
+        inline void on_resume(void* m) { }
 
- This object is essentially a sanitized 
- `std::shared_ptr<hce::channel::interface<T>>`, with helper construction 
- functions and convenience operators. Its also convient because of its short 
- name/namespace and direct method access, allowing it to be easily used and 
- passed around in coroutines without added template complexity or memory 
- indirection considerations (no `*` or `->` operator usage). Just make copies of 
- an instantiated `hce::chan<T>` and call its methods directly.
+    private:
+        PARENT& parent_;
+        std::unique_ptr<detail::source<T>> source_;
+    };
 
- It's useful to point out that implementations of `hce::channel::interface<T>` 
+    struct recv_n_interface : public detail::base_batch_interface<LOCK> {
+        recv_n_interface(PARENT& p, std::unique_ptr<detail::sink<T>> s) :
+            detail::base_batch_interface<LOCK>(p.lk_),
+            parent_(p),
+            sink_(std::move(s))
+        { }
+
+        static inline std::string info_name() {
+            return unlimited<T,LOCK,ALLOCATOR>::info_name() + 
+                   "::recv_n_interface";
+        };
+
+        inline std::string name() const { return recv_n_interface::info_name(); }
+
+        inline bool on_ready() {
+            if(sink_->full()) [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("recv_n","full");
+                return true;
+            } else if(parent_.queue_.empty()) [[unlikely]] {
+                if(parent_.closed_flag_ ) [[unlikely]] {
+                    HCE_TRACE_METHOD_BODY("recv_n","closed");
+                    return true;
+                } else [[likely]] {
+                    HCE_TRACE_METHOD_BODY("recv_n","blocked");
+                    parent_.parked_recv_.push_back(this);
+                    return false;
+                }
+            } else [[likely]] {
+                HCE_TRACE_METHOD_BODY("recv_n","done");
+
+                while(!parent_.queue_.empty() && !sink_->full()) {
+                    sink_->push(std::move(parent_.queue_.front()));
+                    parent_.queue_.pop();
+                    ++(this->count);
+                }
+
+                return true;
+            }
+        }
+
+        inline void on_resume(void* m) {
+            HCE_MIN_METHOD_ENTER("on_resume",m);
+
+            if(m) [[likely]] {
+                // m is transfer struct
+                T t;
+                ((detail::transfer*)m)->send(&t);
+                sink_->push(std::move(t));
+                this->count = 1;
+            }
+        }
+
+    private:
+        PARENT& parent_;
+        std::unique_ptr<detail::sink<T>> sink_;
+    };
+
+    typedef hce::segmented_queue<T,ALLOCATOR> QUEUE;
+    typedef hce::list<detail::parked<hce::awaitable::interface>,ALLOCATOR> PARKED;
+    typedef detail::deadline<LOCK,PARKED,recv_interface> timed_recv_interface;
+    typedef detail::selecting<LOCK,PARKED,send_interface> select_send_interface;
+    typedef detail::selecting<LOCK,PARKED,recv_interface> select_recv_interface;
+
+    // resume parked receivers with a value each until the queue is empty
+    inline void resume_recv_() {
+        while(!queue_.empty() && detail::claim_front(parked_recv_)) {
+            detail::transfer tx(&detail::list_recv<T,QUEUE>,&queue_);
+            parked_recv_.front()->resume((void*)&tx);
+            parked_recv_.pop();
+        }
+    }
+    
+    template <typename U>
+    inline hce::yield<result> try_send_(U&& s) {
+        std::lock_guard<LOCK> lk(lk_);
+
+        if(closed_flag_) [[unlikely]] { 
+            HCE_TRACE_METHOD_BODY("try_send","closed");
+            return { result::closed }; 
+        } else [[likely]] {
+            HCE_TRACE_METHOD_BODY("try_send","done");
+            queue_.push_back(std::forward<U>(s));
+            resume_recv_();
+
+            // return an awaitable which immediately returns true
+            return { result::success }; 
+        } 
+    }
+
+    mutable LOCK lk_;
+    bool closed_flag_ = false;
+    QUEUE queue_;
+
+    // send() never blocks, so only has parked recv queue
+    PARKED parked_recv_;
+};
+
+/**
+ @brief single producer, single consumer interface implementation
+
+ Values are stored in a fixed size ring indexed by cache line padded 
+ acquire/release counters, so no lock is acquired while the ring is neither 
+ full nor empty. A sender only parks when the ring is full and a receiver 
+ only parks when it is empty, at which point a lock guarding the parked 
+ operations is acquired.
+
+ At most one coroutine or thread can send at a time, and at most one can 
+ receive at a time. Multiple senders or receivers require `buffered`.
+
+ Like `buffered`, receives succeed after `close()` as long as values are 
+ available in the ring.
+ */
+template <typename T, typename ALLOCATOR=hce::pool_allocator<T>>
+struct spsc : public interface<T> {
+    typedef T value_type;
+
+    using interface<T>::send;
+    using interface<T>::recv;
+    using interface<T>::send_n;
+    using interface<T>::recv_n;
+
+private:
+    struct send_interface;
+    struct recv_interface;
+
+public:
+    /// awaitable returned by `embedded_send()`
+    typedef hce::awaitable::embedded<send_interface> send_awaitable;
+
+    /// awaitable returned by `embedded_recv()`
+    typedef hce::awaitable::embedded<recv_interface> recv_awaitable;
+
+    spsc(int sz) : 
+        capacity_(sz > 0 ? (size_t)sz : (size_t)1),
+        mask_(detail::ring_size(capacity_) - 1),
+        ring_(new storage[mask_ + 1])
+    { 
+        HCE_LOW_CONSTRUCTOR();
+    }
+
+    spsc(int sz, const ALLOCATOR& allocator) : 
+        parked_send_(allocator),
+        parked_recv_(allocator),
+        capacity_(sz > 0 ? (size_t)sz : (size_t)1),
+        mask_(detail::ring_size(capacity_) - 1),
+        ring_(new storage[mask_ + 1])
+    { 
+        HCE_LOW_CONSTRUCTOR();
+    }
+
+    spsc(const spsc<T,ALLOCATOR>&) = delete;
+    spsc(spsc<T,ALLOCATOR>&&) = delete;
+
+    inline virtual ~spsc(){ 
+        HCE_LOW_DESTRUCTOR(); 
+
+        // destroy any values remaining in the ring
+        const size_t tail = tail_.load(std::memory_order_acquire);
+
+        for(size_t i = head_.load(std::memory_order_relaxed); i != tail; ++i) {
+            slot_(i)->~T();
+        }
+    }
+
+    spsc<T,ALLOCATOR>& operator=(const spsc<T,ALLOCATOR>&) = delete;
+    spsc<T,ALLOCATOR>& operator=(spsc<T,ALLOCATOR>&&) = delete;
+
+    static inline std::string info_name() { 
+        return type::templatize<T,ALLOCATOR>("hce::channel::spsc"); 
+    }
+
+    inline std::string name() const { 
+        return spsc<T,ALLOCATOR>::info_name(); 
+    }
+
+    inline const std::type_info& type_info() const {
+        HCE_TRACE_METHOD_ENTER("type_info");
+        return typeid(spsc<T,ALLOCATOR>); 
+    }
+
+    inline int size() const {
+        HCE_MIN_METHOD_ENTER("size");
+        return (int)capacity_;
+    }
+
+    inline int used() const {
+        HCE_MIN_METHOD_ENTER("used");
+        const size_t head = head_.load(std::memory_order_acquire);
+        return (int)(tail_.load(std::memory_order_acquire) - head);
+    }
+
+    inline bool closed() const {
+        HCE_MIN_METHOD_ENTER("closed");
+        return closed_flag_.load(std::memory_order_acquire);
+    }
+
+    inline void close() {
+        HCE_LOW_METHOD_ENTER("close");
+
+        std::lock_guard<hce::spinlock> lk(lk_);
+
+        if(!closed_flag_.load(std::memory_order_relaxed)) [[likely]] {
+            closed_flag_.store(true, std::memory_order_release);
+
+            while(detail::claim_front(parked_send_)) { 
+                parked_send_.front()->resume(nullptr); 
+                parked_send_.pop();
+            }
+
+            while(detail::claim_front(parked_recv_)) { 
+                parked_recv_.front()->resume(nullptr); 
+                parked_recv_.pop();
+            }
+
+            send_parked_.store(false, std::memory_order_relaxed);
+            recv_parked_.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    inline awt<bool> send(const T& s) {
+        HCE_LOW_METHOD_ENTER("send",(void*)&s);
+
+        return hce::awt<bool>(new send_interface(
+            *this, detail::transfer(&PARENT::template push_transfer_<const T&>,(void*)&s)));
+    }
+
+    inline awt<bool> send(T&& s) {
+        HCE_LOW_METHOD_ENTER("send",(void*)&s);
+
+        return hce::awt<bool>(new send_interface(
+            *this, detail::transfer(&PARENT::template push_transfer_<T&&>,(void*)&s)));
+    }
+
+    inline awt<bool> recv(T& r) {
+        HCE_LOW_METHOD_ENTER("recv",(void*)&r);
+
+        return hce::awt<bool>(new recv_interface(*this, (void*)&r));
+    }
+
+    /// see `unbuffered::embedded_send()`
+    inline send_awaitable embedded_send(const T& s) {
+        HCE_LOW_METHOD_ENTER("embedded_send",(void*)&s);
+        return send_awaitable(
+            *this,
+            detail::transfer(&PARENT::template push_transfer_<const T&>,(void*)&s));
+    }
+
+    /// see `unbuffered::embedded_send()`
+    inline send_awaitable embedded_send(T&& s) {
+        HCE_LOW_METHOD_ENTER("embedded_send",(void*)&s);
+        return send_awaitable(
+            *this,
+            detail::transfer(&PARENT::template push_transfer_<T&&>,(void*)&s));
+    }
+
+    /// see `unbuffered::embedded_recv()`
+    inline recv_awaitable embedded_recv(T& r) {
+        HCE_LOW_METHOD_ENTER("embedded_recv",(void*)&r);
+        return recv_awaitable(*this, (void*)&r);
+    }
+
+    inline awt<bool> send(
+            const T& s, 
+            const hce::chrono::time_point& timeout) {
+        HCE_LOW_METHOD_ENTER("send",(void*)&s,timeout);
+
+        return hce::awt<bool>(new timed_send_interface(
+            lk_, 
+            parked_send_, 
+            timeout,
+            *this, 
+            detail::transfer(&PARENT::template push_transfer_<const T&>,(void*)&s)));
+    }
+
+    inline awt<bool> send(T&& s, const hce::chrono::time_point& timeout) {
+        HCE_LOW_METHOD_ENTER("send",(void*)&s,timeout);
+
+        return hce::awt<bool>(new timed_send_interface(
+            lk_, 
+            parked_send_, 
+            timeout,
+            *this, 
+            detail::transfer(&PARENT::template push_transfer_<T&&>,(void*)&s)));
+    }
+
+    inline awt<bool> recv(T& r, const hce::chrono::time_point& timeout) {
+        HCE_LOW_METHOD_ENTER("recv",(void*)&r,timeout);
+
+        return hce::awt<bool>(new timed_recv_interface(
+            lk_, 
+            parked_recv_, 
+            timeout,
+            *this, 
+            (void*)&r));
+    }
+
+    inline hce::yield<result> try_send(const T& t) {
+        HCE_LOW_METHOD_ENTER("try_send",(void*)&t);
+        return try_send_(t);
+    }
+
+    inline hce::yield<result> try_send(T&& t) {
+        HCE_LOW_METHOD_ENTER("try_send",(void*)&t);
+        return try_send_(std::move(t));
+    }
+
+    inline hce::yield<result> try_recv(T& r) {
+        HCE_LOW_METHOD_ENTER("try_recv",(void*)&r);
+
+        if(!empty_()) [[likely]] {
+            HCE_TRACE_METHOD_BODY("try_recv","done");
+            pop_(r);
+            notify_send_();
+            return { result::success }; 
+        } else if(closed_flag_.load(std::memory_order_acquire)) {
+            // a value may have been sent before the close
+            if(!empty_()) [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("try_recv","done");
+                pop_(r);
+                return { result::success }; 
+            }
+
+            HCE_TRACE_METHOD_BODY("try_recv","closed");
+            return { result::closed }; 
+        } else [[unlikely]] {
+            HCE_TRACE_METHOD_BODY("try_recv","failed");
+            return { result::failure }; 
+        }
+    }
+
+    inline awt<size_t> send_n(std::unique_ptr<detail::source<T>> s) {
+        HCE_LOW_METHOD_ENTER("send_n");
+        return hce::awt<size_t>(new send_n_interface(*this, std::move(s)));
+    }
+
+    inline awt<size_t> recv_n(std::unique_ptr<detail::sink<T>> s) {
+        HCE_LOW_METHOD_ENTER("recv_n");
+        return hce::awt<size_t>(new recv_n_interface(*this, std::move(s)));
+    }
+
+    inline std::unique_ptr<detail::select_case> select_send(
+            const T& s, 
+            detail::selector& sel, 
+            size_t index) {
+        HCE_LOW_METHOD_ENTER("select_send",(void*)&s,index);
+
+        return std::unique_ptr<detail::select_case>(new select_send_interface(
+            lk_, 
+            parked_send_, 
+            sel,
+            index,
+            *this, 
+            detail::transfer(&PARENT::template push_transfer_<const T&>,(void*)&s)));
+    }
+
+    inline std::unique_ptr<detail::select_case> select_send(
+            T&& s, 
+            detail::selector& sel, 
+            size_t index) {
+        HCE_LOW_METHOD_ENTER("select_send",(void*)&s,index);
+
+        return std::unique_ptr<detail::select_case>(new select_send_interface(
+            lk_, 
+            parked_send_, 
+            sel,
+            index,
+            *this, 
+            detail::transfer(&PARENT::template push_transfer_<T&&>,(void*)&s)));
+    }
+
+    inline std::unique_ptr<detail::select_case> select_recv(
+            T& r, 
+            detail::selector& sel, 
+            size_t index) {
+        HCE_LOW_METHOD_ENTER("select_recv",(void*)&r,index);
+
+        return std::unique_ptr<detail::select_case>(new select_recv_interface(
+            lk_, 
+            parked_recv_, 
+            sel,
+            index,
+            *this, 
+            (void*)&r));
+    }
+
+private:
+    typedef spsc<T,ALLOCATOR> PARENT;
+
+    // uninitialized memory for a value in the ring
+    struct storage {
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    /*
+     The operations lock their own lock rather than the channel's, which is 
+     only acquired when parking or resuming a parked operation.
+     */
+    struct send_interface : 
+        public hce::scheduler::reschedule<
+            hce::awaitable::lockable<
+                hce::spinlock,
+                awt_interface<bool>>>,
+        public detail::selectable
+    {
+        send_interface(PARENT& p, detail::transfer tx) :
+            hce::scheduler::reschedule<
+                hce::awaitable::lockable<
+                    hce::spinlock,
+                    awt_interface<bool>>>(
+                        lk_,
+                        hce::awaitable::await::policy::defer,
+                        hce::awaitable::resume::policy::lock),
+            parent_(p),
+            tx_(tx)
+        { }
+
+        static inline std::string info_name() {
+            return spsc<T,ALLOCATOR>::info_name() + "::send_interface";
+        };
+
+        inline std::string name() const { return send_interface::info_name(); }
+
+        inline bool on_ready() {
+            if(parent_.closed_flag_.load(std::memory_order_acquire)) [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("send","closed");
+                this->fail();
+                return true;
+            } else if(!parent_.full_()) [[likely]] {
+                if(this->claim()) [[likely]] {
+                    HCE_TRACE_METHOD_BODY("send","done");
+                    tx_.send(&parent_);
+                    success_ = true;
+                    parent_.notify_recv_();
+                    this->notify();
+                }
+
+                return true;
+            } else [[unlikely]] {
+                std::lock_guard<hce::spinlock> lk(parent_.lk_);
+
+                if(parent_.closed_flag_.load(std::memory_order_relaxed)) {
+                    HCE_TRACE_METHOD_BODY("send","closed");
+                    this->fail();
+                    return true;
+                }
+
+                // the receiver resumes parked senders after it observes this
+                parent_.send_parked_.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if(!parent_.full_()) {
+                    parent_.send_parked_.store(false, std::memory_order_relaxed);
+
+                    if(this->claim()) [[likely]] {
+                        HCE_TRACE_METHOD_BODY("send","done");
+                        tx_.send(&parent_);
+                        success_ = true;
+                        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                        if(parent_.recv_parked_.load(std::memory_order_relaxed)) {
+                            parent_.resume_recv_();
+                        }
+
+                        this->notify();
+                    }
+
+                    return true;
+                }
+
+                HCE_TRACE_METHOD_BODY("send","blocked");
+                parent_.parked_send_.push_back({ this, this->sel });
+                return false;
+            }
+        }
+
+        inline void on_resume(void* m) {
+            HCE_MIN_METHOD_ENTER("on_resume",m);
+
+            if(m) [[likely]] {
+                // m is the channel, which the receiver made room in
+                tx_.send(m);
+                success_ = true;
+            }
+
+            this->notify();
+        }
+
+        inline bool get_result() { 
+            HCE_MIN_METHOD_BODY("get_result",success_);
+            return success_; 
+        }
+
+    private:
+        hce::spinlock lk_;
+        PARENT& parent_;
+        detail::transfer tx_;
+        bool success_ = false;
+    };
+
+    struct recv_interface : 
+        public hce::scheduler::reschedule<
+            hce::awaitable::lockable<
+                hce::spinlock,
+                awt_interface<bool>>>,
+        public detail::selectable
+    {
+        recv_interface(PARENT& p, void* destination) :
+            hce::scheduler::reschedule<
+                hce::awaitable::lockable<
+                    hce::spinlock,
+                    awt_interface<bool>>>(
+                        lk_,
+                        hce::awaitable::await::policy::defer,
+                        hce::awaitable::resume::policy::lock),
+            parent_(p),
+            destination_(destination)
+        { }
+
+        static inline std::string info_name() {
+            return spsc<T,ALLOCATOR>::info_name() + "::recv_interface";
+        };
+
+        inline std::string name() const { return recv_interface::info_name(); }
+
+        inline bool on_ready() {
+            if(!parent_.empty_()) [[likely]] {
+                if(this->claim()) [[likely]] {
+                    HCE_TRACE_METHOD_BODY("recv","done");
+                    parent_.pop_(*((T*)destination_));
+                    success_ = true;
+                    parent_.notify_send_();
+                    this->notify();
+                }
+
+                return true;
+            } else [[unlikely]] {
+                std::lock_guard<hce::spinlock> lk(parent_.lk_);
+
+                // the sender resumes parked receivers after it observes this
+                parent_.recv_parked_.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if(!parent_.empty_()) {
+                    parent_.recv_parked_.store(false, std::memory_order_relaxed);
+
+                    if(this->claim()) [[likely]] {
+                        HCE_TRACE_METHOD_BODY("recv","done");
+                        parent_.pop_(*((T*)destination_));
+                        success_ = true;
+                        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                        if(parent_.send_parked_.load(std::memory_order_relaxed)) {
+                            parent_.resume_send_();
+                        }
+
+                        this->notify();
+                    }
+
+                    return true;
+                } else if(parent_.closed_flag_.load(std::memory_order_relaxed)) {
+                    HCE_TRACE_METHOD_BODY("recv","closed");
+                    parent_.recv_parked_.store(false, std::memory_order_relaxed);
+                    this->fail();
+                    return true;
+                }
+
+                HCE_TRACE_METHOD_BODY("recv","blocked");
+                parent_.parked_recv_.push_back({ this, this->sel });
+                return false;
+            }
+        }
+
+        inline void on_resume(void* m) {
+            HCE_TRACE_METHOD_BODY("on_resume",m);
+
+            if(m) [[likely]] {
+                // m is transfer struct
+                ((detail::transfer*)m)->send(destination_);
+                success_ = true;
+            }
+
+            this->notify();
+        }
+
+        inline bool get_result() { 
+            HCE_MIN_METHOD_BODY("get_result",success_);
+            return success_; 
+        }
+
+    private:
+        hce::spinlock lk_;
+        PARENT& parent_;
+        void* destination_;
+        bool success_ = false;
+    };
+
+    struct send_n_interface : 
+        public hce::scheduler::reschedule<
+            hce::awaitable::lockable<
+                hce::spinlock,
+                awt_interface<size_t>>>
+    {
+        send_n_interface(PARENT& p, std::unique_ptr<detail::source<T>> s) :
+            hce::scheduler::reschedule<
+                hce::awaitable::lockable<
+                    hce::spinlock,
+                    awt_interface<size_t>>>(
+                        lk_,
+                        hce::awaitable::await::policy::defer,
+                        hce::awaitable::resume::policy::lock),
+            parent_(p),
+            source_(std::move(s))
+        { }
+
+        static inline std::string info_name() {
+            return spsc<T,ALLOCATOR>::info_name() + "::send_n_interface";
+        };
+
+        inline std::string name() const { return send_n_interface::info_name(); }
+
+        inline bool on_ready() {
+            if(parent_.closed_flag_.load(std::memory_order_acquire) || 
+               source_->empty()) [[unlikely]] 
+            {
+                HCE_TRACE_METHOD_BODY("send_n","closed or empty");
+                return true;
+            } else if(push_()) [[likely]] {
+                HCE_TRACE_METHOD_BODY("send_n","done");
+                parent_.notify_recv_();
+                return true;
+            } else [[unlikely]] {
+                std::lock_guard<hce::spinlock> lk(parent_.lk_);
+
+                if(parent_.closed_flag_.load(std::memory_order_relaxed)) {
+                    HCE_TRACE_METHOD_BODY("send_n","closed");
+                    return true;
+                }
+
+                // the receiver resumes parked senders after it observes this
+                parent_.send_parked_.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if(push_()) {
+                    HCE_TRACE_METHOD_BODY("send_n","done");
+                    parent_.send_parked_.store(false, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                    if(parent_.recv_parked_.load(std::memory_order_relaxed)) {
+                        parent_.resume_recv_();
+                    }
+
+                    return true;
+                }
+
+                HCE_TRACE_METHOD_BODY("send_n","blocked");
+                parent_.parked_send_.push_back(this);
+                return false;
+            }
+        }
+
+        inline void on_resume(void* m) {
+            HCE_MIN_METHOD_ENTER("on_resume",m);
+
+            // m is the channel, which the receiver made room in
+            if(m) [[likely]] { push_(); }
+        }
+
+        inline size_t get_result() { 
+            HCE_MIN_METHOD_BODY("get_result",count_);
+            return count_; 
+        }
+
+    private:
+        // push values until the ring is full, returning true if any were
+        inline bool push_() {
+            const size_t count = count_;
+
+            while(!source_->empty() && !parent_.full_()) {
+                parent_.push_(std::move(source_->front()));
+                source_->pop();
+                ++count_;
+            }
+
+            return count_ != count;
+        }
+
+        hce::spinlock lk_;
+        PARENT& parent_;
+        std::unique_ptr<detail::source<T>> source_;
+        size_t count_ = 0;
+    };
+
+    struct recv_n_interface : 
+        public hce::scheduler::reschedule<
+            hce::awaitable::lockable<
+                hce::spinlock,
+                awt_interface<size_t>>>
+    {
+        recv_n_interface(PARENT& p, std::unique_ptr<detail::sink<T>> s) :
+            hce::scheduler::reschedule<
+                hce::awaitable::lockable<
+                    hce::spinlock,
+                    awt_interface<size_t>>>(
+                        lk_,
+                        hce::awaitable::await::policy::defer,
+                        hce::awaitable::resume::policy::lock),
+            parent_(p),
+            sink_(std::move(s))
+        { }
+
+        static inline std::string info_name() {
+            return spsc<T,ALLOCATOR>::info_name() + "::recv_n_interface";
+        };
+
+        inline std::string name() const { return recv_n_interface::info_name(); }
+
+        inline bool on_ready() {
+            if(sink_->full()) [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("recv_n","full");
+                return true;
+            } else if(pop_()) [[likely]] {
+                HCE_TRACE_METHOD_BODY("recv_n","done");
+                parent_.notify_send_();
+                return true;
+            } else [[unlikely]] {
+                std::lock_guard<hce::spinlock> lk(parent_.lk_);
+
+                // the sender resumes parked receivers after it observes this
+                parent_.recv_parked_.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if(pop_()) {
+                    HCE_TRACE_METHOD_BODY("recv_n","done");
+                    parent_.recv_parked_.store(false, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                    if(parent_.send_parked_.load(std::memory_order_relaxed)) {
+                        parent_.resume_send_();
+                    }
+
+                    return true;
+                } else if(parent_.closed_flag_.load(std::memory_order_relaxed)) {
+                    HCE_TRACE_METHOD_BODY("recv_n","closed");
+                    parent_.recv_parked_.store(false, std::memory_order_relaxed);
+                    return true;
+                }
+
+                HCE_TRACE_METHOD_BODY("recv_n","blocked");
+                parent_.parked_recv_.push_back(this);
+                return false;
+            }
+        }
+
+        inline void on_resume(void* m) {
+            HCE_MIN_METHOD_ENTER("on_resume",m);
+
+            if(m) [[likely]] {
+                // m is transfer struct
+                T t;
+                ((detail::transfer*)m)->send(&t);
+                sink_->push(std::move(t));
+                count_ = 1;
+            }
+        }
+
+        inline size_t get_result() { 
+            HCE_MIN_METHOD_BODY("get_result",count_);
+            return count_; 
+        }
+
+    private:
+        // pop values until the ring is empty, returning true if any were
+        inline bool pop_() {
+            const size_t count = count_;
+
+            while(!sink_->full() && !parent_.empty_()) {
+                parent_.pop_(*sink_);
+                ++count_;
+            }
+
+            return count_ != count;
+        }
+
+        hce::spinlock lk_;
+        PARENT& parent_;
+        std::unique_ptr<detail::sink<T>> sink_;
+        size_t count_ = 0;
+    };
+
+    typedef hce::list<detail::parked<hce::awaitable::interface>,ALLOCATOR> PARKED;
+    typedef detail::deadline<hce::spinlock,PARKED,send_interface> timed_send_interface;
+    typedef detail::deadline<hce::spinlock,PARKED,recv_interface> timed_recv_interface;
+    typedef detail::selecting<hce::spinlock,PARKED,send_interface> select_send_interface;
+    typedef detail::selecting<hce::spinlock,PARKED,recv_interface> select_recv_interface;
+
+    inline T* slot_(size_t i) { return (T*)(ring_[i & mask_].data); }
+
+    /*
+     Construct a value in the ring from a parked sender's value. This is 
+     executed by the receiver, so the sender's cache is refreshed.
+     */
+    template <typename U>
+    static inline void push_transfer_(void* destination, void* source) {
+        typedef unqualified<U> V;
+        auto p = (PARENT*)destination;
+        p->push_(std::forward<U>(*((V*)source)));
+        p->head_cache_ = p->head_.load(std::memory_order_relaxed);
+    }
+
+    /*
+     Move a value out of the ring into a parked receiver's value. This is 
+     executed by the sender, so the receiver's cache is refreshed, otherwise 
+     the receiver would observe a cached tail_ behind head_.
+     */
+    static inline void pop_transfer_(void* destination, void* source) {
+        auto p = (PARENT*)source;
+        p->pop_(*((T*)destination));
+        p->tail_cache_ = p->tail_.load(std::memory_order_relaxed);
+    }
+
+    /*
+     Producer side operations. A parked receiver's operations can be executed 
+     by the sender while the receiver is parked, and vice versa, because the 
+     parked side is not accessing the ring or its cache.
+     */
+    inline bool full_() {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+
+        if(tail - head_cache_ < capacity_) [[likely]] { return false; }
+
+        head_cache_ = head_.load(std::memory_order_acquire);
+        return tail - head_cache_ >= capacity_;
+    }
+
+    template <typename U>
+    inline void push_(U&& u) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        new(slot_(tail)) T(std::forward<U>(u));
+        tail_.store(tail + 1, std::memory_order_release);
+    }
+
+    // consumer side operations
+    inline bool empty_() {
+        const size_t head = head_.load(std::memory_order_relaxed);
+
+        if(head != tail_cache_) [[likely]] { return false; }
+
+        tail_cache_ = tail_.load(std::memory_order_acquire);
+        return head == tail_cache_;
+    }
+
+    inline void pop_(T& t) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        T* v = slot_(head);
+        t = std::move(*v);
+        v->~T();
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    inline void pop_(detail::sink<T>& s) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        T* v = slot_(head);
+        s.push(std::move(*v));
+        v->~T();
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    // resume a parked receiver if one exists after a push
+    inline void notify_recv_() {
+        // pairs with the fence of a parking receiver
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if(recv_parked_.load(std::memory_order_relaxed)) [[unlikely]] {
+            std::lock_guard<hce::spinlock> lk(lk_);
+            resume_recv_();
+        }
+    }
+
+    // resume a parked sender if one exists after a pop
+    inline void notify_send_() {
+        // pairs with the fence of a parking sender
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if(send_parked_.load(std::memory_order_relaxed)) [[unlikely]] {
+            std::lock_guard<hce::spinlock> lk(lk_);
+            resume_send_();
+        }
+    }
+
+    /*
+     lk_ must be held. The ring is rechecked because the notified value may 
+     have been received by the receiver before it parked again. Receivers of 
+     claimed selects are dropped.
+     */
+    inline void resume_recv_() {
+        while(parked_recv_.size()) {
+            const size_t head = head_.load(std::memory_order_relaxed);
+
+            if(head == tail_.load(std::memory_order_acquire)) [[unlikely]] { 
+                return; 
+            }
+
+            auto r = parked_recv_.front();
+            parked_recv_.pop();
+
+            if(r.claim() == detail::claimed) [[likely]] {
+                recv_parked_.store(false, std::memory_order_relaxed);
+                detail::transfer tx(&PARENT::pop_transfer_, this);
+                r->resume((void*)&tx);
+                return;
+            }
+        }
+
+        // a timed out or dropped receiver left the flag set
+        recv_parked_.store(false, std::memory_order_relaxed);
+    }
+
+    // lk_ must be held, see resume_recv_()
+    inline void resume_send_() {
+        while(parked_send_.size()) {
+            const size_t tail = tail_.load(std::memory_order_relaxed);
+
+            if(tail - head_.load(std::memory_order_acquire) >= capacity_) [[unlikely]] { 
+                return; 
+            }
+
+            auto s = parked_send_.front();
+            parked_send_.pop();
+
+            if(s.claim() == detail::claimed) [[likely]] {
+                send_parked_.store(false, std::memory_order_relaxed);
+                s->resume((void*)this);
+                return;
+            }
+        }
+
+        // a timed out or dropped sender left the flag set
+        send_parked_.store(false, std::memory_order_relaxed);
+    }
+
+    template <typename U>
+    inline hce::yield<result> try_send_(U&& s) {
+        if(closed_flag_.load(std::memory_order_acquire)) [[unlikely]] { 
+            HCE_TRACE_METHOD_BODY("try_send","closed");
+            return { result::closed }; 
+        } else if(!full_()) [[likely]] {
+            HCE_TRACE_METHOD_BODY("try_send","done");
+            push_(std::forward<U>(s));
+            notify_recv_();
+            return { result::success }; 
+        } else [[unlikely]] { 
+            HCE_TRACE_METHOD_BODY("try_send","failed");
+            return { result::failure }; 
+        }
+    }
+
+    // consumer cache line
+    alignas(hce::cache_line_size) std::atomic<size_t> head_{0};
+    size_t tail_cache_ = 0; // the consumer's last observed tail_
+
+    // producer cache line
+    alignas(hce::cache_line_size) std::atomic<size_t> tail_{0};
+    size_t head_cache_ = 0; // the producer's last observed head_
+
+    // slow path state, only written when closing or parking
+    alignas(hce::cache_line_size) std::atomic<bool> closed_flag_{false};
+    std::atomic<bool> send_parked_{false};
+    std::atomic<bool> recv_parked_{false};
+    mutable hce::spinlock lk_;
+    PARKED parked_send_;
+    PARKED parked_recv_;
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<storage[]> ring_;
+};
+
+/**
+ @brief bounded multi producer, multi consumer interface implementation
+
+ Values are stored in a fixed size ring of sequenced cells (Dmitry Vyukov's 
+ bounded MPMC queue). Senders and receivers claim a cell with a single 
+ compare-and-swap on a cache line padded counter, so no lock is acquired while 
+ the ring is neither full nor empty. A lock guarding the parked operations is 
+ only acquired by an operation which finds the ring full or empty, and by the 
+ opposite side when it observes that operations are parked.
+
+ The capacity is rounded up to a power of 2, with a minimum of 2. Parked 
+ operations are completed in order, but an operation which finds room in the 
+ ring can complete before previously parked operations.
+
+ Like `buffered`, receives succeed after `close()` as long as values are 
+ available in the ring.
+ */
+template <typename T, typename ALLOCATOR=hce::pool_allocator<T>>
+struct mpmc : public interface<T> {
+    typedef T value_type;
+
+    using interface<T>::send;
+    using interface<T>::recv;
+    using interface<T>::send_n;
+    using interface<T>::recv_n;
+
+private:
+    struct send_interface;
+    struct recv_interface;
+
+public:
+    /// awaitable returned by `embedded_send()`
+    typedef hce::awaitable::embedded<send_interface> send_awaitable;
+
+    /// awaitable returned by `embedded_recv()`
+    typedef hce::awaitable::embedded<recv_interface> recv_awaitable;
+
+    mpmc(int sz) : 
+        mask_(detail::ring_size(sz > 2 ? (size_t)sz : (size_t)2) - 1),
+        ring_(new cell[mask_ + 1])
+    { 
+        HCE_LOW_CONSTRUCTOR();
+        init_();
+    }
+
+    mpmc(int sz, const ALLOCATOR& allocator) : 
+        parked_send_(allocator),
+        parked_recv_(allocator),
+        mask_(detail::ring_size(sz > 2 ? (size_t)sz : (size_t)2) - 1),
+        ring_(new cell[mask_ + 1])
+    { 
+        HCE_LOW_CONSTRUCTOR();
+        init_();
+    }
+
+    mpmc(const mpmc<T,ALLOCATOR>&) = delete;
+    mpmc(mpmc<T,ALLOCATOR>&&) = delete;
+
+    inline virtual ~mpmc(){ 
+        HCE_LOW_DESTRUCTOR(); 
+
+        // destroy any values remaining in the ring
+        const size_t tail = enqueue_pos_.load(std::memory_order_acquire);
+
+        for(size_t i = dequeue_pos_.load(std::memory_order_relaxed); 
+            i != tail; 
+            ++i) 
+        {
+            cell& c = ring_[i & mask_];
+
+            if(c.sequence.load(std::memory_order_acquire) == i + 1) {
+                ((T*)(c.data))->~T();
+            }
+        }
+    }
+
+    mpmc<T,ALLOCATOR>& operator=(const mpmc<T,ALLOCATOR>&) = delete;
+    mpmc<T,ALLOCATOR>& operator=(mpmc<T,ALLOCATOR>&&) = delete;
+
+    static inline std::string info_name() { 
+        return type::templatize<T,ALLOCATOR>("hce::channel::mpmc"); 
+    }
+
+    inline std::string name() const { 
+        return mpmc<T,ALLOCATOR>::info_name(); 
+    }
+
+    inline const std::type_info& type_info() const {
+        HCE_TRACE_METHOD_ENTER("type_info");
+        return typeid(mpmc<T,ALLOCATOR>); 
+    }
+
+    inline int size() const {
+        HCE_MIN_METHOD_ENTER("size");
+        return (int)(mask_ + 1);
+    }
+
+    inline int used() const {
+        HCE_MIN_METHOD_ENTER("used");
+        const size_t head = dequeue_pos_.load(std::memory_order_acquire);
+        const size_t tail = enqueue_pos_.load(std::memory_order_acquire);
+
+        // claimed cells are counted even if their values are not yet written
+        return tail > head ? (int)std::min(tail - head, mask_ + 1) : 0;
+    }
+
+    inline bool closed() const {
+        HCE_MIN_METHOD_ENTER("closed");
+        return closed_flag_.load(std::memory_order_acquire);
+    }
+
+    inline void close() {
+        HCE_LOW_METHOD_ENTER("close");
+
+        std::lock_guard<hce::spinlock> lk(lk_);
+
+        if(!closed_flag_.load(std::memory_order_relaxed)) [[likely]] {
+            closed_flag_.store(true, std::memory_order_release);
+
+            while(detail::claim_front(parked_send_)) { 
+                parked_send_.front()->wake(nullptr); 
+                parked_send_.pop();
+            }
+
+            while(detail::claim_front(parked_recv_)) { 
+                parked_recv_.front()->wake(nullptr); 
+                parked_recv_.pop();
+            }
+
+            send_waiters_.store(0, std::memory_order_relaxed);
+            recv_waiters_.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    inline awt<bool> send(const T& s) {
+        HCE_LOW_METHOD_ENTER("send",(void*)&s);
+
+        return hce::awt<bool>(new send_interface(
+            *this, detail::transfer(&PARENT::template push_transfer_<const T&>,(void*)&s)));
+    }
+
+    inline awt<bool> send(T&& s) {
+        HCE_LOW_METHOD_ENTER("send",(void*)&s);
+
+        return hce::awt<bool>(new send_interface(
+            *this, detail::transfer(&PARENT::template push_transfer_<T&&>,(void*)&s)));
+    }
+
+    inline awt<bool> recv(T& r) {
+        HCE_LOW_METHOD_ENTER("recv",(void*)&r);
+
+        return hce::awt<bool>(new recv_interface(*this, (void*)&r));
+    }
+
+    /// see `unbuffered::embedded_send()`
+    inline send_awaitable embedded_send(const T& s) {
+        HCE_LOW_METHOD_ENTER("embedded_send",(void*)&s);
+        return send_awaitable(
+            *this,
+            detail::transfer(&PARENT::template push_transfer_<const T&>,(void*)&s));
+    }
+
+    /// see `unbuffered::embedded_send()`
+    inline send_awaitable embedded_send(T&& s) {
+        HCE_LOW_METHOD_ENTER("embedded_send",(void*)&s);
+        return send_awaitable(
+            *this,
+            detail::transfer(&PARENT::template push_transfer_<T&&>,(void*)&s));
+    }
+
+    /// see `unbuffered::embedded_recv()`
+    inline recv_awaitable embedded_recv(T& r) {
+        HCE_LOW_METHOD_ENTER("embedded_recv",(void*)&r);
+        return recv_awaitable(*this, (void*)&r);
+    }
+
+    inline awt<bool> send(
+            const T& s, 
+            const hce::chrono::time_point& timeout) {
+        HCE_LOW_METHOD_ENTER("send",(void*)&s,timeout);
+
+        return hce::awt<bool>(new timed_send_interface(
+            lk_, 
+            parked_send_, 
+            timeout,
+            *this, 
+            detail::transfer(&PARENT::template push_transfer_<const T&>,(void*)&s)));
+    }
+
+    inline awt<bool> send(T&& s, const hce::chrono::time_point& timeout) {
+        HCE_LOW_METHOD_ENTER("send",(void*)&s,timeout);
+
+        return hce::awt<bool>(new timed_send_interface(
+            lk_, 
+            parked_send_, 
+            timeout,
+            *this, 
+            detail::transfer(&PARENT::template push_transfer_<T&&>,(void*)&s)));
+    }
+
+    inline awt<bool> recv(T& r, const hce::chrono::time_point& timeout) {
+        HCE_LOW_METHOD_ENTER("recv",(void*)&r,timeout);
+
+        return hce::awt<bool>(new timed_recv_interface(
+            lk_, 
+            parked_recv_, 
+            timeout,
+            *this, 
+            (void*)&r));
+    }
+
+    inline hce::yield<result> try_send(const T& t) {
+        HCE_LOW_METHOD_ENTER("try_send",(void*)&t);
+        return try_send_(t);
+    }
+
+    inline hce::yield<result> try_send(T&& t) {
+        HCE_LOW_METHOD_ENTER("try_send",(void*)&t);
+        return try_send_(std::move(t));
+    }
+
+    inline hce::yield<result> try_recv(T& r) {
+        HCE_LOW_METHOD_ENTER("try_recv",(void*)&r);
+
+        if(try_pop_(r)) [[likely]] {
+            HCE_TRACE_METHOD_BODY("try_recv","done");
+            notify_send_();
+            return { result::success }; 
+        } else if(closed_flag_.load(std::memory_order_acquire)) {
+            // a value may have been sent before the close
+            if(try_pop_(r)) [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("try_recv","done");
+                return { result::success }; 
+            }
+
+            HCE_TRACE_METHOD_BODY("try_recv","closed");
+            return { result::closed }; 
+        } else [[unlikely]] {
+            HCE_TRACE_METHOD_BODY("try_recv","failed");
+            return { result::failure }; 
+        }
+    }
+
+    inline awt<size_t> send_n(std::unique_ptr<detail::source<T>> s) {
+        HCE_LOW_METHOD_ENTER("send_n");
+        return hce::awt<size_t>(new send_n_interface(*this, std::move(s)));
+    }
+
+    inline awt<size_t> recv_n(std::unique_ptr<detail::sink<T>> s) {
+        HCE_LOW_METHOD_ENTER("recv_n");
+        return hce::awt<size_t>(new recv_n_interface(*this, std::move(s)));
+    }
+
+    inline std::unique_ptr<detail::select_case> select_send(
+            const T& s, 
+            detail::selector& sel, 
+            size_t index) {
+        HCE_LOW_METHOD_ENTER("select_send",(void*)&s,index);
+
+        return std::unique_ptr<detail::select_case>(new select_send_interface(
+            lk_, 
+            parked_send_, 
+            sel,
+            index,
+            *this, 
+            detail::transfer(&PARENT::template push_transfer_<const T&>,(void*)&s)));
+    }
+
+    inline std::unique_ptr<detail::select_case> select_send(
+            T&& s, 
+            detail::selector& sel, 
+            size_t index) {
+        HCE_LOW_METHOD_ENTER("select_send",(void*)&s,index);
+
+        return std::unique_ptr<detail::select_case>(new select_send_interface(
+            lk_, 
+            parked_send_, 
+            sel,
+            index,
+            *this, 
+            detail::transfer(&PARENT::template push_transfer_<T&&>,(void*)&s)));
+    }
+
+    inline std::unique_ptr<detail::select_case> select_recv(
+            T& r, 
+            detail::selector& sel, 
+            size_t index) {
+        HCE_LOW_METHOD_ENTER("select_recv",(void*)&r,index);
+
+        return std::unique_ptr<detail::select_case>(new select_recv_interface(
+            lk_, 
+            parked_recv_, 
+            sel,
+            index,
+            *this, 
+            (void*)&r));
+    }
+
+private:
+    typedef mpmc<T,ALLOCATOR> PARENT;
+
+    // a ring cell, whose sequence determines whether it can be written or read
+    struct cell {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    // destination of a push_transfer_()
+    struct push_attempt {
+        PARENT* parent;
+        bool success;
+    };
+
+    /*
+     Parked operations are completed against the ring by the resumer before 
+     they are resumed, because another operation may claim the available cells 
+     first. The select of a parked operation, if any, is only claimed if the 
+     operation completes.
+     */
+    struct parked_send {
+        virtual ~parked_send(){}
+
+        /// attempt to push the operation's values, returning true on success
+        virtual bool push(PARENT& p) = 0;
+
+        /// resume the operation 
+        virtual void wake(void* m) = 0;
+    };
+
+    struct parked_recv {
+        virtual ~parked_recv(){}
+
+        /// attempt to pop the operation's values, returning true on success
+        virtual bool pop(PARENT& p) = 0;
+
+        /// resume the operation 
+        virtual void wake(void* m) = 0;
+    };
+
+    /*
+     The operations lock their own lock rather than the channel's, which is 
+     only acquired when parking or resuming a parked operation.
+     */
+    struct send_interface : 
+        public hce::scheduler::reschedule<
+            hce::awaitable::lockable<
+                hce::spinlock,
+                awt_interface<bool>>>,
+        public parked_send,
+        public detail::selectable
+    {
+        send_interface(PARENT& p, detail::transfer tx) :
+            hce::scheduler::reschedule<
+                hce::awaitable::lockable<
+                    hce::spinlock,
+                    awt_interface<bool>>>(
+                        lk_,
+                        hce::awaitable::await::policy::defer,
+                        hce::awaitable::resume::policy::lock),
+            parent_(p),
+            tx_(tx)
+        { }
+
+        static inline std::string info_name() {
+            return mpmc<T,ALLOCATOR>::info_name() + "::send_interface";
+        };
+
+        inline std::string name() const { return send_interface::info_name(); }
+
+        inline bool on_ready() {
+            if(parent_.closed_flag_.load(std::memory_order_acquire)) [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("send","closed");
+                this->fail();
+                return true;
+            } else if(this->attempt([&]{ return parent_.push_(tx_); })) [[likely]] {
+                HCE_TRACE_METHOD_BODY("send","done");
+                success_ = true;
+                parent_.notify_recv_();
+                this->notify();
+                return true;
+            } else [[unlikely]] {
+                std::lock_guard<hce::spinlock> lk(parent_.lk_);
+
+                if(parent_.closed_flag_.load(std::memory_order_relaxed)) {
+                    HCE_TRACE_METHOD_BODY("send","closed");
+                    this->fail();
+                    return true;
+                }
+
+                // receivers resume parked senders after they observe this
+                parent_.send_waiters_.store(
+                    parent_.parked_send_.size() + 1, 
+                    std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if(this->attempt([&]{ return parent_.push_(tx_); })) {
+                    HCE_TRACE_METHOD_BODY("send","done");
+                    parent_.send_waiters_.store(
+                        parent_.parked_send_.size(), 
+                        std::memory_order_relaxed);
+                    success_ = true;
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                    if(parent_.recv_waiters_.load(std::memory_order_relaxed)) {
+                        parent_.resume_recv_();
+                    }
+
+                    this->notify();
+                    return true;
+                }
+
+                HCE_TRACE_METHOD_BODY("send","blocked");
+                parent_.parked_send_.push_back({ this, this->sel });
+                return false;
+            }
+        }
+
+        inline void on_resume(void* m) {
+            HCE_MIN_METHOD_ENTER("on_resume",m);
+
+            // the value was pushed by the resumer if m is not null 
+            if(m) [[likely]] { success_ = true; }
+            this->notify();
+        }
+
+        inline bool get_result() { 
+            HCE_MIN_METHOD_BODY("get_result",success_);
+            return success_; 
+        }
+
+        inline bool push(PARENT& p) { return p.push_(tx_); }
+        inline void wake(void* m) { this->resume(m); }
+
+    private:
+        hce::spinlock lk_;
+        PARENT& parent_;
+        detail::transfer tx_;
+        bool success_ = false;
+    };
+
+    struct recv_interface : 
+        public hce::scheduler::reschedule<
+            hce::awaitable::lockable<
+                hce::spinlock,
+                awt_interface<bool>>>,
+        public parked_recv,
+        public detail::selectable
+    {
+        recv_interface(PARENT& p, void* destination) :
+            hce::scheduler::reschedule<
+                hce::awaitable::lockable<
+                    hce::spinlock,
+                    awt_interface<bool>>>(
+                        lk_,
+                        hce::awaitable::await::policy::defer,
+                        hce::awaitable::resume::policy::lock),
+            parent_(p),
+            destination_ptr_(destination)
+        { }
+
+        static inline std::string info_name() {
+            return mpmc<T,ALLOCATOR>::info_name() + "::recv_interface";
+        };
+
+        inline std::string name() const { return recv_interface::info_name(); }
+
+        inline bool on_ready() {
+            if(this->attempt([&]{ return parent_.try_pop_(destination_()); })) [[likely]] {
+                HCE_TRACE_METHOD_BODY("recv","done");
+                success_ = true;
+                parent_.notify_send_();
+                this->notify();
+                return true;
+            } else [[unlikely]] {
+                std::lock_guard<hce::spinlock> lk(parent_.lk_);
+
+                // senders resume parked receivers after they observe this
+                parent_.recv_waiters_.store(
+                    parent_.parked_recv_.size() + 1, 
+                    std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if(this->attempt([&]{ return parent_.try_pop_(destination_()); })) {
+                    HCE_TRACE_METHOD_BODY("recv","done");
+                    parent_.recv_waiters_.store(
+                        parent_.parked_recv_.size(), 
+                        std::memory_order_relaxed);
+                    success_ = true;
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                    if(parent_.send_waiters_.load(std::memory_order_relaxed)) {
+                        parent_.resume_send_();
+                    }
+
+                    this->notify();
+                    return true;
+                } else if(parent_.closed_flag_.load(std::memory_order_relaxed)) {
+                    HCE_TRACE_METHOD_BODY("recv","closed");
+                    parent_.recv_waiters_.store(
+                        parent_.parked_recv_.size(), 
+                        std::memory_order_relaxed);
+                    this->fail();
+                    return true;
+                }
+
+                HCE_TRACE_METHOD_BODY("recv","blocked");
+                parent_.parked_recv_.push_back({ this, this->sel });
+                return false;
+            }
+        }
+
+        inline void on_resume(void* m) {
+            HCE_TRACE_METHOD_BODY("on_resume",m);
+
+            // the value was popped by the resumer if m is not null 
+            if(m) [[likely]] { success_ = true; }
+            this->notify();
+        }
+
+        inline bool get_result() { 
+            HCE_MIN_METHOD_BODY("get_result",success_);
+            return success_; 
+        }
+
+        inline bool pop(PARENT& p) { return p.try_pop_(destination_()); }
+        inline void wake(void* m) { this->resume(m); }
+
+    private:
+        inline T& destination_() { return *((T*)destination_ptr_); }
+
+        hce::spinlock lk_;
+        PARENT& parent_;
+        void* destination_ptr_;
+        bool success_ = false;
+    };
+
+    struct send_n_interface : 
+        public hce::scheduler::reschedule<
+            hce::awaitable::lockable<
+                hce::spinlock,
+                awt_interface<size_t>>>,
+        public parked_send
+    {
+        send_n_interface(PARENT& p, std::unique_ptr<detail::source<T>> s) :
+            hce::scheduler::reschedule<
+                hce::awaitable::lockable<
+                    hce::spinlock,
+                    awt_interface<size_t>>>(
+                        lk_,
+                        hce::awaitable::await::policy::defer,
+                        hce::awaitable::resume::policy::lock),
+            parent_(p),
+            source_(std::move(s))
+        { }
+
+        static inline std::string info_name() {
+            return mpmc<T,ALLOCATOR>::info_name() + "::send_n_interface";
+        };
+
+        inline std::string name() const { return send_n_interface::info_name(); }
+
+        inline bool on_ready() {
+            if(parent_.closed_flag_.load(std::memory_order_acquire) || 
+               source_->empty()) [[unlikely]] 
+            {
+                HCE_TRACE_METHOD_BODY("send_n","closed or empty");
+                return true;
+            } else if(push(parent_)) [[likely]] {
+                HCE_TRACE_METHOD_BODY("send_n","done");
+                parent_.notify_recv_();
+                return true;
+            } else [[unlikely]] {
+                std::lock_guard<hce::spinlock> lk(parent_.lk_);
+
+                if(parent_.closed_flag_.load(std::memory_order_relaxed)) {
+                    HCE_TRACE_METHOD_BODY("send_n","closed");
+                    return true;
+                }
+
+                // receivers resume parked senders after they observe this
+                parent_.send_waiters_.store(
+                    parent_.parked_send_.size() + 1, 
+                    std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if(push(parent_)) {
+                    HCE_TRACE_METHOD_BODY("send_n","done");
+                    parent_.send_waiters_.store(
+                        parent_.parked_send_.size(), 
+                        std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                    if(parent_.recv_waiters_.load(std::memory_order_relaxed)) {
+                        parent_.resume_recv_();
+                    }
+
+                    return true;
+                }
+
+                HCE_TRACE_METHOD_BODY("send_n","blocked");
+                parent_.parked_send_.push_back(this);
+                return false;
+            }
+        }
+
+        // the values were pushed by the resumer
+        inline void on_resume(void* m) { }
+
+        inline size_t get_result() { 
+            HCE_MIN_METHOD_BODY("get_result",count_);
+            return count_; 
+        }
+
+        // push values until the ring is full
+        inline bool push(PARENT& p) {
+            const size_t count = count_;
+
+            while(!source_->empty() && p.try_push_(std::move(source_->front()))) {
+                source_->pop();
+                ++count_;
+            }
+
+            return count_ != count;
+        }
+
+        inline void wake(void* m) { this->resume(m); }
+
+    private:
+        hce::spinlock lk_;
+        PARENT& parent_;
+        std::unique_ptr<detail::source<T>> source_;
+        size_t count_ = 0;
+    };
+
+    struct recv_n_interface : 
+        public hce::scheduler::reschedule<
+            hce::awaitable::lockable<
+                hce::spinlock,
+                awt_interface<size_t>>>,
+        public parked_recv
+    {
+        recv_n_interface(PARENT& p, std::unique_ptr<detail::sink<T>> s) :
+            hce::scheduler::reschedule<
+                hce::awaitable::lockable<
+                    hce::spinlock,
+                    awt_interface<size_t>>>(
+                        lk_,
+                        hce::awaitable::await::policy::defer,
+                        hce::awaitable::resume::policy::lock),
+            parent_(p),
+            sink_(std::move(s))
+        { }
+
+        static inline std::string info_name() {
+            return mpmc<T,ALLOCATOR>::info_name() + "::recv_n_interface";
+        };
+
+        inline std::string name() const { return recv_n_interface::info_name(); }
+
+        inline bool on_ready() {
+            if(sink_->full()) [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("recv_n","full");
+                return true;
+            } else if(pop(parent_)) [[likely]] {
+                HCE_TRACE_METHOD_BODY("recv_n","done");
+                parent_.notify_send_();
+                return true;
+            } else [[unlikely]] {
+                std::lock_guard<hce::spinlock> lk(parent_.lk_);
+
+                // senders resume parked receivers after they observe this
+                parent_.recv_waiters_.store(
+                    parent_.parked_recv_.size() + 1, 
+                    std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if(pop(parent_)) {
+                    HCE_TRACE_METHOD_BODY("recv_n","done");
+                    parent_.recv_waiters_.store(
+                        parent_.parked_recv_.size(), 
+                        std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                    if(parent_.send_waiters_.load(std::memory_order_relaxed)) {
+                        parent_.resume_send_();
+                    }
+
+                    return true;
+                } else if(parent_.closed_flag_.load(std::memory_order_relaxed)) {
+                    HCE_TRACE_METHOD_BODY("recv_n","closed");
+                    parent_.recv_waiters_.store(
+                        parent_.parked_recv_.size(), 
+                        std::memory_order_relaxed);
+                    return true;
+                }
+
+                HCE_TRACE_METHOD_BODY("recv_n","blocked");
+                parent_.parked_recv_.push_back(this);
+                return false;
+            }
+        }
+
+        // the values were popped by the resumer
+        inline void on_resume(void* m) { }
+
+        inline size_t get_result() { 
+            HCE_MIN_METHOD_BODY("get_result",count_);
+            return count_; 
+        }
+
+        // pop values until the ring is empty
+        inline bool pop(PARENT& p) {
+            const size_t count = count_;
+
+            while(!sink_->full() && p.try_pop_(*sink_)) { ++count_; }
+
+            return count_ != count;
+        }
+
+        inline void wake(void* m) { this->resume(m); }
+
+    private:
+        hce::spinlock lk_;
+        PARENT& parent_;
+        std::unique_ptr<detail::sink<T>> sink_;
+        size_t count_ = 0;
+    };
+
+    typedef hce::list<detail::parked<parked_send>,ALLOCATOR> SEND_PARKED;
+    typedef hce::list<detail::parked<parked_recv>,ALLOCATOR> RECV_PARKED;
+    typedef detail::deadline<hce::spinlock,SEND_PARKED,send_interface> timed_send_interface;
+    typedef detail::deadline<hce::spinlock,RECV_PARKED,recv_interface> timed_recv_interface;
+    typedef detail::selecting<hce::spinlock,SEND_PARKED,send_interface> select_send_interface;
+    typedef detail::selecting<hce::spinlock,RECV_PARKED,recv_interface> select_recv_interface;
+
+    inline void init_() {
+        for(size_t i = 0; i <= mask_; ++i) {
+            ring_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // attempt to construct a value in the ring from a sender's value
+    template <typename U>
+    static inline void push_transfer_(void* destination, void* source) {
+        typedef unqualified<U> V;
+        auto a = (push_attempt*)destination;
+        a->success = a->parent->try_push_(std::forward<U>(*((V*)source)));
+    }
+
+    // attempt to push the value of a transfer
+    inline bool push_(detail::transfer& tx) {
+        push_attempt a{this, false};
+        tx.send(&a);
+        return a.success;
+    }
+
+    template <typename U>
+    inline bool try_push_(U&& u) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        cell* c;
+
+        while(true) {
+            c = &(ring_[pos & mask_]);
+            const size_t seq = c->sequence.load(std::memory_order_acquire);
+            const intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+
+            if(dif == 0) [[likely]] {
+                // on failure pos is updated to the current value
+                if(enqueue_pos_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) [[likely]] {
+                    break;
+                }
+            } else if(dif < 0) {
+                // the cell has not been read since the previous lap: full
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        new(c->data) T(std::forward<U>(u));
+        c->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    inline bool try_pop_(T& t) {
+        return try_pop_([&](T&& v){ t = std::move(v); });
+    }
+
+    inline bool try_pop_(detail::sink<T>& s) {
+        return try_pop_([&](T&& v){ s.push(std::move(v)); });
+    }
+
+    // pop a value, passing it to an assignment function
+    template <typename ASSIGN>
+    inline bool try_pop_(ASSIGN&& assign) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        cell* c;
+
+        while(true) {
+            c = &(ring_[pos & mask_]);
+            const size_t seq = c->sequence.load(std::memory_order_acquire);
+            const intptr_t dif = (intptr_t)seq - (intptr_t)(pos + 1);
+
+            if(dif == 0) [[likely]] {
+                if(dequeue_pos_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) [[likely]] {
+                    break;
+                }
+            } else if(dif < 0) {
+                // the cell has not been written in this lap: empty
+                return false;
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        T* v = (T*)(c->data);
+        assign(std::move(*v));
+        v->~T();
+
+        // make the cell writable in the next lap
+        c->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    // resume parked receivers if any exist after a push
+    inline void notify_recv_() {
+        // pairs with the fence of a parking receiver
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if(recv_waiters_.load(std::memory_order_relaxed)) [[unlikely]] {
+            std::lock_guard<hce::spinlock> lk(lk_);
+            resume_recv_();
+        }
+    }
+
+    // resume parked senders if any exist after a pop
+    inline void notify_send_() {
+        // pairs with the fence of a parking sender
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if(send_waiters_.load(std::memory_order_relaxed)) [[unlikely]] {
+            std::lock_guard<hce::spinlock> lk(lk_);
+            resume_send_();
+        }
+    }
+
+    /*
+     lk_ must be held. Parked receivers are completed until the ring is empty, 
+     which may be immediately if the values were received by operations which 
+     did not park. Receivers of claimed selects are dropped.
+     */
+    inline void resume_recv_() {
+        while(parked_recv_.size()) {
+            auto r = parked_recv_.front();
+
+            if(!r.acquire()) [[unlikely]] {
+                parked_recv_.pop();
+                continue;
+            } else if(!r->pop(*this)) { 
+                r.release();
+                break; 
+            }
+
+            r.commit();
+            parked_recv_.pop();
+            r->wake((void*)this);
+        }
+
+        // also corrects the count after a parked receiver times out
+        recv_waiters_.store(parked_recv_.size(), std::memory_order_relaxed);
+    }
+
+    // lk_ must be held, see resume_recv_()
+    inline void resume_send_() {
+        while(parked_send_.size()) {
+            auto s = parked_send_.front();
+
+            if(!s.acquire()) [[unlikely]] {
+                parked_send_.pop();
+                continue;
+            } else if(!s->push(*this)) { 
+                s.release();
+                break; 
+            }
+
+            s.commit();
+            parked_send_.pop();
+            s->wake((void*)this);
+        }
+
+        // also corrects the count after a parked sender times out
+        send_waiters_.store(parked_send_.size(), std::memory_order_relaxed);
+    }
+
+    template <typename U>
+    inline hce::yield<result> try_send_(U&& s) {
+        if(closed_flag_.load(std::memory_order_acquire)) [[unlikely]] { 
+            HCE_TRACE_METHOD_BODY("try_send","closed");
+            return { result::closed }; 
+        } else if(try_push_(std::forward<U>(s))) [[likely]] {
+            HCE_TRACE_METHOD_BODY("try_send","done");
+            notify_recv_();
+            return { result::success }; 
+        } else [[unlikely]] { 
+            HCE_TRACE_METHOD_BODY("try_send","failed");
+            return { result::failure }; 
+        }
+    }
+
+    // sender cache line
+    alignas(hce::cache_line_size) std::atomic<size_t> enqueue_pos_{0};
+
+    // receiver cache line
+    alignas(hce::cache_line_size) std::atomic<size_t> dequeue_pos_{0};
+
+    // slow path state, counts are only written while lk_ is held
+    alignas(hce::cache_line_size) std::atomic<bool> closed_flag_{false};
+    std::atomic<size_t> send_waiters_{0};
+    std::atomic<size_t> recv_waiters_{0};
+    mutable hce::spinlock lk_;
+    SEND_PARKED parked_send_;
+    RECV_PARKED parked_recv_;
+
+    const size_t mask_;
+    std::unique_ptr<cell[]> ring_;
+};
+
+}
+
+/** 
+ @brief communication object which can represent any object which implements channel::interface<T>
+
+ This object is essentially a sanitized 
+ `std::shared_ptr<hce::channel::interface<T>>`, with helper construction 
+ functions and convenience operators. Its also convient because of its short 
+ name/namespace and direct method access, allowing it to be easily used and 
+ passed around in coroutines without added template complexity or memory 
+ indirection considerations (no `*` or `->` operator usage). Just make copies of 
+ an instantiated `hce::chan<T>` and call its methods directly.
+
+ It's useful to point out that implementations of `hce::channel::interface<T>` 
  can actually be used without this shim if desired. An example of using channel 
  implementations directly would be to manage their allocated memory in an 
  `std::unique_ptr<hce::channel::interface<T>>` (or even direct construction) 
@@ -970,6 +4137,9 @@ template <typename T>
 struct chan : public channel::interface<T> {
     typedef T value_type;
 
+    using channel::interface<T>::send_n;
+    using channel::interface<T>::recv_n;
+
     chan() = default;
     chan(const chan<T>& rhs) = default;
     chan(chan<T>&& rhs) = default;
@@ -1066,6 +4236,41 @@ struct chan : public channel::interface<T> {
         ch.construct<LOCK,ALLOCATOR>(std::forward<As>(as)...);
         return ch;
     }
+
+    /**
+     @brief construct a chan's context with a specific implementation
+
+     This allows for selecting implementations which `construct(sz)` does not, 
+     such as `hce::channel::spsc`:
+     ```
+     hce::chan<int> ch;
+     ch.construct<hce::channel::spsc>(64);
+     ```
+
+     @param as arguments for the IMPL<T> constructor
+     */
+    template <template <typename...> class IMPL, typename... As>
+    inline chan<T>& construct(As&&... as) {
+        HCE_MIN_METHOD_ENTER("construct",as...);
+
+        context_ = std::shared_ptr<channel::interface<T>>(
+            static_cast<channel::interface<T>*>(
+                new IMPL<T>(std::forward<As>(as)...)));
+
+        return *this;
+    }
+
+    /**
+     @brief inline construct a new chan<T> with a specific implementation
+     @return the constructed chan<T>
+     */
+    template <template <typename...> class IMPL, typename... As>
+    inline static chan<T> make(As&&... as) {
+        HCE_MIN_FUNCTION_ENTER(chan<T>::info_name() + "::make", as...);
+        chan<T> ch;
+        ch.construct<IMPL>(std::forward<As>(as)...);
+        return ch;
+    }
        
     inline const std::type_info& type_info() const {
         HCE_TRACE_METHOD_ENTER("type_info");
@@ -1107,6 +4312,42 @@ struct chan : public channel::interface<T> {
         return context_->recv(r); 
     }
 
+    inline hce::awt<bool> send(
+            T&& s, 
+            const hce::chrono::time_point& timeout) {
+        HCE_MIN_METHOD_ENTER("send",timeout);
+        return context_->send(std::move(s), timeout); 
+    }
+
+    inline hce::awt<bool> send(
+            const T& s, 
+            const hce::chrono::time_point& timeout) {
+        HCE_MIN_METHOD_ENTER("send",timeout);
+        return context_->send(s, timeout); 
+    }
+
+    inline hce::awt<bool> recv(
+            T& r, 
+            const hce::chrono::time_point& timeout) {
+        HCE_MIN_METHOD_ENTER("recv",timeout);
+        return context_->recv(r, timeout); 
+    }
+
+    inline hce::awt<bool> send(T&& s, const hce::chrono::duration& dur) {
+        HCE_MIN_METHOD_ENTER("send",dur);
+        return context_->send(std::move(s), hce::chrono::now() + dur); 
+    }
+
+    inline hce::awt<bool> send(const T& s, const hce::chrono::duration& dur) {
+        HCE_MIN_METHOD_ENTER("send",dur);
+        return context_->send(s, hce::chrono::now() + dur); 
+    }
+
+    inline hce::awt<bool> recv(T& r, const hce::chrono::duration& dur) {
+        HCE_MIN_METHOD_ENTER("recv",dur);
+        return context_->recv(r, hce::chrono::now() + dur); 
+    }
+
     inline hce::yield<channel::result> try_send(const T& s) {
         HCE_MIN_METHOD_ENTER("try_send");
         return context_->try_send(s);
@@ -1122,10 +4363,484 @@ struct chan : public channel::interface<T> {
         return context_->try_recv(r);
     }
 
+    inline hce::awt<size_t> send_n(
+            std::unique_ptr<channel::detail::source<T>> s) {
+        HCE_MIN_METHOD_ENTER("send_n");
+        return context_->send_n(std::move(s));
+    }
+
+    inline hce::awt<size_t> recv_n(
+            std::unique_ptr<channel::detail::sink<T>> s) {
+        HCE_MIN_METHOD_ENTER("recv_n");
+        return context_->recv_n(std::move(s));
+    }
+
+    inline std::unique_ptr<channel::detail::select_case> select_send(
+            const T& s,
+            channel::detail::selector& sel,
+            size_t index) {
+        HCE_MIN_METHOD_ENTER("select_send");
+        return context_->select_send(s, sel, index);
+    }
+
+    inline std::unique_ptr<channel::detail::select_case> select_send(
+            T&& s,
+            channel::detail::selector& sel,
+            size_t index) {
+        HCE_MIN_METHOD_ENTER("select_send");
+        return context_->select_send(std::move(s), sel, index);
+    }
+
+    inline std::unique_ptr<channel::detail::select_case> select_recv(
+            T& r,
+            channel::detail::selector& sel,
+            size_t index) {
+        HCE_MIN_METHOD_ENTER("select_recv");
+        return context_->select_recv(r, sel, index);
+    }
+
 private:
     std::shared_ptr<channel::interface<T>> context_;
 };
 
+namespace channel {
+namespace detail {
+
+/// a channel implementation with an intrusive reference count
+template <typename IMPLEMENTATION>
+struct counted : public IMPLEMENTATION {
+    template <typename... As>
+    counted(As&&... as) : IMPLEMENTATION(std::forward<As>(as)...) { }
+
+    /// add a reference
+    inline void acquire() { 
+        references_.fetch_add(1, std::memory_order_relaxed); 
+    }
+
+    /// remove a reference, deleting the channel if it was the last
+    static inline void release(counted<IMPLEMENTATION>* c) {
+        if(c->references_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete c;
+        }
+    }
+
+private:
+    std::atomic<size_t> references_{1};
+};
+
+}
+}
+
+/**
+ @brief communication object which dispatches statically to a channel implementation
+
+ `hce::chan<T>` calls its implementation through a shared pointer and virtual 
+ methods. When the implementation is known at compile time, 
+ `hce::typed_chan<IMPLEMENTATION>` calls it directly instead:
+ ```
+ auto ch = hce::typed_chan<hce::channel::spsc<int>>::make(64);
+ ```
+
+ Copies share the implementation through an intrusive reference count, which 
+ is cheaper than the control block of an `std::shared_ptr`. `send()` and 
+ `recv()` return the implementation's embedded awaitables (see 
+ `hce::channel::unbuffered::embedded_send()`), which are not allocated and 
+ must be `co_await`ed (or converted to `bool` by a thread) where they are 
+ returned.
+
+ A `typed_chan` converts to an `hce::chan<T>` sharing the same implementation 
+ when type erasure is needed, such as when it is passed to code written for 
+ `hce::chan<T>`.
+ */
+template <typename IMPLEMENTATION>
+struct typed_chan : public printable {
+    typedef typename IMPLEMENTATION::value_type value_type;
+    typedef IMPLEMENTATION implementation_type;
+    typedef typename IMPLEMENTATION::send_awaitable send_awaitable;
+    typedef typename IMPLEMENTATION::recv_awaitable recv_awaitable;
+
+    typed_chan() = default;
+
+    typed_chan(const typed_chan<IMPLEMENTATION>& rhs) : context_(rhs.context_) {
+        if(context_) { context_->acquire(); }
+    }
+
+    typed_chan(typed_chan<IMPLEMENTATION>&& rhs) : context_(rhs.context_) {
+        rhs.context_ = nullptr;
+    }
+
+    inline virtual ~typed_chan(){ reset_(); }
+
+    inline typed_chan<IMPLEMENTATION>& operator=(
+            const typed_chan<IMPLEMENTATION>& rhs) {
+        if(context_ != rhs.context_) [[likely]] {
+            reset_();
+            context_ = rhs.context_;
+            if(context_) { context_->acquire(); }
+        }
+
+        return *this;
+    }
+
+    inline typed_chan<IMPLEMENTATION>& operator=(
+            typed_chan<IMPLEMENTATION>&& rhs) {
+        if(this != &rhs) [[likely]] {
+            reset_();
+            context_ = rhs.context_;
+            rhs.context_ = nullptr;
+        }
+
+        return *this;
+    }
+
+    static inline std::string info_name() { 
+        return type::templatize<IMPLEMENTATION>("hce::typed_chan"); 
+    }
+
+    inline std::string name() const { return typed_chan<IMPLEMENTATION>::info_name(); }
+
+    inline std::string content() const { 
+        std::stringstream ss;
+        ss << (void*)context_;
+        return ss.str();
+    }
+
+    /// return a reference to the shared implementation
+    inline IMPLEMENTATION& context() { return *context_; }
+
+    /// return whether channel has an allocated implementation
+    inline explicit operator bool() const {
+        HCE_TRACE_METHOD_ENTER("operator bool");
+        return (bool)(context_); 
+    }
+
+    /**
+     @brief construct a new shared implementation
+     @param as arguments for the IMPLEMENTATION constructor
+     */
+    template <typename... As>
+    inline typed_chan<IMPLEMENTATION>& construct(As&&... as) {
+        HCE_MIN_METHOD_ENTER("construct",as...);
+        reset_();
+        context_ = new channel::detail::counted<IMPLEMENTATION>(
+            std::forward<As>(as)...);
+        return *this;
+    }
+
+    /**
+     @brief inline construct a new typed_chan and its implementation
+     @return the constructed typed_chan
+     */
+    template <typename... As>
+    inline static typed_chan<IMPLEMENTATION> make(As&&... as) {
+        HCE_MIN_FUNCTION_ENTER(
+            typed_chan<IMPLEMENTATION>::info_name() + "::make", 
+            as...);
+        typed_chan<IMPLEMENTATION> ch;
+        ch.construct(std::forward<As>(as)...);
+        return ch;
+    }
+
+    /**
+     @brief convert to an `hce::chan<T>` sharing the implementation
+
+     The returned `hce::chan<T>` holds a reference to the implementation, 
+     which is deleted when neither it nor any typed_chan refers to it.
+     */
+    inline operator hce::chan<value_type>() const {
+        HCE_MIN_METHOD_ENTER("operator hce::chan<T>");
+        hce::chan<value_type> ch;
+
+        if(context_) [[likely]] {
+            context_->acquire();
+            ch.context() = std::shared_ptr<channel::interface<value_type>>(
+                static_cast<channel::interface<value_type>*>(context_),
+                [c=context_](channel::interface<value_type>*) {
+                    channel::detail::counted<IMPLEMENTATION>::release(c);
+                });
+        }
+
+        return ch;
+    }
+
+    inline const std::type_info& type_info() const {
+        HCE_TRACE_METHOD_ENTER("type_info");
+        return context_->IMPLEMENTATION::type_info(); 
+    }
+
+    inline int size() const {
+        HCE_TRACE_METHOD_ENTER("size");
+        return context_->IMPLEMENTATION::size(); 
+    }
+
+    inline int used() const {
+        HCE_TRACE_METHOD_ENTER("used");
+        return context_->IMPLEMENTATION::used(); 
+    }
+
+    inline bool closed() const {
+        HCE_TRACE_METHOD_ENTER("closed");
+        return context_->IMPLEMENTATION::closed(); 
+    }
+
+    inline void close() {
+        HCE_MIN_METHOD_ENTER("close");
+        return context_->IMPLEMENTATION::close(); 
+    }
+
+    inline send_awaitable send(value_type&& s) {
+        HCE_MIN_METHOD_ENTER("send");
+        return context_->embedded_send(std::move(s)); 
+    }
+
+    inline send_awaitable send(const value_type& s) {
+        HCE_MIN_METHOD_ENTER("send");
+        return context_->embedded_send(s); 
+    }
+
+    inline recv_awaitable recv(value_type& r) {
+        HCE_MIN_METHOD_ENTER("recv");
+        return context_->embedded_recv(r); 
+    }
+
+    inline hce::awt<bool> send(
+            value_type&& s, 
+            const hce::chrono::time_point& timeout) {
+        HCE_MIN_METHOD_ENTER("send",timeout);
+        return context_->IMPLEMENTATION::send(std::move(s), timeout); 
+    }
+
+    inline hce::awt<bool> send(
+            const value_type& s, 
+            const hce::chrono::time_point& timeout) {
+        HCE_MIN_METHOD_ENTER("send",timeout);
+        return context_->IMPLEMENTATION::send(s, timeout); 
+    }
+
+    inline hce::awt<bool> recv(
+            value_type& r, 
+            const hce::chrono::time_point& timeout) {
+        HCE_MIN_METHOD_ENTER("recv",timeout);
+        return context_->IMPLEMENTATION::recv(r, timeout); 
+    }
+
+    inline hce::awt<bool> send(
+            value_type&& s, 
+            const hce::chrono::duration& dur) {
+        return send(std::move(s), hce::chrono::now() + dur);
+    }
+
+    inline hce::awt<bool> send(
+            const value_type& s, 
+            const hce::chrono::duration& dur) {
+        return send(s, hce::chrono::now() + dur);
+    }
+
+    inline hce::awt<bool> recv(
+            value_type& r, 
+            const hce::chrono::duration& dur) {
+        return recv(r, hce::chrono::now() + dur);
+    }
+
+    inline hce::yield<channel::result> try_send(value_type&& s) {
+        HCE_MIN_METHOD_ENTER("try_send");
+        return context_->IMPLEMENTATION::try_send(std::move(s)); 
+    }
+
+    inline hce::yield<channel::result> try_send(const value_type& s) {
+        HCE_MIN_METHOD_ENTER("try_send");
+        return context_->IMPLEMENTATION::try_send(s); 
+    }
+
+    inline hce::yield<channel::result> try_recv(value_type& r) {
+        HCE_MIN_METHOD_ENTER("try_recv");
+        return context_->IMPLEMENTATION::try_recv(r); 
+    }
+
+    /// see `hce::channel::interface::send_n()`
+    template <typename IT>
+    inline hce::awt<size_t> send_n(IT first, IT last) {
+        HCE_MIN_METHOD_ENTER("send_n");
+        return context_->IMPLEMENTATION::send_n(
+            std::unique_ptr<channel::detail::source<value_type>>(
+                new channel::detail::iterator_source<value_type,IT>(
+                    std::move(first), 
+                    std::move(last))));
+    }
+
+    /// see `hce::channel::interface::recv_n()`
+    template <typename IT>
+    inline hce::awt<size_t> recv_n(IT out, size_t max) {
+        HCE_MIN_METHOD_ENTER("recv_n");
+        return context_->IMPLEMENTATION::recv_n(
+            std::unique_ptr<channel::detail::sink<value_type>>(
+                new channel::detail::iterator_sink<value_type,IT>(
+                    std::move(out), 
+                    max)));
+    }
+
+private:
+    inline void reset_() {
+        if(context_) { 
+            channel::detail::counted<IMPLEMENTATION>::release(context_); 
+            context_ = nullptr;
+        }
+    }
+
+    channel::detail::counted<IMPLEMENTATION>* context_ = nullptr;
+};
+
+namespace channel {
+
+/**
+ @brief receiver which drains a channel in batches
+
+ A reader receives up to `batch_size` values at once with 
+ `hce::chan<T>::recv_n()`, then returns them one at a time from a local batch:
+ ```
+ hce::channel::reader<int> r(ch);
+ int i;
+
+ while(co_await r.recv(i)) {
+     // use i
+ }
+ ```
+
+ While the batch holds values `recv()` completes without suspending, locking 
+ the channel or allocating. Only when the batch is empty does it receive a 
+ new batch, which suspends if the channel is empty. The awaitable returned by 
+ `recv()` returns false when the channel is closed and every value has been 
+ received.
+
+ Values remain in the reader's batch until they are received from it, so a 
+ reader should be the only receiver of its values. `T` must be default 
+ constructible.
+ */
+template <typename T>
+struct reader : public printable {
+    typedef T value_type;
+
+    /// awaitable returned by `recv()`
+    struct recv_awaitable : public printable {
+        recv_awaitable(reader<T>& r, T& t) : r_(r), t_(t) { }
+        recv_awaitable(const recv_awaitable&) = delete;
+        recv_awaitable(recv_awaitable&&) = delete;
+
+        virtual ~recv_awaitable(){ }
+
+        recv_awaitable& operator=(const recv_awaitable&) = delete;
+        recv_awaitable& operator=(recv_awaitable&&) = delete;
+
+        static inline std::string info_name() {
+            return reader<T>::info_name() + "::recv_awaitable";
+        }
+
+        inline std::string name() const { return recv_awaitable::info_name(); }
+
+        inline bool await_ready() {
+            if(r_.index_ < r_.count_) [[likely]] {
+                return true;
+            } else [[unlikely]] {
+                HCE_MIN_METHOD_BODY("await_ready","receiving batch");
+                refill_ = r_.ch_.recv_n(r_.batch_.begin(), r_.batch_.size());
+                return refill_.await_ready();
+            }
+        }
+
+        inline void await_suspend(std::coroutine_handle<> h) { 
+            refill_.await_suspend(h); 
+        }
+
+        inline bool await_resume() {
+            if(refill_.valid()) [[unlikely]] {
+                r_.index_ = 0;
+                r_.count_ = refill_.await_resume();
+                refill_ = hce::awt<size_t>();
+            }
+
+            if(r_.index_ < r_.count_) [[likely]] {
+                t_ = std::move(r_.batch_[r_.index_]);
+                ++(r_.index_);
+                return true;
+            } else [[unlikely]] {
+                return false;
+            }
+        }
+
+        /// inline conversion for use in threads where `co_await` isn't called
+        inline operator bool() {
+            if(coroutine::in()) [[unlikely]] { 
+                std::stringstream ss;
+                ss << hce::coroutine::local()
+                   << "did not call co_await on "
+                   << *this;
+                HCE_FATAL_LOG("%s",ss.str().c_str());
+                std::terminate();
+            }
+
+            if(!await_ready()) { await_suspend(std::coroutine_handle<>()); }
+            return await_resume();
+        }
+
+    private:
+        reader<T>& r_;
+        T& t_;
+        hce::awt<size_t> refill_;
+    };
+
+    /**
+     @param ch the channel to receive from
+     @param batch_size the maximum count of values received at once
+     */
+    reader(hce::chan<T> ch, size_t batch_size=64) : 
+        ch_(std::move(ch)),
+        batch_(batch_size ? batch_size : 1)
+    { 
+        HCE_MIN_CONSTRUCTOR(batch_size);
+    }
+
+    reader(const reader<T>&) = delete;
+    reader(reader<T>&&) = default;
+
+    virtual ~reader(){ HCE_MIN_DESTRUCTOR(); }
+
+    reader<T>& operator=(const reader<T>&) = delete;
+    reader<T>& operator=(reader<T>&&) = default;
+
+    static inline std::string info_name() { 
+        return type::templatize<T>("hce::channel::reader"); 
+    }
+
+    inline std::string name() const { return reader<T>::info_name(); }
+
+    inline std::string content() const {
+        std::stringstream ss;
+        ss << ch_ << ", batched:" << (count_ - index_);
+        return ss.str();
+    }
+
+    /// return the count of received values remaining in the batch
+    inline size_t batched() const { return count_ - index_; }
+
+    /**
+     @brief receive the next value
+     @param t the destination of the received value
+     @return an awaitable returning true on success, else false if the channel is closed and empty
+     */
+    inline recv_awaitable recv(T& t) {
+        HCE_TRACE_METHOD_ENTER("recv",(void*)&t);
+        return recv_awaitable(*this, t);
+    }
+
+private:
+    hce::chan<T> ch_;
+    std::vector<T> batch_;
+    size_t index_ = 0; // index of the next value in the batch
+    size_t count_ = 0; // count of values in the batch
+};
+
+}
+
 }
 
 #endif
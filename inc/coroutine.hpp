@@ -971,6 +971,79 @@ struct awaitable : public printable {
         bool locked_; // track locked state
     };
 
+    /**
+     @brief awaitable which embeds its implementation instead of allocating it
+
+     An `hce::awt<T>` owns an allocated implementation so that it can be moved 
+     and type erased. When the concrete implementation type is known this 
+     object can be returned by value instead, constructing the implementation 
+     in place. When `co_await`ed the implementation then lives in the awaiting 
+     coroutine's frame, and when used by a thread it lives on the thread's 
+     stack, so no allocation is required in either case.
+
+     Because the implementation may be referenced by other operations while it 
+     is suspended this object can be neither copied nor moved, so it must be 
+     `co_await`ed (or converted to its result by a thread) where it is 
+     returned. Otherwise it behaves like an `hce::awt<T>`.
+     */
+    template <typename IMPLEMENTATION>
+    struct embedded : public printable {
+        typedef decltype(std::declval<IMPLEMENTATION&>().get_result()) value_type;
+
+        template <typename... As>
+        embedded(As&&... as) : impl_(std::forward<As>(as)...) { 
+            HCE_TRACE_CONSTRUCTOR();
+        }
+
+        embedded(const embedded<IMPLEMENTATION>&) = delete;
+        embedded(embedded<IMPLEMENTATION>&&) = delete;
+
+        virtual ~embedded() {
+            HCE_TRACE_DESTRUCTOR();
+            awaitable::wait_(*this, impl_);
+        }
+
+        embedded<IMPLEMENTATION>& operator=(const embedded<IMPLEMENTATION>&) = delete;
+        embedded<IMPLEMENTATION>& operator=(embedded<IMPLEMENTATION>&&) = delete;
+
+        static inline std::string info_name() { 
+            return "hce::awaitable::embedded"; 
+        }
+
+        inline std::string name() const { return embedded::info_name(); }
+        inline std::string content() const { return impl_.to_string(); }
+
+        /// return the underlying implementation
+        inline IMPLEMENTATION& implementation() { return impl_; }
+
+        inline bool await_ready() { return impl_.await_ready(); }
+
+        inline void await_suspend(std::coroutine_handle<> h) { 
+            impl_.await_suspend(h); 
+        }
+
+        inline value_type await_resume() { 
+            HCE_MIN_METHOD_ENTER("await_resume");
+            return impl_.get_result(); 
+        }
+
+        /// block until the operation is complete, see `awaitable::wait()`
+        inline void wait() { 
+            HCE_MIN_METHOD_ENTER("wait");
+            awaitable::wait_(*this, impl_); 
+        }
+
+        /// inline conversion for use in threads where `co_await` isn't called
+        inline operator value_type() {
+            HCE_MIN_METHOD_ENTER("operator value_type");
+            wait();
+            return await_resume();
+        }
+
+    private:
+        IMPLEMENTATION impl_;
+    };
+
     awaitable() : impl_(nullptr) {
         HCE_TRACE_CONSTRUCTOR();
     }
@@ -1046,27 +1119,8 @@ struct awaitable : public printable {
      */
     inline void wait() {
         HCE_MIN_METHOD_ENTER("wait");
-        if(impl_ && !(impl_->awaited())) [[unlikely]] {
-            if(coroutine::in()) [[unlikely]] { 
-                // coroutine failed to `co_await` the awaitable
-                std::stringstream ss;
-                ss << hce::coroutine::local()
-                   << "did not call co_await on "
-                   << *this;
-                HCE_FATAL_METHOD_BODY("wait",ss.str());
-                std::terminate();
-            } else if(!await_ready()) [[likely]] { 
-                HCE_TRACE_METHOD_BODY("wait","thread");
-                // if we're here, this awaitable is operating without the 
-                // `co_await` keyword, and needs to operate as a regular system 
-                // thread blocking call, not a coroutine suspend.
-                await_suspend(std::coroutine_handle<>()); 
-            } else {
-                HCE_TRACE_METHOD_BODY("wait","thread done");
-            }
-        } else {
-            HCE_TRACE_METHOD_BODY("wait","nothing to do");
-        }
+        if(impl_) [[likely]] { wait_(*this, *impl_); }
+        else { HCE_TRACE_METHOD_BODY("wait","nothing to do"); }
     }
 
 protected:
@@ -1083,6 +1137,34 @@ protected:
     { }
 
 private:
+    /*
+     Block the calling thread until an implementation which was not awaited 
+     completes. The owner is only used for logging.
+     */
+    static inline void wait_(const printable& owner, interface& i) {
+        if(!(i.awaited())) [[unlikely]] {
+            if(coroutine::in()) [[unlikely]] { 
+                // coroutine failed to `co_await` the awaitable
+                std::stringstream ss;
+                ss << hce::coroutine::local()
+                   << "did not call co_await on "
+                   << owner;
+                HCE_FATAL_FUNCTION_BODY("hce::awaitable::wait",ss.str());
+                std::terminate();
+            } else if(!i.await_ready()) [[likely]] { 
+                HCE_TRACE_FUNCTION_BODY("hce::awaitable::wait","thread");
+                // if we're here, this awaitable is operating without the 
+                // `co_await` keyword, and needs to operate as a regular system 
+                // thread blocking call, not a coroutine suspend.
+                i.await_suspend(std::coroutine_handle<>()); 
+            } else {
+                HCE_TRACE_FUNCTION_BODY("hce::awaitable::wait","thread done");
+            }
+        } else {
+            HCE_TRACE_FUNCTION_BODY("hce::awaitable::wait","nothing to do");
+        }
+    }
+
     struct interface_deleter {
         inline void operator()(interface* ptr) const noexcept {
             ptr->~interface(); // call destructor
@@ -13,14 +13,20 @@
 #include "chrono.hpp"
 #include "circular_buffer.hpp"
 #include "list.hpp"
+#include "segmented_queue.hpp"
 #include "synchronized_list.hpp"
 #include "coroutine.hpp"
 #include "scheduler.hpp"
 #include "blocking.hpp"
 #include "timer.hpp"
+#include "io.hpp"
+#include "net.hpp"
 //#include "mutex.hpp"
 //#include "condition_variable.hpp"
 #include "channel.hpp"
+#include "select.hpp"
+#include "broadcast.hpp"
+#include "slot_chan.hpp"
 #include "scope.hpp"
 #include "threadpool.hpp"
 #include "lifecycle.hpp"
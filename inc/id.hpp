@@ -5,6 +5,8 @@
 
 #include <memory>
 #include <cstddef>
+#include <cstdint>
+#include <atomic>
 #include <string>
 #include <sstream>
 
@@ -12,12 +14,28 @@
 #include "alloc.hpp"
 
 namespace hce {
+namespace detail {
+namespace id {
+
+/**
+ @return a new process-wide unique, non-zero, 64-bit identifier value
+
+ Values are generated from a counter rather than by allocating memory. A 64-bit 
+ counter will not wrap around within the lifetime of any realistic process.
+ */
+inline std::uint64_t make() {
+    static std::atomic<std::uint64_t> counter(0);
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+}
+}
 
 /**
  @brief identifier object interface
 
- Rerpresents an arbitrary unique identifying memory address. The address of this 
- memory is usable as a container key.
+ Represents an arbitrary unique 64-bit identifier value. An unconstructed id 
+ has the value `0`. The value is usable as a container key.
  */
 struct id : public printable {
     inline std::string content() const {
@@ -37,9 +55,9 @@ struct id : public printable {
     virtual void reset() = 0;
 
     /**
-     @return the allocated id pointer
+     @return the id value, or `0` if the id is not constructed
      */
-    virtual void* get() const = 0;
+    virtual std::uint64_t get() const = 0;
 
     /**
      @return true if the id represents a constructed id, else false
@@ -77,30 +95,38 @@ struct id : public printable {
 struct uid : public id {
     uid() { HCE_TRACE_CONSTRUCTOR(); }
     uid(const uid&) = delete;
-    uid(uid&&) = default;
+    uid(uid&& rhs) : value_(rhs.value_) { rhs.value_ = 0; }
 
     virtual ~uid() { HCE_TRACE_DESTRUCTOR(); }
 
     uid& operator=(const uid&) = delete;
-    uid& operator=(uid&&) = default;
+
+    uid& operator=(uid&& rhs) {
+        if(this != &rhs) [[likely]] {
+            value_ = rhs.value_;
+            rhs.value_ = 0;
+        }
+
+        return *this;
+    }
 
     static inline std::string info_name() { return "hce::uid"; }
     inline std::string name() const { return uid::info_name(); }
 
     inline void make() {
         HCE_TRACE_METHOD_ENTER("make");
-        byte_ = hce::make_unique<std::byte>();
+        value_ = hce::detail::id::make();
     }
 
     inline void reset() {
         HCE_TRACE_METHOD_ENTER("reset");
-        byte_.reset();
+        value_ = 0;
     }
 
-    inline void* get() const { return byte_.get(); }
+    inline std::uint64_t get() const { return value_; }
 
 private:
-    hce::unique_ptr<std::byte> byte_;
+    std::uint64_t value_ = 0;
 };
 
 /**
@@ -123,18 +149,18 @@ struct sid : public id {
 
     inline void make() {
         HCE_TRACE_METHOD_ENTER("make");
-        byte_ = hce::make_shared<std::byte>();
+        value_ = hce::detail::id::make();
     }
 
     inline void reset() {
         HCE_TRACE_METHOD_ENTER("reset");
-        byte_.reset();
+        value_ = 0;
     }
 
-    inline void* get() const { return byte_.get(); }
+    inline std::uint64_t get() const { return value_; }
 
 private:
-    std::shared_ptr<std::byte> byte_;
+    std::uint64_t value_ = 0;
 };
 
 }
@@ -0,0 +1,475 @@
+//SPDX-License-Identifier: MIT
+//Author: Blayne Dennis
+#ifndef HERMES_COROUTINE_ENGINE_IO
+#define HERMES_COROUTINE_ENGINE_IO
+
+#include <sys/types.h>
+
+#include <memory>
+#include <string>
+#include <sstream>
+#include <optional>
+#include <type_traits>
+
+#include "base.hpp"
+#include "logging.hpp"
+#include "coroutine.hpp"
+#include "scheduler.hpp"
+#include "blocking.hpp"
+
+namespace hce {
+namespace config {
+namespace io {
+
+/// strategies the io service can use to execute file operations
+enum backend {
+    /**
+     Operations execute as `hce::block()` calls, occupying a blocking worker
+     thread for each outstanding operation. Available on all platforms.
+     */
+    blocking = 0,
+
+    /**
+     Operations are submitted to a Linux `io_uring` instance and their
+     completions are delivered to awaiting coroutines by a single completion
+     thread, so any count of outstanding operations requires no additional
+     threads. Falls back to blocking on other platforms or if the kernel does
+     not support the required `io_uring` operations.
+     */
+    io_uring = 1
+};
+
+/**
+ @return the strategy the io service should use to execute file operations
+ */
+hce::config::io::backend service_backend();
+
+/**
+ @return the requested count of `io_uring` submission queue entries
+ */
+size_t io_uring_entries();
+
+}
+}
+
+namespace io {
+
+struct service;
+
+/**
+ @brief await a file descriptor becoming readable
+
+ When called by a coroutine executing on a scheduler with a reactor (see 
+ `hce::config::scheduler::config::reactor`), the descriptor is registered 
+ with the scheduler's `epoll` reactor and the awaiting coroutine is resumed 
+ directly by the scheduler when the descriptor is ready. Otherwise, the 
+ readiness is awaited with a `poll()` inside of `hce::block()`.
+
+ Only one coroutine can await each direction of a descriptor on a scheduler 
+ at a time. A descriptor must be passed to `hce::io::cancel()` before it is 
+ closed while it may be awaited. 
+ Errors and hangups are reported as readiness, so the following system call 
+ on the descriptor returns the condition.
+
+ @param fd a file descriptor, usually non-blocking
+ @return an awaitable returning 0 when the descriptor is readable, or a negative errno
+ */
+hce::awt<int> readable(int fd);
+
+/**
+ @brief await a file descriptor becoming writable
+
+ Behaves like `hce::io::readable()`.
+
+ @param fd a file descriptor, usually non-blocking
+ @return an awaitable returning 0 when the descriptor is writable, or a negative errno
+ */
+hce::awt<int> writable(int fd);
+
+/**
+ @brief cancel every readiness wait on a file descriptor before closing it
+
+ `epoll` silently forgets closed descriptors, so a coroutine awaiting a 
+ descriptor which is closed would never be resumed. This removes the 
+ descriptor from the reactor of the calling thread's scheduler, resuming 
+ awaiting coroutines with `-ECANCELED`. It must be called on the scheduler 
+ thread of the awaiting coroutines, and does nothing if the calling thread's 
+ scheduler has no reactor.
+
+ `hce::io::file`, `hce::net::stream` and `hce::net::listener` call this when 
+ they close their descriptors.
+
+ @param fd a file descriptor which is about to be closed
+ */
+void cancel(int fd);
+
+/**
+ @brief transfer file data to a descriptor without copying it through user space
+
+ Transfers up to count bytes from in_fd, starting at offset, to out_fd with 
+ the `sendfile()` system call. Whenever out_fd would block, the operation 
+ awaits its writability like `hce::io::writable()` and then continues, so 
+ out_fd should be non-blocking when called by a coroutine. 
+
+ Like `write()`, if an error occurs after some bytes were transferred the 
+ count of bytes transferred is returned, and the error is returned by the 
+ next call. Transferring to a closed socket raises `SIGPIPE` unless the 
+ process ignores it.
+
+ Unsupported platforms return `-ENOSYS`.
+
+ @param out_fd the destination, usually a socket
+ @param in_fd the source, which must support `mmap()`, usually a regular file
+ @param offset the offset of in_fd to transfer from, which is not modified
+ @param count the count of bytes to transfer
+ @return an awaitable returning the count of bytes transferred, which is less than count at the end of in_fd or if an error occurred after some bytes were transferred, else a negative errno
+ */
+hce::awt<ssize_t> sendfile(int out_fd, int in_fd, off_t offset, size_t count);
+
+/**
+ @brief move data between descriptors without copying it through user space
+
+ Moves up to count bytes from in_fd to out_fd with the `splice()` system 
+ call, at least one of which must be a pipe. Whenever the operation would 
+ block, it awaits the readability of in_fd or the writability of out_fd, 
+ whichever is not ready, and then continues. Pipes are always operated on 
+ without blocking, other descriptors should be non-blocking when called by a 
+ coroutine.
+
+ Like `write()`, if an error occurs after some bytes were moved the count of 
+ bytes moved is returned, and the error is returned by the next call. Moving 
+ to a pipe or socket whose reader has closed raises `SIGPIPE` unless the 
+ process ignores it.
+
+ Unsupported platforms return `-ENOSYS`.
+
+ @param in_fd the source
+ @param in_offset the offset of in_fd to move from, or -1 to use its current position, which is required for pipes and sockets
+ @param out_fd the destination
+ @param out_offset the offset of out_fd to move to, or -1 to use its current position, which is required for pipes and sockets
+ @param count the count of bytes to move
+ @return an awaitable returning the count of bytes moved, which is less than count at the end of in_fd or if an error occurred after some bytes were moved, else a negative errno
+ */
+hce::awt<ssize_t> splice(int in_fd, 
+                         off_t in_offset, 
+                         int out_fd, 
+                         off_t out_offset, 
+                         size_t count);
+
+namespace detail {
+
+// operations complete across thread boundaries so they require a lock
+template <typename T>
+struct operation_partial :
+    public hce::awaitable::lockable<
+        hce::spinlock,
+        hce::awt_interface<T>>
+{
+    operation_partial() :
+        hce::awaitable::lockable<
+            hce::spinlock,
+            hce::awt_interface<T>>(
+                lk_,
+                hce::awaitable::await::policy::defer,
+                hce::awaitable::resume::policy::lock),
+        ready_(false)
+    { }
+
+    inline bool on_ready() { return ready_; }
+
+    // the result is emplaced before resume()
+    inline void on_resume(void* m) { ready_ = true; }
+
+    inline T get_result() { return std::move(*t_); }
+
+protected:
+    std::optional<T> t_;
+
+private:
+    hce::spinlock lk_;
+    bool ready_;
+};
+
+// the descriptor and direction an operation awaits when it would block
+struct readiness {
+    int fd;
+    bool write;
+};
+
+/*
+ An operation which is attempted immediately and then retried by the 
+ scheduler's thread each time its reactor reports the awaited descriptor 
+ ready. 
+
+ The Attempt returns an empty optional when the operation would block. It is 
+ invoked either with no arguments or with a `readiness&`, which it can update 
+ to select the descriptor to await. Failures are constructed as `T(-errno)`.
+ */
+template <typename T, typename Attempt>
+struct ready_operation : 
+    public hce::scheduler::reschedule<operation_partial<T>> 
+{
+    ready_operation(readiness r, Attempt&& attempt) :
+        r_(r),
+        attempt_(std::move(attempt))
+    {
+        HCE_MED_CONSTRUCTOR();
+        c_.complete = &ready_operation<T,Attempt>::complete_;
+        c_.ctx = this;
+    }
+
+    virtual ~ready_operation() { HCE_MED_DESTRUCTOR(); }
+
+    static inline std::string info_name() {
+        return type::templatize<T>("hce::io::detail::ready_operation");
+    }
+
+    inline std::string name() const { 
+        return ready_operation<T,Attempt>::info_name(); 
+    }
+
+    // attempt the operation, awaiting readiness if it would block
+    inline void step() {
+        std::optional<T> t = ready_operation<T,Attempt>::attempt(
+            attempt_, r_);
+
+        if(t) [[likely]] {
+            finish_(std::move(*t));
+        } else {
+            int err = hce::detail::scheduler::reactor_register(
+                r_.fd, r_.write, &c_);
+
+            if(err) [[unlikely]] { finish_(T(-err)); }
+        }
+    }
+
+    // invoke an Attempt with or without the readiness
+    static inline std::optional<T> attempt(Attempt& a, readiness& r) {
+        if constexpr (std::is_invocable_v<Attempt&, readiness&>) {
+            return a(r);
+        } else {
+            return a();
+        }
+    }
+
+private:
+    inline void finish_(T&& t) {
+        this->t_.emplace(std::move(t));
+        this->resume(nullptr);
+    }
+
+    static inline void complete_(void* ctx, int res) {
+        auto o = static_cast<ready_operation<T,Attempt>*>(ctx);
+
+        if(res < 0) [[unlikely]] {
+            o->finish_(T(res));
+        } else [[likely]] {
+            o->step();
+        }
+    }
+
+    readiness r_;
+    Attempt attempt_;
+    hce::detail::scheduler::completion c_;
+};
+
+/*
+ Perform an operation on a descriptor which may block. Coroutines on a 
+ scheduler with a reactor (the global and threadpool schedulers by default, see 
+ `HCESCHEDULERREACTOR`) suspend while the operation would block. Everything 
+ else executes the operation with hce::block(), polling for readiness, which 
+ occupies a blocking worker for as long as the descriptor is not ready.
+ */
+template <typename T, typename Attempt>
+hce::awt<T> perform(readiness r, Attempt attempt) {
+    if(hce::scheduler::in() && hce::scheduler::local().reactor()) [[likely]] {
+        auto op = new ready_operation<T,Attempt>(r, std::move(attempt));
+        hce::awt<T> awt(op);
+        op->step();
+        return awt;
+    }
+
+    return hce::block([=]() mutable -> T {
+        while(true) {
+            std::optional<T> t = ready_operation<T,Attempt>::attempt(
+                attempt, r);
+
+            if(t) [[likely]] { return std::move(*t); }
+
+            // outside of a scheduler this polls on the calling thread
+            int err = r.write 
+                ? (int)hce::io::writable(r.fd) 
+                : (int)hce::io::readable(r.fd);
+
+            if(err) [[unlikely]] { return T(err); }
+        }
+    });
+}
+
+}
+
+/**
+ @brief an owned file descriptor with awaitable operations
+
+ Operations return awaitables which can be `co_await`ed by coroutines or
+ assigned to a result by threads, in which case the calling thread blocks
+ until the operation completes. Like the underlying system calls, operations
+ return a negative `errno` value on failure.
+
+ Buffers passed to `read()` and `write()` must remain valid until the
+ returned awaitable completes.
+
+ The descriptor is closed synchronously when the `file` is destroyed, unless
+ ownership has been given up with `release()`.
+ */
+struct file : public printable {
+    file() = default;
+
+    /// take ownership of a file descriptor
+    explicit file(int fd) : fd_(fd < 0 ? -1 : fd), error_(fd < 0 ? -fd : 0) { }
+
+    file(const file&) = delete;
+
+    file(file&& rhs) : fd_(rhs.fd_), error_(rhs.error_) {
+        rhs.fd_ = -1;
+    }
+
+    virtual ~file() { close(); }
+
+    file& operator=(const file&) = delete;
+
+    inline file& operator=(file&& rhs) {
+        if(this != &rhs) [[likely]] {
+            close();
+            fd_ = rhs.fd_;
+            error_ = rhs.error_;
+            rhs.fd_ = -1;
+        }
+
+        return *this;
+    }
+
+    static inline std::string info_name() { return "hce::io::file"; }
+    inline std::string name() const { return file::info_name(); }
+
+    inline std::string content() const {
+        std::stringstream ss;
+        ss << "fd:" << fd_;
+        return ss.str();
+    }
+
+    /**
+     @brief open a file relative to a directory file descriptor
+     @param dirfd a directory file descriptor or `AT_FDCWD`
+     @param path the path to open, copied into the operation
+     @param flags `open()` flags
+     @param mode permissions of a created file
+     @return an awaitable returning the opened file, which is invalid with `error()` set on failure
+     */
+    static hce::awt<file> openat(int dirfd,
+                                 std::string path,
+                                 int flags,
+                                 mode_t mode = 0);
+
+    /**
+     @brief open a file relative to the current working directory
+     @return an awaitable returning the opened file, which is invalid with `error()` set on failure
+     */
+    static hce::awt<file> open(std::string path, int flags, mode_t mode = 0);
+
+    /**
+     @brief read from the file at an offset
+     @param buf the destination buffer
+     @param len the maximum count of bytes to read
+     @param offset the file offset to read from
+     @return an awaitable returning the count of bytes read or a negative errno
+     */
+    hce::awt<ssize_t> read(void* buf, size_t len, off_t offset);
+
+    /**
+     @brief write to the file at an offset
+     @param buf the source buffer
+     @param len the count of bytes to write
+     @param offset the file offset to write to
+     @return an awaitable returning the count of bytes written or a negative errno
+     */
+    hce::awt<ssize_t> write(const void* buf, size_t len, off_t offset);
+
+    /**
+     @brief flush the file's data and metadata to storage
+     @return an awaitable returning 0 or a negative errno
+     */
+    hce::awt<int> fsync();
+
+    /// return the file descriptor, or -1 if the file is invalid
+    inline int fd() const { return fd_; }
+
+    /// return the errno of the failed open, or 0
+    inline int error() const { return error_; }
+
+    /// return whether the file holds an open file descriptor
+    inline explicit operator bool() const { return fd_ >= 0; }
+
+    /// give up ownership of the file descriptor and return it
+    inline int release() {
+        int fd = fd_;
+        fd_ = -1;
+        return fd;
+    }
+
+    /// synchronously close the file descriptor
+    void close();
+
+private:
+    int fd_ = -1;
+    int error_ = 0;
+};
+
+/**
+ @brief singleton service executing asynchronous file operations
+
+ When the `io_uring` backend is available, operations from every thread are
+ submitted to a single `io_uring` instance. A dedicated completion thread
+ waits for completions and resumes the awaiting coroutines on their
+ schedulers. Otherwise, operations are executed with `hce::block()`.
+ */
+struct service : public printable {
+    static inline std::string info_name() { return "hce::io::service"; }
+    inline std::string name() const { return service::info_name(); }
+
+    /// return the process-wide io service
+    static inline service& get() { return *(service::instance_); }
+
+    /// return the backend executing file operations
+    hce::config::io::backend backend() const;
+
+    /// return the count of operations submitted to io_uring awaiting completion
+    size_t outstanding() const;
+
+private:
+    service();
+    virtual ~service();
+
+    // await descriptor readiness on the reactor of the calling scheduler
+    static hce::awt<int> ready_(int fd, bool write);
+
+    /*
+     The io_uring instance and its completion thread. It is implemented in
+     the source file to keep platform headers out of this header, and is
+     null when the blocking backend is in use.
+     */
+    struct ring;
+
+    static service* instance_;
+    std::unique_ptr<ring> ring_;
+
+    friend hce::lifecycle;
+    friend file;
+    friend hce::awt<int> readable(int);
+    friend hce::awt<int> writable(int);
+};
+
+}
+}
+
+#endif
@@ -19,6 +19,7 @@
 #include "threadpool.hpp"
 #include "blocking.hpp"
 #include "timer.hpp"
+#include "io.hpp"
 
 namespace hce {
 
@@ -185,6 +186,7 @@ public:
 
              Defaults set by compiler define(s):
              HCEGLOBALSCHEDULERCOROUTINERESOURCELIMIT
+             HCESCHEDULERREACTOR
              */
             hce::config::scheduler::config global_config; 
 
@@ -219,6 +221,7 @@ public:
 
              Defaults set by compiler define(s):
              HCETHREADPOOLCOROUTINERESOURCELIMIT
+             HCESCHEDULERREACTOR
              */
             hce::config::scheduler::config worker_config; 
 
@@ -244,10 +247,26 @@ public:
              @brief reusable block workers count shared by the process
 
              Defaults set by compiler define(s):
-             HCEPROCESSREUSABLEBLOCKWORKERPROCESSLIMIT
+             HCEREUSABLEBLOCKWORKERCACHESIZE
              */
             size_t reusable_block_worker_cache_size;
 
+            /**
+             @brief maximum count of block worker threads, or `0` for no limit
+
+             Defaults set by compiler define(s):
+             HCEBLOCKWORKERLIMIT
+             */
+            size_t worker_limit;
+
+            /**
+             @brief how long idle workers beyond the reusable count persist
+
+             Defaults set by compiler define(s):
+             HCEBLOCKWORKERKEEPALIVEMILLISECONDS
+             */
+            hce::chrono::duration worker_keepalive;
+
             /// return the process-wide config
             static inline const blocking& get() { return blocking::global_; }
 
@@ -273,6 +292,34 @@ public:
              */
             hce::chrono::duration busy_wait_threshold;
 
+            /**
+             @brief whether the timer service tunes its thresholds at runtime
+
+             When `true`, the busy-wait and early-wakeup thresholds are only 
+             initial values which the timer service adapts to its measured 
+             wakeup overshoot.
+
+             Defaults set by compiler define(s):
+             HCETIMERADAPTIVE
+             */
+            bool adaptive;
+
+            /**
+             @brief the lowest busy-wait threshold adaptive tuning can select
+
+             Defaults set by compiler define(s):
+             HCETIMERBUSYWAITMICROSECONDMINIMUM
+             */
+            hce::chrono::duration busy_wait_threshold_minimum;
+
+            /**
+             @brief the highest busy-wait threshold adaptive tuning can select
+
+             Defaults set by compiler define(s):
+             HCETIMERBUSYWAITMICROSECONDMAXIMUM
+             */
+            hce::chrono::duration busy_wait_threshold_maximum;
+
             /**
              @brief threshold used by default timeout algorithm for the early-wakeup duration
 
@@ -293,6 +340,17 @@ public:
              */
             hce::chrono::duration early_wakeup_long_threshold;
 
+            /**
+             @brief the strategy the timer service uses to wait for timeouts
+
+             The timeout algorithm and busy-wait threshold are only used by 
+             the condition_variable backend.
+
+             Defaults set by compiler define(s):
+             HCETIMERBACKEND
+             */
+            hce::config::timer::backend backend;
+
             /**
              @brief timer service timeout algorithm
 
@@ -313,6 +371,33 @@ public:
             friend config_init;
         };
 
+        struct io {
+            io();
+
+            /**
+             @brief the strategy the io service uses to execute file operations
+
+             Defaults set by compiler define(s):
+             HCEIOBACKEND
+             */
+            hce::config::io::backend backend;
+
+            /**
+             @brief the count of io_uring submission queue entries
+
+             Defaults set by compiler define(s):
+             HCEIOURINGENTRIES
+             */
+            size_t io_uring_entries;
+
+            /// return the process-wide config
+            static inline const io& get() { return io::global_; }
+
+        private:
+            static io global_;
+            friend config_init;
+        };
+
         config() : sch(mem), tp(mem) {}
 
         logging log;
@@ -322,6 +407,7 @@ public:
         threadpool tp;
         blocking blk;
         timer tmr;
+        io aio;
     };
 
     virtual ~lifecycle() { 
@@ -451,6 +537,7 @@ private:
             lifecycle::config::threadpool::global_ = c.tp;
             lifecycle::config::blocking::global_ = c.blk;
             lifecycle::config::timer::global_ = c.tmr;
+            lifecycle::config::io::global_ = c.aio;
         }
     };
 
@@ -521,6 +608,7 @@ private:
     hce::threadpool::service threadpool_service_;
     hce::blocking::service blocking_service_;
     hce::timer::service timer_service_;
+    hce::io::service io_service_;
 
     // needs to acquire `thread_local` `scoped_cache` instances.
     friend hce::memory::cache;
@@ -35,7 +35,8 @@ namespace hce {
  Design Limitations:
  - can only read and pop from head (singly linked)
  - no iterator support
- - no support for arbitrary insertion or erasure
+ - no support for arbitrary insertion 
+ - arbitrary erasure by value is linear time
  - no support for sorting capabilities
 
  This is preferred by this project over `std::deque<T>` because that object 
@@ -215,6 +216,40 @@ struct list : public printable {
         --size_;
     }
 
+    /**
+     @brief remove the first element which compares equal to the argument
+
+     This operation is linear in the length of the list, it is intended for 
+     rare operations like removing an element which timed out.
+
+     @param t the value to compare against
+     @return true if an element was removed, else false
+     */
+    inline bool remove(const T& t) {
+        HCE_MIN_METHOD_ENTER("remove");
+        node* prev = nullptr;
+        node* cur = head_;
+
+        while(cur) [[likely]] {
+            if(cur->value == t) [[unlikely]] {
+                if(prev) [[likely]] { prev->next = cur->next; } 
+                else [[unlikely]] { head_ = cur->next; }
+
+                if(cur == tail_) [[unlikely]] { tail_ = prev; }
+
+                cur->~node();
+                allocator_.deallocate(cur,1);
+                --size_;
+                return true;
+            }
+
+            prev = cur;
+            cur = cur->next;
+        }
+
+        return false;
+    }
+
     /**
      @brief steal the elements of the argument list and concatenate them to the end 
 
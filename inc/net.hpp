@@ -0,0 +1,292 @@
+//SPDX-License-Identifier: MIT
+//Author: Blayne Dennis
+#ifndef HERMES_COROUTINE_ENGINE_NET
+#define HERMES_COROUTINE_ENGINE_NET
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <cstdint>
+#include <string>
+#include <sstream>
+#include <utility>
+
+#include "base.hpp"
+#include "logging.hpp"
+#include "coroutine.hpp"
+
+namespace hce {
+namespace net {
+
+/**
+ @brief a socket address
+
+ Addresses are constructed from numeric IPv4 or IPv6 hosts, or from Unix
+ domain socket paths. An address which failed to parse is invalid.
+ */
+struct address : public printable {
+    address() : size_(0) { storage_.ss_family = AF_UNSPEC; }
+
+    /// copy a system socket address
+    address(const sockaddr* sa, socklen_t size);
+
+    address(const address&) = default;
+    address& operator=(const address&) = default;
+
+    static inline std::string info_name() { return "hce::net::address"; }
+    inline std::string name() const { return address::info_name(); }
+
+    std::string content() const;
+
+    /**
+     @brief construct an IP address
+     @param host a numeric IPv4 or IPv6 host, such as "127.0.0.1" or "::1"
+     @param port the port in host byte order
+     @return the address, which is invalid if host could not be parsed
+     */
+    static address ip(const std::string& host, uint16_t port);
+
+    /**
+     @brief construct a Unix domain socket address
+     @param path the socket's filesystem path
+     @return the address, which is invalid if path is too long
+     */
+    static address local(const std::string& path);
+
+    /// return the address family, or `AF_UNSPEC` if the address is invalid
+    inline int family() const { return storage_.ss_family; }
+
+    /// return the port in host byte order, or 0 if the address is not IP
+    uint16_t port() const;
+
+    /// return the system socket address
+    inline const sockaddr* data() const { return (const sockaddr*)&storage_; }
+
+    /// return the size of the system socket address
+    inline socklen_t size() const { return size_; }
+
+    /// return whether the address is valid
+    inline explicit operator bool() const { return size_ > 0; }
+
+private:
+    sockaddr_storage storage_;
+    socklen_t size_;
+};
+
+/**
+ @brief an owned, connected, non-blocking stream socket with awaitable operations
+
+ Operations are first attempted immediately. When a coroutine executing on a
+ scheduler with a reactor (see `hce::config::scheduler::config::reactor`)
+ would block, it suspends until the scheduler's reactor reports the socket
+ ready and the operation is retried by the scheduler's thread, so idle
+ connections require no threads. Otherwise, the operation is executed with
+ `hce::block()`, waiting for readiness with `poll()`.
+
+ Operations return awaitables which can be `co_await`ed by coroutines or
+ assigned to a result by threads, in which case the calling thread blocks
+ until the operation completes. Like the underlying system calls, operations
+ return a negative `errno` value on failure.
+
+ Buffers must remain valid until the returned awaitable completes. Only one
+ read and one write operation can be outstanding at a time.
+
+ The socket is closed synchronously when the `stream` is destroyed, unless
+ ownership has been given up with `release()`.
+ */
+struct stream : public printable {
+    stream() = default;
+
+    /// take ownership of a connected socket, which is made non-blocking
+    explicit stream(int fd);
+
+    stream(const stream&) = delete;
+
+    stream(stream&& rhs) : fd_(rhs.fd_), error_(rhs.error_) {
+        rhs.fd_ = -1;
+    }
+
+    virtual ~stream() { close(); }
+
+    stream& operator=(const stream&) = delete;
+
+    inline stream& operator=(stream&& rhs) {
+        if(this != &rhs) [[likely]] {
+            close();
+            fd_ = rhs.fd_;
+            error_ = rhs.error_;
+            rhs.fd_ = -1;
+        }
+
+        return *this;
+    }
+
+    static inline std::string info_name() { return "hce::net::stream"; }
+    inline std::string name() const { return stream::info_name(); }
+
+    inline std::string content() const {
+        std::stringstream ss;
+        ss << "fd:" << fd_;
+        return ss.str();
+    }
+
+    /**
+     @brief connect a new stream socket to an address
+     @param a the address to connect to
+     @return an awaitable returning the connected stream, which is invalid with `error()` set on failure
+     */
+    static hce::awt<stream> connect(const address& a);
+
+    /**
+     @brief create a pair of connected Unix domain streams
+     @return the pair of streams, which are invalid with `error()` set on failure
+     */
+    static std::pair<stream,stream> pair();
+
+    /**
+     @brief read the currently available bytes
+     @param buf the destination buffer
+     @param len the maximum count of bytes to read
+     @return an awaitable returning the count of bytes read, 0 at end of stream, or a negative errno
+     */
+    hce::awt<ssize_t> read_some(void* buf, size_t len);
+
+    /**
+     @brief write every byte of a buffer
+     @param buf the source buffer
+     @param len the count of bytes to write
+     @return an awaitable returning len or a negative errno
+     */
+    hce::awt<ssize_t> write_all(const void* buf, size_t len);
+
+    /**
+     @brief scatter the currently available bytes into buffers
+     @param iov the destination buffers, which are copied into the operation
+     @param count the count of buffers
+     @return an awaitable returning the count of bytes read, 0 at end of stream, or a negative errno
+     */
+    hce::awt<ssize_t> readv(const iovec* iov, int count);
+
+    /**
+     @brief gather and write every byte of buffers
+     @param iov the source buffers, which are copied into the operation
+     @param count the count of buffers
+     @return an awaitable returning the total length of the buffers or a negative errno
+     */
+    hce::awt<ssize_t> writev(const iovec* iov, int count);
+
+    /**
+     @brief synchronously shut down part of a full-duplex connection
+     @param how `SHUT_RD`, `SHUT_WR` or `SHUT_RDWR`
+     @return 0 or a negative errno
+     */
+    int shutdown(int how = SHUT_WR);
+
+    /// return the address of the connected peer
+    address peer_address() const;
+
+    /// return the socket file descriptor, or -1 if the stream is invalid
+    inline int fd() const { return fd_; }
+
+    /// return the errno of the failed connect, or 0
+    inline int error() const { return error_; }
+
+    /// return whether the stream holds an open socket
+    inline explicit operator bool() const { return fd_ >= 0; }
+
+    /// give up ownership of the socket and return it
+    inline int release() {
+        int fd = fd_;
+        fd_ = -1;
+        return fd;
+    }
+
+    /// synchronously close the socket
+    void close();
+
+private:
+    int fd_ = -1;
+    int error_ = 0;
+};
+
+/**
+ @brief an owned, non-blocking listening socket which accepts streams
+
+ Accepting behaves like the operations of `hce::net::stream`.
+ */
+struct listener : public printable {
+    listener() = default;
+
+    listener(const listener&) = delete;
+
+    listener(listener&& rhs) : fd_(rhs.fd_), error_(rhs.error_) {
+        rhs.fd_ = -1;
+    }
+
+    virtual ~listener() { close(); }
+
+    listener& operator=(const listener&) = delete;
+
+    inline listener& operator=(listener&& rhs) {
+        if(this != &rhs) [[likely]] {
+            close();
+            fd_ = rhs.fd_;
+            error_ = rhs.error_;
+            rhs.fd_ = -1;
+        }
+
+        return *this;
+    }
+
+    static inline std::string info_name() { return "hce::net::listener"; }
+    inline std::string name() const { return listener::info_name(); }
+
+    inline std::string content() const {
+        std::stringstream ss;
+        ss << "fd:" << fd_;
+        return ss.str();
+    }
+
+    /**
+     @brief synchronously bind and listen on an address
+
+     IP listeners set `SO_REUSEADDR`. Binding port 0 selects an ephemeral
+     port, which can be retrieved with `local_address()`.
+
+     @param a the address to listen on
+     @param backlog the maximum length of the pending connection queue
+     @return the listener, which is invalid with `error()` set on failure
+     */
+    static listener bind(const address& a, int backlog = SOMAXCONN);
+
+    /**
+     @brief accept the next connection
+     @return an awaitable returning the accepted stream, which is invalid with `error()` set on failure
+     */
+    hce::awt<stream> accept();
+
+    /// return the bound address
+    address local_address() const;
+
+    /// return the socket file descriptor, or -1 if the listener is invalid
+    inline int fd() const { return fd_; }
+
+    /// return the errno of the failed bind, or 0
+    inline int error() const { return error_; }
+
+    /// return whether the listener holds an open socket
+    inline explicit operator bool() const { return fd_ >= 0; }
+
+    /// synchronously close the socket
+    void close();
+
+private:
+    int fd_ = -1;
+    int error_ = 0;
+};
+
+}
+}
+
+#endif
@@ -14,6 +14,7 @@
 #include <string>
 #include <sstream>
 #include <thread>
+#include <unordered_map>
 
 // local 
 #include "logging.hpp"
@@ -68,6 +69,30 @@ struct config {
      */
     size_t reusable_coroutine_handle_limit;
 
+    /**
+     The count of idle `hce::block()` worker threads the scheduler's thread 
+     can keep in its own cache. Blocking calls made by coroutines on the 
+     scheduler reuse these workers without taking the process-wide 
+     `hce::blocking::service` lock, which is only used as a fallback when the 
+     cache is empty. A value of `0` disables the cache. 
+     */
+    size_t reusable_block_worker_limit;
+
+    /**
+     When `true`, the scheduler owns an `epoll` reactor on supported platforms 
+     (Linux). Instead of waiting on a condition variable when it has no 
+     coroutines to execute, the scheduler's thread waits in `epoll_wait()`, 
+     allowing coroutines to `co_await hce::io::readable(fd)` and 
+     `hce::io::writable(fd)` and be resumed directly by the scheduler when the 
+     descriptor becomes ready, without any additional threads. Scheduling from 
+     other threads wakes the reactor through an `eventfd`.
+
+     Defaults to `false`, except for the global and threadpool schedulers which 
+     default to the `HCESCHEDULERREACTOR` define. Unsupported platforms ignore 
+     this value.
+     */
+    bool reactor;
+
     /**
      The selected memory cache configuration. This object describes the 
      `thread_local` memory cache of reusable allocations that this framework 
@@ -142,6 +167,32 @@ hce::scheduler*& tl_this_scheduler();
 std::unique_ptr<hce::list<std::coroutine_handle<>>>*& 
 tl_this_scheduler_local_queue();
 
+// a handler executed by a scheduler's reactor on the scheduler's thread
+struct completion {
+    // resume the operation with a result, after which ctx may have been 
+    // deallocated
+    void (*complete)(void* ctx, int res) = nullptr;
+    void* ctx = nullptr;
+};
+
+/*
+ Register a waiter for the readability or writability of a file descriptor 
+ with the reactor of the calling thread's scheduler. It is an ERROR to call 
+ this unless `hce::scheduler::in() && hce::scheduler::local().reactor()`.
+
+ Returns 0 on success, else an errno value.
+ */
+int reactor_register(int fd, bool write, completion* c);
+
+/*
+ Remove a file descriptor from the reactor of the calling thread's scheduler, 
+ completing its waiters with `-ECANCELED`. This must be called before a 
+ descriptor which may have waiters is closed, because `epoll` silently drops 
+ closed descriptors. Does nothing if the calling thread's scheduler has no 
+ reactor.
+ */
+void reactor_deregister(int fd);
+
 /*
  An implementation of hce::awt<T>::interface capable of joining a coroutine 
 
@@ -677,7 +728,13 @@ struct scheduler : public printable {
         };
     };
 
-    virtual ~scheduler() { HCE_HIGH_DESTRUCTOR(); }
+    virtual ~scheduler() { 
+        HCE_HIGH_DESTRUCTOR(); 
+
+        // run() cancels every descriptor waiter when the scheduler halts, a 
+        // halted scheduler cannot reschedule their coroutines from this thread
+        if(reactor_epollfd_ >= 0) [[unlikely]] { reactor_close_(); }
+    }
 
     static inline std::string info_name() { return "hce::scheduler"; }
     inline std::string name() const { return scheduler::info_name(); }
@@ -847,6 +904,29 @@ struct scheduler : public printable {
         return config_.reusable_coroutine_handle_limit;
     }
 
+    /**
+     This value is determined by the 
+     `scheduler::config::reusable_block_worker_limit` member in the 
+     `scheduler::config` passed to `scheduler::make()`.
+
+     @return the count of block workers cached by the scheduler's thread
+     */
+    inline size_t reusable_block_worker_limit() const {
+        HCE_MIN_METHOD_BODY("reusable_block_worker_limit",config_.reusable_block_worker_limit);
+        return config_.reusable_block_worker_limit;
+    }
+
+    /**
+     The reactor is requested by the `scheduler::config::reactor` member in 
+     the `scheduler::config` passed to `scheduler::make()`. 
+
+     @return `true` if the scheduler waits for work in an `epoll` reactor, else `false`
+     */
+    inline bool reactor() const {
+        HCE_MIN_METHOD_BODY("reactor",reactor_epollfd_ >= 0);
+        return reactor_epollfd_ >= 0;
+    }
+
     /***
      @brief schedule a single coroutine and return an awaitable to await the `co_return`ed value
 
@@ -910,6 +990,7 @@ private:
     { 
         HCE_HIGH_CONSTRUCTOR();
         reset_flags_(); // initialize flags
+        if(config_.reactor) [[unlikely]] { reactor_init_(); }
     }
 
     // finish initializing and configuring the scheduler
@@ -1025,10 +1106,64 @@ private:
         if(waiting_for_coroutines_) {
             HCE_TRACE_METHOD_BODY("coroutines_notify_");
             waiting_for_coroutines_ = false;
-            coroutines_cv_.notify_one();
+
+            if(reactor_epollfd_ < 0) [[likely]] {
+                coroutines_cv_.notify_one();
+            } else [[unlikely]] {
+                reactor_notify_();
+            }
         }
     }
 
+    /*
+     The reactor is implemented in the source file to keep platform headers 
+     out of this header. On unsupported platforms reactor_init_() leaves 
+     reactor_epollfd_ negative, so the condition_variable idle wait is used.
+
+     Waiter registrations are only ever accessed by the scheduler's thread, 
+     either by coroutines awaiting readiness or by run(), so they require no 
+     synchronization.
+     */
+
+    // create the epoll and eventfd file descriptors
+    void reactor_init_();
+
+    // close the reactor file descriptors
+    void reactor_close_();
+
+    // wake the scheduler's thread from reactor_wait_()
+    void reactor_notify_();
+
+    /*
+     Unlock, wait up to timeout milliseconds (-1 is indefinite) for descriptor 
+     readiness or a notification, complete every ready waiter and relock. 
+     Completed waiters are rescheduled onto the local queue.
+     */
+    void reactor_wait_(std::unique_lock<hce::spinlock>& lk, int timeout);
+
+    /*
+     Register a waiter for the readability or writability of a file 
+     descriptor. Must be called on the scheduler's thread. 
+
+     Returns 0 on success, else an errno value.
+     */
+    int reactor_register_(int fd, 
+                          bool write, 
+                          detail::scheduler::completion* c);
+
+    /*
+     Remove a file descriptor from the reactor, completing its waiters with 
+     -ECANCELED. Must be called on the scheduler's thread.
+     */
+    void reactor_deregister_(int fd);
+
+    /*
+     Complete every waiter with -ECANCELED and fail future registrations with 
+     ECANCELED. Completed waiters are rescheduled onto the local queue. Must be 
+     called on the scheduler's thread.
+     */
+    void reactor_cancel_();
+
     /*
      Execute coroutines continuously. This processing loop is highly optimized, 
      and contains a variety of comments to explain its design.
@@ -1169,16 +1304,62 @@ private:
 
                         // cleanup batch results, requeueing local coroutines
                         cleanup_batch();
+
+                        // don't starve descriptor waiters while busy
+                        if(reactor_waiters_.size()) [[unlikely]] {
+                            reactor_wait_(lk, 0);
+                            cleanup_batch();
+                        }
                     } else [[unlikely]] {
                         // wait for more tasks
                         waiting_for_coroutines_ = true;
-                        coroutines_cv_.wait(lk);
+
+                        if(reactor_epollfd_ < 0) [[likely]] {
+                            coroutines_cv_.wait(lk);
+                        } else [[unlikely]] {
+                            reactor_wait_(lk, -1);
+                            waiting_for_coroutines_ = false;
+
+                            // requeue coroutines resumed by the reactor
+                            cleanup_batch();
+                        }
                     }
                 }
 
                 // reset member state flags
                 reset_flags_();
             }
+
+            if(reactor_epollfd_ >= 0) [[unlikely]] {
+                /*
+                 Descriptor waiters can never be resumed by a halted 
+                 scheduler. Complete them with an error and evaluate their 
+                 coroutines once more, so they can observe the error and 
+                 complete instead of waiting forever.
+                 */
+                reactor_cancel_();
+                lk.unlock();
+
+                {
+                    size_t count = local_queue->size();
+                    coroutine co;
+
+                    while(count) {
+                        --count;
+                        co.reset(local_queue->front());
+                        local_queue->pop();
+                        co.resume();
+
+                        if(co && !co.done()) {
+                            local_queue->push_back(co.release()); 
+                        }
+                    }
+                }
+
+                lk.lock();
+                cleanup_batch();
+                reactor_close_();
+            }
         } catch(...) { // catch all other exceptions 
             // it is an error in this framework if an exception occurs when 
             // the lock is held, it should only be when executing user 
@@ -1232,6 +1413,26 @@ private:
 
     // a weak_ptr to the scheduler's shared memory
     std::weak_ptr<scheduler> self_wptr_;
+
+    // reactor backend file descriptors
+    int reactor_epollfd_ = -1;
+    int reactor_eventfd_ = -1;
+
+    // the waiters for each file descriptor registered with the reactor
+    struct reactor_waiter {
+        detail::scheduler::completion* reader = nullptr;
+        detail::scheduler::completion* writer = nullptr;
+    };
+
+    std::unordered_map<int, reactor_waiter> reactor_waiters_;
+
+    // set when the reactor's waiters are cancelled by a halt
+    bool reactor_cancelled_ = false;
+
+    friend int detail::scheduler::reactor_register(int, 
+                                                   bool, 
+                                                   detail::scheduler::completion*);
+    friend void detail::scheduler::reactor_deregister(int);
 };
 
 /**
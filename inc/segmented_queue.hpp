@@ -0,0 +1,272 @@
+//SPDX-License-Identifier: MIT
+//Author: Blayne Dennis
+#ifndef HERMES_COROUTINE_ENGINE_SEGMENTED_QUEUE
+#define HERMES_COROUTINE_ENGINE_SEGMENTED_QUEUE
+
+#include <cstddef>
+#include <new>
+#include <sstream>
+#include <utility>
+
+#include "utility.hpp"
+#include "logging.hpp"
+#include "alloc.hpp"
+
+namespace hce {
+
+/**
+ @brief a FIFO queue stored in a linked list of fixed size segments
+
+ This object is optimized for unbounded queues which have values pushed on the
+ back and popped off the front, such as the queue of `hce::channel::unlimited`.
+
+ Design Aims:
+ - constant time push on the back and pop off the front
+ - values are stored contiguously in segments of SEGMENT_SIZE values
+ - memory is allocated once per segment instead of once per value
+ - the most recently emptied segment is kept for reuse, so a queue which
+   repeatedly grows and shrinks across a segment boundary doesn't allocate
+ - defaults to pool_allocator<T> for efficient reuse of further segments
+ - size/length tracking
+
+ Design Limitations:
+ - can only read and pop from the front
+ - no iterator support
+ - no support for arbitrary insertion or erasure
+ */
+template <typename T,
+          typename Allocator = hce::pool_allocator<T>,
+          size_t SEGMENT_SIZE = 128>
+struct segmented_queue : public printable {
+    static_assert(SEGMENT_SIZE > 0, "SEGMENT_SIZE must be greater than 0");
+
+    using value_type = T;
+
+    segmented_queue() { HCE_MIN_CONSTRUCTOR(); }
+
+    segmented_queue(const Allocator& allocator) :
+        allocator_(allocator) {
+        HCE_MIN_CONSTRUCTOR(allocator);
+    }
+
+    segmented_queue(const segmented_queue<T,Allocator,SEGMENT_SIZE>& rhs) {
+        HCE_MIN_CONSTRUCTOR(rhs);
+        copy_(rhs);
+    }
+
+    segmented_queue(segmented_queue<T,Allocator,SEGMENT_SIZE>&& rhs) {
+        HCE_MIN_CONSTRUCTOR(rhs);
+        move_(std::move(rhs));
+    }
+
+    virtual ~segmented_queue() {
+        HCE_MIN_DESTRUCTOR();
+        clear_();
+    }
+
+    static inline std::string info_name() {
+        return type::templatize<T>("hce::segmented_queue");
+    }
+
+    inline std::string name() const {
+        return segmented_queue<T,Allocator,SEGMENT_SIZE>::info_name();
+    }
+
+    inline std::string content() const {
+        std::stringstream ss;
+        ss << "size:" << size_ << ", segment size:" << SEGMENT_SIZE << ", "
+           << allocator_;
+        return ss.str();
+    }
+
+    inline segmented_queue<T,Allocator,SEGMENT_SIZE>& operator=(
+            const segmented_queue<T,Allocator,SEGMENT_SIZE>& rhs) {
+        HCE_MIN_METHOD_ENTER("operator=", rhs);
+        if(this != &rhs) [[likely]] {
+            clear_();
+            copy_(rhs);
+        }
+        return *this;
+    }
+
+    inline segmented_queue<T,Allocator,SEGMENT_SIZE>& operator=(
+            segmented_queue<T,Allocator,SEGMENT_SIZE>&& rhs) {
+        HCE_MIN_METHOD_ENTER("operator=", rhs);
+        move_(std::move(rhs));
+        return *this;
+    }
+
+    /// return the count of values in each segment
+    static constexpr size_t segment_size() { return SEGMENT_SIZE; }
+
+    /**
+     @return the current length of the queue
+     */
+    inline size_t size() const {
+        HCE_TRACE_METHOD_ENTER("size");
+        return size_;
+    }
+
+    /**
+     @return true if empty, else false
+     */
+    inline bool empty() const {
+        HCE_TRACE_METHOD_ENTER("empty");
+        return !size_;
+    }
+
+    /**
+     @return a reference to the front of the queue
+     */
+    inline T& front() {
+        HCE_TRACE_METHOD_ENTER("front");
+        return *(head_->at(head_->head));
+    }
+
+    /**
+     @brief emplace an element on the back of the queue
+     */
+    template <typename... As>
+    inline void emplace_back(As&&... as) {
+        HCE_MIN_METHOD_ENTER("emplace_back");
+
+        if(!tail_) [[unlikely]] {
+            head_ = tail_ = acquire_();
+        } else if(tail_->tail == SEGMENT_SIZE) [[unlikely]] {
+            tail_->next = acquire_();
+            tail_ = tail_->next;
+        }
+
+        // placement new construction
+        new(tail_->at(tail_->tail)) T(std::forward<As>(as)...);
+        ++(tail_->tail);
+        ++size_;
+    }
+
+    /**
+     @brief lvalue push an element on the back of the queue
+     */
+    inline void push_back(const T& t) {
+        HCE_MIN_METHOD_ENTER("push_back");
+        emplace_back(t);
+    }
+
+    /**
+     @brief rvalue push an element on the back of the queue
+     */
+    inline void push_back(T&& t) {
+        HCE_MIN_METHOD_ENTER("push_back");
+        emplace_back(std::move(t));
+    }
+
+    /**
+     @brief pop off the front of the queue
+     */
+    inline void pop() {
+        HCE_MIN_METHOD_ENTER("pop");
+        head_->at(head_->head)->~T();
+        ++(head_->head);
+        --size_;
+
+        if(head_->head == head_->tail) [[unlikely]] {
+            if(head_ == tail_) [[likely]] {
+                // reuse the only segment from its beginning
+                head_->head = 0;
+                head_->tail = 0;
+            } else [[unlikely]] {
+                segment* old = head_;
+                head_ = head_->next;
+                release_(old);
+            }
+        }
+    }
+
+private:
+    // a contiguous range of values
+    struct segment {
+        inline T* at(size_t i) {
+            return std::launder(reinterpret_cast<T*>(storage) + i);
+        }
+
+        segment* next = nullptr;
+        size_t head = 0; // index of the first constructed value
+        size_t tail = 0; // index past the last constructed value
+        alignas(T) unsigned char storage[sizeof(T) * SEGMENT_SIZE];
+    };
+
+    // return an empty segment, preferring the spare
+    inline segment* acquire_() {
+        segment* s;
+
+        if(spare_) [[likely]] {
+            s = spare_;
+            spare_ = nullptr;
+        } else [[unlikely]] {
+            s = allocator_.allocate(1);
+            new(s) segment();
+        }
+
+        return s;
+    }
+
+    // keep an emptied segment as the spare or deallocate it
+    inline void release_(segment* s) {
+        if(spare_) [[unlikely]] {
+            s->~segment();
+            allocator_.deallocate(s,1);
+        } else [[likely]] {
+            s->next = nullptr;
+            s->head = 0;
+            s->tail = 0;
+            spare_ = s;
+        }
+    }
+
+    // destruct all values and deallocate all segments
+    inline void clear_() {
+        while(size_) [[likely]] { pop(); }
+
+        if(head_) {
+            head_->~segment();
+            allocator_.deallocate(head_,1);
+            head_ = nullptr;
+            tail_ = nullptr;
+        }
+
+        if(spare_) {
+            spare_->~segment();
+            allocator_.deallocate(spare_,1);
+            spare_ = nullptr;
+        }
+    }
+
+    // deep copy the argument queue's elements
+    inline void copy_(const segmented_queue<T,Allocator,SEGMENT_SIZE>& rhs) {
+        for(segment* s = rhs.head_; s; s = s->next) {
+            for(size_t i = s->head; i < s->tail; ++i) {
+                push_back(*(s->at(i))); // deep copy the value
+            }
+        }
+
+        // ignore the allocator
+    }
+
+    // move swap members
+    inline void move_(segmented_queue<T,Allocator,SEGMENT_SIZE>&& rhs) {
+        std::swap(head_, rhs.head_);
+        std::swap(tail_, rhs.tail_);
+        std::swap(spare_, rhs.spare_);
+        std::swap(size_, rhs.size_);
+        std::swap(allocator_, rhs.allocator_);
+    }
+
+    segment* head_ = nullptr; // segment containing the front of the queue
+    segment* tail_ = nullptr; // segment containing the back of the queue
+    segment* spare_ = nullptr; // emptied segment kept for reuse
+    size_t size_ = 0; // length of queue
+    typename Allocator::template rebind<segment>::other allocator_; // memory allocator
+};
+
+}
+
+#endif
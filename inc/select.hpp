@@ -0,0 +1,312 @@
+//SPDX-License-Identifier: MIT
+//Author: Blayne Dennis
+#ifndef HERMES_COROUTINE_ENGINE_SELECT
+#define HERMES_COROUTINE_ENGINE_SELECT
+
+// c++
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <type_traits>
+#include <vector>
+
+// local
+#include "utility.hpp"
+#include "logging.hpp"
+#include "chrono.hpp"
+#include "coroutine.hpp"
+#include "scheduler.hpp"
+#include "timer.hpp"
+#include "channel.hpp"
+
+namespace hce {
+
+/**
+ @brief awaitable synchronization object which completes exactly one of several channel operations
+
+ Cases are added with `recv()`, `send()`, `timeout()` and `otherwise()`, each
+ of which returns the index of the added case. `await()` returns an awaitable
+ which completes the first case able to complete and returns its index:
+ ```
+ int i;
+ hce::select s;
+ size_t recv_case = s.recv(ch1, i);
+ size_t send_case = s.send(ch2, 3);
+ size_t timeout_case = s.timeout(std::chrono::milliseconds(100));
+
+ size_t completed = co_await s.await();
+
+ if(completed == recv_case) {
+     // i was received from ch1 if s.success() is true, else ch1 is closed
+ } else if(completed == send_case) {
+     // 3 was sent to ch2 if s.success() is true, else ch2 is closed
+ } else {
+     // neither operation completed within 100 milliseconds
+ }
+ ```
+
+ Operations which cannot complete immediately are parked on their channels
+ until one of them completes, at which point the rest are cancelled without
+ having transferred a value. An operation on a closed channel completes
+ unsuccessfully, like the equivalent `send()` or `recv()`.
+
+ If an `otherwise()` case is added, the select completes it instead of
+ waiting when no other case can complete immediately. Otherwise, if a
+ `timeout()` case is added, the select completes it when the timeout is
+ reached without another case completing.
+
+ A select can only be awaited once, and it must remain valid until the
+ awaitable returned by `await()` completes. Sent lvalues and received values
+ must likewise remain valid until the awaitable completes.
+ */
+struct select : public hce::printable {
+    select() { HCE_MED_CONSTRUCTOR(); }
+    select(const select&) = delete;
+    select(select&&) = delete;
+
+    virtual ~select() { HCE_MED_DESTRUCTOR(); }
+
+    select& operator=(const select&) = delete;
+    select& operator=(select&&) = delete;
+
+    static inline std::string info_name() { return "hce::select"; }
+    inline std::string name() const { return select::info_name(); }
+
+    inline std::string content() const {
+        std::stringstream ss;
+        ss << "cases:" << cases_.size();
+        return ss.str();
+    }
+
+    /**
+     @brief add a case receiving a value from a channel
+     @param ch the channel
+     @param t the destination of the received value
+     @return the index of the case
+     */
+    template <typename T>
+    inline size_t recv(hce::channel::interface<T>& ch, T& t) {
+        HCE_MED_METHOD_ENTER("recv",(void*)&ch,(void*)&t);
+        const size_t index = cases_.size();
+        cases_.push_back(ch.select_recv(t, selector_, index));
+        return index;
+    }
+
+    /**
+     @brief add a case sending a lvalue copy to a channel
+     @param ch the channel
+     @param t the value to send
+     @return the index of the case
+     */
+    template <typename T>
+    inline size_t send(
+            hce::channel::interface<T>& ch,
+            const std::type_identity_t<T>& t) {
+        HCE_MED_METHOD_ENTER("send",(void*)&ch,(void*)&t);
+        const size_t index = cases_.size();
+        cases_.push_back(ch.select_send(t, selector_, index));
+        return index;
+    }
+
+    /**
+     @brief add a case sending a rvalue copy to a channel
+
+     The value is moved into the select, so temporaries can be sent. It is 
+     only moved into the channel if the case completes.
+
+     @param ch the channel
+     @param t the value to send
+     @return the index of the case
+     */
+    template <typename T>
+    inline size_t send(
+            hce::channel::interface<T>& ch,
+            std::type_identity_t<T>&& t) {
+        HCE_MED_METHOD_ENTER("send",(void*)&ch,(void*)&t);
+        auto v = std::make_shared<T>(std::move(t));
+        values_.push_back(v);
+        const size_t index = cases_.size();
+        cases_.push_back(ch.select_send(std::move(*v), selector_, index));
+        return index;
+    }
+
+    /**
+     @brief add a case which completes when a timeout is reached
+
+     Only one timeout case can be added, later calls replace the timeout.
+
+     @param tp the time point of the timeout
+     @return the index of the case
+     */
+    inline size_t timeout(const hce::chrono::time_point& tp) {
+        HCE_MED_METHOD_ENTER("timeout",tp);
+
+        if(!timeout_index_) [[likely]] {
+            timeout_index_ = cases_.size();
+            cases_.push_back(nullptr);
+        }
+
+        timeout_ = tp;
+        return *timeout_index_;
+    }
+
+    /**
+     @brief add a case which completes when a timeout is reached
+     @param dur the duration until the timeout
+     @return the index of the case
+     */
+    inline size_t timeout(const hce::chrono::duration& dur) {
+        return timeout(hce::chrono::now() + dur);
+    }
+
+    /**
+     @brief add a case which completes when no other case can complete immediately
+
+     Only one default case can be added, later calls return the same index.
+
+     @return the index of the case
+     */
+    inline size_t otherwise() {
+        HCE_MED_METHOD_ENTER("otherwise");
+
+        if(!otherwise_index_) [[likely]] {
+            otherwise_index_ = cases_.size();
+            cases_.push_back(nullptr);
+        }
+
+        return *otherwise_index_;
+    }
+
+    /**
+     @brief complete exactly one case
+     @return an awaitable returning the index of the completed case
+     */
+    inline hce::awt<size_t> await() {
+        HCE_MED_METHOD_ENTER("await");
+        return hce::awt<size_t>(new awaitable_(*this));
+    }
+
+    /**
+     @brief return whether the completed case transferred a value
+
+     This is `false` if the completed case is a channel operation which failed
+     because its channel is closed, or is a timeout or default case.
+     */
+    inline bool success() const { return success_; }
+
+private:
+    typedef std::unique_ptr<hce::channel::detail::select_case> case_t;
+
+    struct awaitable_ :
+        public hce::scheduler::reschedule<
+            hce::awaitable::lockable<
+                hce::spinlock,
+                hce::awt_interface<size_t>>>
+    {
+        awaitable_(select& parent) :
+            hce::scheduler::reschedule<
+                hce::awaitable::lockable<
+                    hce::spinlock,
+                    hce::awt_interface<size_t>>>(
+                        lk_,
+                        hce::awaitable::await::policy::defer,
+                        hce::awaitable::resume::policy::lock),
+            parent_(parent)
+        {
+            parent_.selector_.owner(this);
+        }
+
+        static inline std::string info_name() {
+            return select::info_name() + "::awaitable";
+        }
+
+        inline std::string name() const { return awaitable_::info_name(); }
+
+        inline bool on_ready() {
+            auto& sel = parent_.selector_;
+            sel.start();
+
+            // attempt each operation in order, parking those which block
+            for(auto& c : parent_.cases_) {
+                if(sel.claimed()) [[unlikely]] { break; }
+                else if(c) [[likely]] { c->ready(); }
+            }
+
+            if(parent_.otherwise_index_) {
+                if(sel.claim()) {
+                    HCE_TRACE_METHOD_BODY("on_ready","otherwise");
+                    sel.notify(*(parent_.otherwise_index_));
+                }
+            } else if(sel.park()) [[likely]] {
+                if(parent_.timeout_index_) {
+                    HCE_TRACE_METHOD_BODY("on_ready","parked until ",parent_.timeout_);
+                    hce::timer::service::get().start(
+                        sid_,
+                        parent_.timeout_,
+                        &awaitable_::timeout_handler_,
+                        this);
+                } else {
+                    HCE_TRACE_METHOD_BODY("on_ready","parked");
+                }
+
+                return false;
+            }
+
+            // a case was claimed before the select could suspend
+            sel.wait();
+            return true;
+        }
+
+        inline void on_resume(void* m) { }
+
+        /*
+         Executed by the awaiter after resumption, when no locks are held. Every
+         case is cancelled, including the completed case, because removal
+         synchronizes with any resumer still operating on it while holding its
+         channel's lock.
+         */
+        inline size_t get_result() {
+            if(sid_) [[unlikely]] { hce::timer::service::get().cancel(sid_); }
+
+            for(auto& c : parent_.cases_) {
+                if(c) { c->cancel(); }
+            }
+
+            const size_t winner = parent_.selector_.winner();
+            auto& c = parent_.cases_[winner];
+            parent_.success_ = c && c->succeeded();
+            HCE_MIN_METHOD_BODY("get_result",winner);
+            return winner;
+        }
+
+    private:
+        static inline void timeout_handler_(void* arg, bool timeout) {
+            auto a = static_cast<awaitable_*>(arg);
+            auto& sel = a->parent_.selector_;
+
+            if(timeout && sel.claim()) [[likely]] {
+                HCE_TRACE_FUNCTION_BODY(
+                    "hce::select::awaitable::timeout_handler_",
+                    "timed out");
+                sel.notify(*(a->parent_.timeout_index_));
+            }
+        }
+
+        hce::spinlock lk_;
+        select& parent_;
+        hce::sid sid_;
+    };
+
+    hce::channel::detail::selector selector_;
+    std::vector<case_t> cases_;
+    std::vector<std::shared_ptr<void>> values_; // rvalues to send
+    std::optional<size_t> timeout_index_;
+    std::optional<size_t> otherwise_index_;
+    hce::chrono::time_point timeout_;
+    bool success_ = false;
+};
+
+}
+
+#endif
@@ -0,0 +1,477 @@
+//SPDX-License-Identifier: MIT
+//Author: Blayne Dennis
+#ifndef HERMES_COROUTINE_ENGINE_SLOT_CHAN
+#define HERMES_COROUTINE_ENGINE_SLOT_CHAN
+
+// c++
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <utility>
+
+// local
+#include "utility.hpp"
+#include "logging.hpp"
+#include "atomic.hpp"
+#include "circular_buffer.hpp"
+#include "list.hpp"
+#include "coroutine.hpp"
+#include "scheduler.hpp"
+#include "channel.hpp"
+
+namespace hce {
+
+/**
+ @brief communication object which transfers values in place
+
+ A slot_chan owns a ring of `size` default constructed values, called slots.
+ A producer reserves a free slot, writes the value in place and commits it.
+ A consumer borrows the oldest committed slot, reads the value in place and
+ releases it, which frees the slot for reuse:
+ ```
+ auto ch = hce::slot_chan<large_message>::make(16);
+
+ // producer
+ hce::slot_chan<large_message>::reserved r;
+ if(co_await ch.reserve(r)) {
+     r->header = ...;
+     r.commit();
+ }
+
+ // consumer
+ hce::slot_chan<large_message>::borrowed b;
+ while(co_await ch.borrow(b)) {
+     process(*b);
+     b.release();
+ }
+ ```
+
+ Only pointers to the slots are queued, so values are never moved or copied
+ by the channel. Slots are reused without being destroyed, so a value keeps
+ whatever its last producer wrote to it, including any memory it owns, such
+ as the capacity of a `std::vector`.
+
+ `reserve()` waits until a slot is free, so the slowest consumer throttles
+ producers like a buffered channel. A reserved slot which is destroyed
+ without being committed is freed, and a borrowed slot which is destroyed
+ without being released is released.
+
+ Like `hce::chan<T>`, copies of a slot_chan share the same context.
+ */
+template <typename T, typename LOCK=hce::spinlock>
+struct slot_chan : public printable {
+    typedef T value_type;
+
+private:
+    struct context;
+
+public:
+    /// a slot reserved by a producer
+    struct reserved : public printable {
+        reserved() = default;
+        reserved(const reserved&) = delete;
+
+        reserved(reserved&& rhs) :
+            context_(std::move(rhs.context_)),
+            slot_(rhs.slot_)
+        {
+            rhs.slot_ = nullptr;
+        }
+
+        inline virtual ~reserved(){ abandon_(); }
+
+        reserved& operator=(const reserved&) = delete;
+
+        inline reserved& operator=(reserved&& rhs) {
+            if(this != &rhs) [[likely]] {
+                abandon_();
+                context_ = std::move(rhs.context_);
+                slot_ = rhs.slot_;
+                rhs.slot_ = nullptr;
+            }
+
+            return *this;
+        }
+
+        static inline std::string info_name() {
+            return slot_chan<T,LOCK>::info_name() + "::reserved";
+        }
+
+        inline std::string name() const { return reserved::info_name(); }
+
+        inline std::string content() const {
+            std::stringstream ss;
+            ss << (void*)slot_;
+            return ss.str();
+        }
+
+        /// return whether a slot is reserved
+        inline explicit operator bool() const { return (bool)slot_; }
+
+        inline T& operator*() const { return *slot_; }
+        inline T* operator->() const { return slot_; }
+
+        /**
+         @brief make the slot available to consumers
+         @return true on success, else false if no slot is reserved or the channel is closed
+         */
+        inline bool commit() {
+            HCE_MIN_METHOD_ENTER("commit",(void*)slot_);
+
+            // already committed, or the reservation failed
+            if(!slot_) [[unlikely]] { return false; }
+
+            T* s = slot_;
+            slot_ = nullptr;
+            return context_->commit(s);
+        }
+
+    private:
+        // free a slot which was not committed
+        inline void abandon_() {
+            if(slot_) [[unlikely]] {
+                context_->release(slot_);
+                slot_ = nullptr;
+            }
+        }
+
+        std::shared_ptr<context> context_;
+        T* slot_ = nullptr;
+        friend struct slot_chan<T,LOCK>;
+    };
+
+    /// a slot borrowed by a consumer
+    struct borrowed : public printable {
+        borrowed() = default;
+        borrowed(const borrowed&) = delete;
+
+        borrowed(borrowed&& rhs) :
+            context_(std::move(rhs.context_)),
+            slot_(rhs.slot_)
+        {
+            rhs.slot_ = nullptr;
+        }
+
+        inline virtual ~borrowed(){ release(); }
+
+        borrowed& operator=(const borrowed&) = delete;
+
+        inline borrowed& operator=(borrowed&& rhs) {
+            if(this != &rhs) [[likely]] {
+                release();
+                context_ = std::move(rhs.context_);
+                slot_ = rhs.slot_;
+                rhs.slot_ = nullptr;
+            }
+
+            return *this;
+        }
+
+        static inline std::string info_name() {
+            return slot_chan<T,LOCK>::info_name() + "::borrowed";
+        }
+
+        inline std::string name() const { return borrowed::info_name(); }
+
+        inline std::string content() const {
+            std::stringstream ss;
+            ss << (void*)slot_;
+            return ss.str();
+        }
+
+        /// return whether a slot is borrowed
+        inline explicit operator bool() const { return (bool)slot_; }
+
+        inline T& operator*() const { return *slot_; }
+        inline T* operator->() const { return slot_; }
+
+        /// free the slot for producers to reuse, if one is borrowed
+        inline void release() {
+            if(slot_) [[likely]] {
+                HCE_MIN_METHOD_ENTER("release",(void*)slot_);
+                context_->release(slot_);
+                slot_ = nullptr;
+            }
+        }
+
+    private:
+        std::shared_ptr<context> context_;
+        T* slot_ = nullptr;
+        friend struct slot_chan<T,LOCK>;
+    };
+
+    slot_chan() = default;
+    slot_chan(const slot_chan<T,LOCK>&) = default;
+    slot_chan(slot_chan<T,LOCK>&&) = default;
+
+    inline virtual ~slot_chan(){ }
+
+    slot_chan<T,LOCK>& operator=(const slot_chan<T,LOCK>&) = default;
+    slot_chan<T,LOCK>& operator=(slot_chan<T,LOCK>&&) = default;
+
+    static inline std::string info_name() {
+        return type::templatize<T,LOCK>("hce::slot_chan");
+    }
+
+    inline std::string name() const { return slot_chan<T,LOCK>::info_name(); }
+
+    inline std::string content() const {
+        std::stringstream ss;
+        ss << context_.get();
+        return ss.str();
+    }
+
+    /// return whether the channel has an allocated context
+    inline explicit operator bool() const { return (bool)(context_); }
+
+    /**
+     @brief construct the channel's context
+     @param sz the count of slots, which is at least 1
+     */
+    inline slot_chan<T,LOCK>& construct(size_t sz) {
+        HCE_MIN_METHOD_ENTER("construct",sz);
+        context_ = std::make_shared<context>(sz ? sz : 1);
+        return *this;
+    }
+
+    /**
+     @brief inline construct a new slot_chan and its context
+     @return the constructed slot_chan
+     */
+    static inline slot_chan<T,LOCK> make(size_t sz) {
+        HCE_MIN_FUNCTION_ENTER(slot_chan<T,LOCK>::info_name() + "::make",sz);
+        slot_chan<T,LOCK> ch;
+        ch.construct(sz);
+        return ch;
+    }
+
+    /// return the count of slots
+    inline int size() const {
+        HCE_TRACE_METHOD_ENTER("size");
+        return (int)context_->queue.size();
+    }
+
+    /// return the count of committed slots which are not borrowed
+    inline int used() const {
+        HCE_TRACE_METHOD_ENTER("used");
+        std::lock_guard<LOCK> lk(context_->lk);
+        return (int)context_->queue.used();
+    }
+
+    inline bool closed() const {
+        HCE_TRACE_METHOD_ENTER("closed");
+        std::lock_guard<LOCK> lk(context_->lk);
+        return context_->closed_flag;
+    }
+
+    /**
+     @brief close the channel
+
+     Reserves and commits fail. Consumers can still borrow committed slots,
+     after which their borrows fail.
+     */
+    inline void close() {
+        HCE_MIN_METHOD_ENTER("close");
+        auto& ctx = *context_;
+        std::lock_guard<LOCK> lk(ctx.lk);
+
+        if(!ctx.closed_flag) [[likely]] {
+            ctx.closed_flag = true;
+
+            while(channel::detail::claim_front(ctx.parked_reserve)) {
+                ctx.parked_reserve.front()->resume(nullptr);
+                ctx.parked_reserve.pop();
+            }
+
+            while(channel::detail::claim_front(ctx.parked_borrow)) {
+                ctx.parked_borrow.front()->resume(nullptr);
+                ctx.parked_borrow.pop();
+            }
+        }
+    }
+
+    /**
+     @brief reserve a free slot
+
+     Any slot previously reserved by the argument is freed first.
+
+     @param r the reservation
+     @return an awaitable returning true on success, else false if closed
+     */
+    inline hce::awt<bool> reserve(reserved& r) {
+        HCE_MIN_METHOD_ENTER("reserve",(void*)&r);
+        r.abandon_();
+        r.context_ = context_;
+        return hce::awt<bool>(new reserve_interface(*context_, &(r.slot_)));
+    }
+
+    /**
+     @brief borrow the oldest committed slot
+
+     Any slot previously borrowed by the argument is released first.
+
+     @param b the borrow
+     @return an awaitable returning true on success, else false if the channel is closed and no committed slots remain
+     */
+    inline hce::awt<bool> borrow(borrowed& b) {
+        HCE_MIN_METHOD_ENTER("borrow",(void*)&b);
+        b.release();
+        b.context_ = context_;
+        return hce::awt<bool>(new borrow_interface(*context_, &(b.slot_)));
+    }
+
+private:
+    typedef hce::list<channel::detail::parked<hce::awaitable::interface>> PARKED;
+
+    struct context {
+        context(size_t sz) :
+            slots(new T[sz]),
+            free(sz),
+            queue(sz)
+        {
+            for(size_t i = 0; i < sz; ++i) { free.push(slots.get() + i); }
+        }
+
+        // make a reserved slot available to consumers
+        inline bool commit(T* s) {
+            std::lock_guard<LOCK> lk(this->lk);
+
+            if(closed_flag) [[unlikely]] {
+                free.push(s);
+                return false;
+            } else if(channel::detail::claim_front(parked_borrow)) {
+                parked_borrow.front()->resume((void*)s);
+                parked_borrow.pop();
+            } else [[likely]] {
+                queue.push(s);
+            }
+
+            return true;
+        }
+
+        // free a slot for reuse
+        inline void release(T* s) {
+            std::lock_guard<LOCK> lk(this->lk);
+
+            if(!closed_flag && channel::detail::claim_front(parked_reserve)) {
+                parked_reserve.front()->resume((void*)s);
+                parked_reserve.pop();
+            } else [[likely]] {
+                free.push(s);
+            }
+        }
+
+        // every slot is always in exactly one of free, queue, or a handle
+        mutable LOCK lk;
+        std::unique_ptr<T[]> slots;
+        hce::circular_buffer<T*> free; // slots which can be reserved
+        hce::circular_buffer<T*> queue; // committed slots
+        bool closed_flag = false;
+        PARKED parked_reserve;
+        PARKED parked_borrow;
+    };
+
+    // awaitable which acquires a slot for a reserved or borrowed handle
+    struct acquire_interface :
+        public hce::scheduler::reschedule<
+            hce::awaitable::lockable<
+                LOCK,
+                awt_interface<bool>>>
+    {
+        acquire_interface(context& c, T** destination) :
+            hce::scheduler::reschedule<
+                hce::awaitable::lockable<
+                    LOCK,
+                    awt_interface<bool>>>(
+                        c.lk,
+                        hce::awaitable::await::policy::defer,
+                        hce::awaitable::resume::policy::no_lock),
+            ctx(c),
+            destination_(destination)
+        { }
+
+        // m is the acquired slot, or null if the channel was closed
+        inline void on_resume(void* m) {
+            HCE_TRACE_METHOD_BODY("on_resume",m);
+            *destination_ = (T*)m;
+        }
+
+        inline bool get_result() {
+            HCE_MIN_METHOD_BODY("get_result",(void*)*destination_);
+            return (bool)*destination_;
+        }
+
+    protected:
+        // acquire the front of a list of slots
+        inline void acquire(hce::circular_buffer<T*>& slots) {
+            *destination_ = slots.front();
+            slots.pop();
+        }
+
+        context& ctx;
+
+    private:
+        T** destination_;
+    };
+
+    struct reserve_interface : public acquire_interface {
+        reserve_interface(context& c, T** destination) :
+            acquire_interface(c, destination)
+        { }
+
+        static inline std::string info_name() {
+            return slot_chan<T,LOCK>::info_name() + "::reserve_interface";
+        };
+
+        inline std::string name() const { return reserve_interface::info_name(); }
+
+        inline bool on_ready() {
+            if(this->ctx.closed_flag) [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("reserve","closed");
+                return true;
+            } else if(this->ctx.free.empty()) [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("reserve","blocked");
+                this->ctx.parked_reserve.push_back(this);
+                return false;
+            } else [[likely]] {
+                HCE_TRACE_METHOD_BODY("reserve","done");
+                this->acquire(this->ctx.free);
+                return true;
+            }
+        }
+    };
+
+    struct borrow_interface : public acquire_interface {
+        borrow_interface(context& c, T** destination) :
+            acquire_interface(c, destination)
+        { }
+
+        static inline std::string info_name() {
+            return slot_chan<T,LOCK>::info_name() + "::borrow_interface";
+        };
+
+        inline std::string name() const { return borrow_interface::info_name(); }
+
+        inline bool on_ready() {
+            if(!this->ctx.queue.empty()) [[likely]] {
+                HCE_TRACE_METHOD_BODY("borrow","done");
+                this->acquire(this->ctx.queue);
+                return true;
+            } else if(this->ctx.closed_flag) [[unlikely]] {
+                HCE_TRACE_METHOD_BODY("borrow","closed");
+                return true;
+            } else [[likely]] {
+                HCE_TRACE_METHOD_BODY("borrow","blocked");
+                this->ctx.parked_borrow.push_back(this);
+                return false;
+            }
+        }
+    };
+
+    std::shared_ptr<context> context_;
+};
+
+}
+
+#endif
@@ -3,7 +3,9 @@
 #ifndef HERMES_COROUTINE_ENGINE_TIMER
 #define HERMES_COROUTINE_ENGINE_TIMER
 
-#include <list>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
 #include <exception>
 #include <memory>
 #include <thread>
@@ -44,6 +46,28 @@ int thread_priority();
  */
 hce::chrono::duration busy_wait_threshold();
 
+/**
+ Wakeup overshoot (how late the timer service thread wakes up after a timed 
+ wait) varies greatly between hosts. When adaptive tuning is enabled the timer 
+ service continuously measures its own wakeup overshoot and tunes its 
+ busy-wait and early wakeup thresholds to match, within the bounds of 
+ busy_wait_threshold_minimum() and busy_wait_threshold_maximum(). In this case 
+ busy_wait_threshold() is only the initial threshold.
+
+ @return `true` if the timer service should tune its thresholds, else `false`
+ */
+bool adaptive();
+
+/**
+ @return the lowest busy-wait threshold adaptive tuning can select
+ */
+hce::chrono::duration busy_wait_threshold_minimum();
+
+/**
+ @return the highest busy-wait threshold adaptive tuning can select
+ */
+hce::chrono::duration busy_wait_threshold_maximum();
+
 /**
  The duration, in microseconds, that the timer service thread should 
  automatically wakeup *early* in order to increase precision of timeouts.
@@ -78,6 +102,28 @@ hce::chrono::duration early_wakeup_threshold();
  */
 hce::chrono::duration early_wakeup_long_threshold();
 
+/// strategies the timer service thread can use to wait for timeouts
+enum backend {
+    /**
+     Timed condition variable waits with early wakeups and busy-waiting close 
+     to timeouts. Available on all platforms.
+     */
+    condition_variable = 0,
+
+    /**
+     A Linux `timerfd` armed with the absolute time of the nearest timeout, 
+     waited on with `epoll_wait()`. Kernel high resolution timers make early 
+     wakeups and busy-waiting unnecessary. Falls back to condition_variable on 
+     other platforms or if the file descriptors cannot be created.
+     */
+    timerfd = 1
+};
+
+/**
+ @return the strategy the timer service thread should use to wait for timeouts
+ */
+hce::config::timer::backend service_backend();
+
 typedef hce::chrono::time_point (*algorithm_function_ptr)(
     const hce::chrono::time_point& now, 
     const hce::chrono::time_point& requested_timeout);
@@ -136,6 +182,42 @@ struct service : public hce::printable {
         return start_(sid, hce::chrono::now() + dur);
     }
 
+    /**
+     @brief function called by the timer service when a handler timer completes
+
+     The first argument is the user provided argument passed to start(). The 
+     second argument is `true` if the timeout was reached, else `false` if the 
+     timer was cancelled.
+     */
+    typedef void (*handler)(void* arg, bool timeout);
+
+    /**
+     @brief start a timer which calls a handler instead of resuming an awaitable
+
+     The handler is called by the timer service thread when the timeout is 
+     reached, or by the caller of cancel() when the timer is cancelled. A call 
+     to cancel() will not return while the timer's handler is executing on the 
+     timer service thread, so the owner of `arg` can safely destroy it after 
+     cancelling the timer. As a consequence, a handler must never cancel its 
+     own timer.
+
+     This is a building block for operations which race against a timeout, 
+     such as channel operations with a deadline.
+
+     @param sid to overwrite with the started timer sid 
+     @param timeout the time_point of the timer timeout
+     @param h the handler to call when the timer completes
+     @param arg the argument passed to the handler
+     */
+    void start(hce::sid& sid, 
+               const hce::chrono::time_point& timeout, 
+               handler h, 
+               void* arg) {
+        sid.make(); 
+        HCE_LOW_METHOD_ENTER("start", sid, timeout, (void*)h, arg);
+        start_(sid, timeout, h, arg);
+    }
+
     /**
      @return `true` if timer is running, else `false`
      */
@@ -146,14 +228,9 @@ struct service : public hce::printable {
         {
             std::lock_guard<hce::spinlock> lk(lk_);
 
-            if(running_) [[likely]] {
-                for(auto& t : timers_) {
-                    if(sid == t->sid) {
-                        HCE_LOW_METHOD_BODY("running","timer found");
-                        result = true;
-                        break;
-                    }
-                }
+            if(running_ && index_.find(sid.get())) [[likely]] {
+                HCE_LOW_METHOD_BODY("running","timer found");
+                result = true;
             }
         }
 
@@ -170,29 +247,33 @@ struct service : public hce::printable {
         bool result = false;
 
         if(sid) {
-            // let unique_ptr call destructor
-            std::unique_ptr<timer> t;
-
             std::unique_lock<hce::spinlock> lk(lk_);
 
             if(running_) [[likely]] {
-                auto it = timers_.begin();
-                auto end = timers_.end();
-
-                while(it != end) [[likely]] {
-                    // search through the timers for a matching sid
-                    if((*it)->sid == sid) [[unlikely]] {
-                        t.reset(*it);
-                        timers_.erase(it);
-                        notify_();
-                        lk.unlock();
-                       
-                        // do operations outside lock which don't require it
-                        result = true;
-                        t->awt->resume((void*)0); // cancel awaitable
+                timer* t = index_.erase(sid.get());
 
-                        HCE_LOW_METHOD_BODY("cancel","cancelled timer with ",sid);
-                        break;
+                if(t) [[likely]] {
+                    heap_erase_(t);
+                    notify_();
+
+                    // copy the handler so the node can be released
+                    handler h = t->h;
+                    void* arg = t->arg;
+                    deallocate_(t);
+                    lk.unlock();
+                   
+                    // do operations outside lock which don't require it
+                    result = true;
+                    h(arg, false); // cancel the timer
+
+                    HCE_LOW_METHOD_BODY("cancel","cancelled timer with ",sid);
+                } else [[unlikely]] {
+                    // the timer may be timing out right now, don't return 
+                    // until its handler has finished executing
+                    while(timing_out_(sid)) [[unlikely]] {
+                        lk.unlock();
+                        std::this_thread::yield();
+                        lk.lock();
                     }
                 }
             }
@@ -207,6 +288,11 @@ struct service : public hce::printable {
     struct ticks {
         size_t runtime; // microsecond ticks spent running
         size_t busywait; // microsecond ticks spent busy-waiting 
+
+        /// return the ratio of runtime spent busy-waiting, from 0.0 to 1.0
+        inline double busy_ratio() const {
+            return runtime ? ((double)busywait / (double)runtime) : 0.0;
+        }
     };
     
     /**
@@ -226,6 +312,56 @@ struct service : public hce::printable {
         micro_busywait_ticks_ = 0;
     }
 
+    /**
+     @brief timer service precision thresholds info struct
+     */
+    struct thresholds {
+        hce::chrono::duration busy_wait; // current busy-wait threshold
+        hce::chrono::duration early_wakeup; // current early wakeup threshold
+        hce::chrono::duration early_wakeup_long; // long early wakeup threshold
+        hce::chrono::duration overshoot; // smoothed wakeup overshoot
+        hce::chrono::duration overshoot_deviation; // smoothed deviation 
+    };
+
+    /// return the strategy the timer service thread uses to wait for timeouts
+    hce::config::timer::backend backend() const { 
+        return timerfd_ < 0 
+            ? hce::config::timer::backend::condition_variable
+            : hce::config::timer::backend::timerfd;
+    }
+
+    /**
+     The busy-wait and early wakeup thresholds will change over time if 
+     hce::config::timer::adaptive() is `true`. 
+
+     @return the timer service's current thresholds and overshoot measurements
+     */
+    thresholds get_thresholds() const {
+        std::lock_guard<hce::spinlock> lk(lk_);
+        return { 
+            busy_wait_threshold_, 
+            early_wakeup_threshold_, 
+            early_wakeup_long_threshold_,
+            overshoot_,
+            overshoot_deviation_
+        };
+    }
+
+    /**
+     @brief reset the thresholds to their configured initial values
+     */
+    void reset_thresholds() {
+        std::lock_guard<hce::spinlock> lk(lk_);
+        busy_wait_threshold_ = hce::config::timer::busy_wait_threshold();
+        early_wakeup_threshold_ = hce::config::timer::early_wakeup_threshold();
+        overshoot_ = hce::chrono::duration(0);
+        overshoot_deviation_ = busy_wait_threshold_ / 4;
+
+        if(adaptive_) [[likely]] { 
+            tune_thresholds_(); 
+        }
+    }
+
 private:
     // timer service awaitable implementation
     struct awaitable : public 
@@ -287,21 +423,147 @@ private:
         hce::spinlock slk_;
     };
 
-    // internal timer object
+    /*
+     Internal timer object. Timer nodes are allocated from the service's slab 
+     and are reused, they are never returned to the global allocator until the 
+     service is destroyed.
+     */
     struct timer {
-        timer(const hce::sid& s, 
-              const hce::chrono::time_point& t, 
-              hce::timer::service::awaitable* a) :
-            sid(s),
-            timeout(t),
-            awt(a)
-        { }
-
-        hce::sid sid;
+        std::uint64_t id;
         hce::chrono::time_point timeout;
-        hce::timer::service::awaitable* awt;
+        handler h;
+        void* arg;
+        size_t position; // index of the timer in the heap
+        timer* next; // intrusive link for the free and timed out lists
+
+        // return true if this timer should time out before the other
+        inline bool before(const timer* rhs) const {
+            return timeout < rhs->timeout || 
+                   (timeout == rhs->timeout && id < rhs->id);
+        }
+    };
+
+    /*
+     Open addressing hash index of running timers by id. 
+
+     Ids are generated by an incrementing counter, so the low bits of an id 
+     are already evenly distributed and are used directly as the hash. 
+     Collisions are resolved with robin hood linear probing, which keeps 
+     entries ordered by distance from their home slot. That lets erasures 
+     shift the following entries backward without tombstones and stop at the 
+     first entry already in its home slot. The table only allocates when it 
+     grows.
+     */
+    struct index {
+        index() : slots_(16, nullptr), size_(0) { }
+
+        // return the timer with the id, or nullptr if it is not found 
+        inline timer* find(std::uint64_t id) const {
+            const size_t i = slot_(id);
+            return i < slots_.size() ? slots_[i] : nullptr;
+        }
+
+        inline void insert(timer* t) {
+            // keep the load factor at or below 1/2
+            if((size_ + 1) * 2 > slots_.size()) [[unlikely]] { 
+                grow_(); 
+            }
+
+            place_(t);
+            ++size_;
+        }
+
+        // remove and return the timer with the id, or nullptr if not found
+        inline timer* erase(std::uint64_t id) {
+            size_t i = slot_(id);
+
+            if(i == slots_.size()) [[unlikely]] { return nullptr; }
+
+            const size_t mask = slots_.size() - 1;
+            timer* t = slots_[i];
+            --size_;
+
+            // shift following displaced entries back into the hole
+            while(true) {
+                const size_t j = (i + 1) & mask;
+                timer* next = slots_[j];
+
+                if(!next || distance_(next, j) == 0) { break; }
+
+                slots_[i] = next;
+                i = j;
+            }
+
+            slots_[i] = nullptr;
+            return t;
+        }
+
+    private:
+        // return the distance of the entry in slot i from its home slot
+        inline size_t distance_(const timer* t, size_t i) const {
+            return (i - (t->id & (slots_.size() - 1))) & (slots_.size() - 1);
+        }
+
+        // return the slot holding the id, or slots_.size() if not found
+        inline size_t slot_(std::uint64_t id) const {
+            const size_t mask = slots_.size() - 1;
+            size_t i = id & mask;
+            size_t dist = 0;
+
+            // an entry closer to its home than the id would be ends the run
+            while(slots_[i] && distance_(slots_[i], i) >= dist) {
+                if(slots_[i]->id == id) { return i; }
+                i = (i + 1) & mask;
+                ++dist;
+            }
+
+            return slots_.size();
+        }
+
+        inline void place_(timer* t) {
+            const size_t mask = slots_.size() - 1;
+            size_t i = t->id & mask;
+            size_t dist = 0;
+
+            while(slots_[i]) { 
+                // take the slot from entries closer to their home slot
+                const size_t existing = distance_(slots_[i], i);
+
+                if(existing < dist) {
+                    std::swap(t, slots_[i]);
+                    dist = existing;
+                }
+
+                i = (i + 1) & mask; 
+                ++dist;
+            }
+
+            slots_[i] = t;
+        }
+
+        inline void grow_() {
+            std::vector<timer*,hce::allocator<timer*>> old(
+                slots_.size() * 2, 
+                nullptr);
+            old.swap(slots_);
+
+            for(auto t : old) {
+                if(t) { place_(t); }
+            }
+        }
+
+        std::vector<timer*,hce::allocator<timer*>> slots_;
+        size_t size_;
     };
 
+    // the count of timer nodes allocated by the slab at a time
+    static constexpr size_t slab_chunk_size_ = 64;
+
+    // handler for timers started with an awaitable
+    static inline void resume_awaitable_(void* arg, bool timeout) {
+        ((hce::timer::service::awaitable*)arg)->resume((void*)timeout);
+    }
+
     /*
      The timer service thread doesn't start right away, because it's not a 
      thread that's guaranteed to be needed by user code. Instead, thread 
@@ -313,9 +575,36 @@ private:
         waiting_(false),
         micro_runtime_ticks_(0),
         micro_busywait_ticks_(0),
+        adaptive_(hce::config::timer::adaptive()),
+        busy_wait_threshold_minimum_(
+            hce::config::timer::busy_wait_threshold_minimum()),
+        busy_wait_threshold_maximum_(
+            std::max(busy_wait_threshold_minimum_,
+                     hce::config::timer::busy_wait_threshold_maximum())),
         busy_wait_threshold_(hce::config::timer::busy_wait_threshold()),
+        early_wakeup_threshold_(hce::config::timer::early_wakeup_threshold()),
+        early_wakeup_long_threshold_(
+            hce::config::timer::early_wakeup_long_threshold()),
+        early_wakeup_ratio_(
+            busy_wait_threshold_.count()
+            ? ((double)early_wakeup_threshold_.count() / 
+               (double)busy_wait_threshold_.count())
+            : 2.0),
+        overshoot_(0),
+        // seed the deviation so the configured threshold is the starting point
+        overshoot_deviation_(busy_wait_threshold_ / 4),
         timeout_algorithm_(hce::config::timer::timeout_algorithm())
     {
+        if(adaptive_) [[likely]] { 
+            tune_thresholds_(); 
+        }
+
+        if(hce::config::timer::service_backend() == 
+           hce::config::timer::backend::timerfd) [[unlikely]] 
+        {
+            timerfd_init_();
+        }
+
         service::instance_ = this;
         HCE_HIGH_CONSTRUCTOR();
     }
@@ -337,14 +626,14 @@ private:
         }
 
         // properly cancel and cleanup timers
-        while(timers_.size()) {
-            // let unique_ptr call destructor
-            std::unique_ptr<timer> t(timers_.front());
-            timers_.pop_front();
-            t->awt->resume((void*)0); // cancel awaitable
-
-            HCE_HIGH_METHOD_BODY("~service","cancelled timer with ", t->sid);
+        for(auto t : heap_) {
+            t->h(t->arg, false); // cancel the timer
+            HCE_HIGH_METHOD_BODY("~service","cancelled timer with ", t->id);
         }
+
+        // slab chunks are released by their unique_ptrs
+
+        if(timerfd_ >= 0) [[unlikely]] { timerfd_close_(); }
     }
 
     /*
@@ -373,16 +662,34 @@ private:
     {
         HCE_TRACE_METHOD_ENTER("start_",sid,timeout);
 
-        // allocate and construct the timer service awaitable
+        // allocate and construct the timer service awaitable, which uses the 
+        // calling thread's hce::memory cache
         auto awt = new hce::timer::service::awaitable;
+        start_(sid, timeout, &service::resume_awaitable_, awt);
+
+        // return the awaitable
+        return hce::awt<bool>(awt);
+    }
 
-        // allocate and construct timer using default `new` (don't need to steal 
-        // from calling thread's memory cache
-        timer* t = new timer(sid, timeout, awt);
+    // sid must be set at this point
+    inline void start_(
+            hce::sid& sid, 
+            const hce::chrono::time_point& timeout,
+            handler h,
+            void* arg)
+    {
+        HCE_TRACE_METHOD_ENTER("start_",sid,timeout,(void*)h,arg);
 
         {
             std::lock_guard<hce::spinlock> lk(lk_);
 
+            // acquire a timer node from the slab
+            timer* t = allocate_();
+            t->id = sid.get();
+            t->timeout = timeout;
+            t->h = h;
+            t->arg = arg;
+
             if(!running_) [[unlikely]] {
                 // launch the timer service thread if it was never started
                 running_ = true;
@@ -398,31 +705,200 @@ private:
                     hce::config::timer::thread_priority());
             }
 
-            timers_.push_back(t);
-            timers_.sort([](timer* lhs, timer* rhs) {
-                return lhs->timeout < rhs->timeout;
-            });
+            index_.insert(t);
+            heap_push_(t);
+
+            // only wake the service if the earliest timeout changed
+            if(heap_.front() == t) { notify_(); }
+        }
+    }
+
+    // return true if the timer with sid is currently having its handler called
+    inline bool timing_out_(const hce::sid& sid) {
+        for(timer* t = timed_out_; t; t = t->next) {
+            if(t->id == sid.get()) [[unlikely]] { return true; }
+        }
+
+        return false;
+    }
+
+    // acquire a timer node from the slab, growing it if it is empty
+    inline timer* allocate_() {
+        if(!free_) [[unlikely]] {
+            slab_.push_back(std::unique_ptr<timer[]>(
+                new timer[slab_chunk_size_]));
+            timer* chunk = slab_.back().get();
+
+            for(size_t i = 0; i < slab_chunk_size_; ++i) {
+                chunk[i].next = free_;
+                free_ = chunk + i;
+            }
+        }
+
+        timer* t = free_;
+        free_ = t->next;
+        return t;
+    }
 
-            notify_();
+    // return a timer node to the slab
+    inline void deallocate_(timer* t) {
+        t->next = free_;
+        free_ = t;
+    }
+
+    inline void heap_set_(size_t i, timer* t) {
+        heap_[i] = t;
+        t->position = i;
+    }
+
+    inline void heap_sift_up_(size_t i) {
+        timer* t = heap_[i];
+
+        while(i) {
+            size_t parent = (i - 1) / 2;
+
+            if(!t->before(heap_[parent])) { break; }
+
+            heap_set_(i, heap_[parent]);
+            i = parent;
         }
 
-        // return the awaitable
-        return hce::awt<bool>(awt);
+        heap_set_(i, t);
+    }
+
+    inline void heap_sift_down_(size_t i) {
+        timer* t = heap_[i];
+        const size_t size = heap_.size();
+
+        while(true) {
+            size_t child = (i * 2) + 1;
+
+            if(child >= size) { break; }
+
+            if(child + 1 < size && heap_[child + 1]->before(heap_[child])) {
+                ++child;
+            }
+
+            if(!heap_[child]->before(t)) { break; }
+
+            heap_set_(i, heap_[child]);
+            i = child;
+        }
+
+        heap_set_(i, t);
+    }
+
+    inline void heap_push_(timer* t) {
+        heap_.push_back(t);
+        heap_sift_up_(heap_.size() - 1);
+    }
+
+    // remove an arbitrary timer from the heap
+    inline void heap_erase_(timer* t) {
+        const size_t i = t->position;
+        timer* last = heap_.back();
+        heap_.pop_back();
+
+        if(last != t) [[likely]] {
+            heap_set_(i, last);
+
+            if(i && last->before(heap_[(i - 1) / 2])) {
+                heap_sift_up_(i);
+            } else {
+                heap_sift_down_(i);
+            }
+        }
+    }
+
+    /*
+     Update the smoothed overshoot estimates with a new wakeup overshoot 
+     sample and retune the thresholds. 
+
+     This is the same estimator TCP uses for round trip times: the mean moves 
+     1/8th of the way toward each sample and the deviation moves 1/4th of the 
+     way toward each sample's error. 
+     */
+    inline void tune_(const hce::chrono::duration& sample) {
+        const hce::chrono::duration err = sample - overshoot_;
+        overshoot_ += err / 8;
+        overshoot_deviation_ += 
+            ((err < hce::chrono::duration(0) ? -err : err) - 
+             overshoot_deviation_) / 4;
+        tune_thresholds_();
+    }
+
+    /*
+     The busy-wait threshold covers the mean overshoot plus four deviations, 
+     so nearly all wakeups aimed at the start of the busy-wait window land 
+     before the timeout. The early wakeup threshold keeps its configured ratio 
+     to the busy-wait threshold.
+     */
+    inline void tune_thresholds_() {
+        busy_wait_threshold_ = std::clamp(
+            overshoot_ + (overshoot_deviation_ * 4),
+            busy_wait_threshold_minimum_,
+            busy_wait_threshold_maximum_);
+
+        early_wakeup_threshold_ = std::clamp(
+            std::chrono::duration_cast<hce::chrono::duration>(
+                busy_wait_threshold_ * early_wakeup_ratio_),
+            busy_wait_threshold_,
+            std::max(busy_wait_threshold_, early_wakeup_long_threshold_));
     }
 
     inline void notify_() {
         if(waiting_) {
             waiting_ = false;
-            cv_.notify_one();
+
+            if(timerfd_ < 0) [[likely]] { 
+                cv_.notify_one(); 
+            } else [[unlikely]] { 
+                timerfd_notify_(); 
+            }
         } 
     }
 
+    /*
+     The timerfd backend is implemented in the source file to keep platform 
+     headers out of this header. On unsupported platforms timerfd_init_() 
+     leaves timerfd_ negative, so the condition_variable backend is used.
+     */
+
+    // create the timerfd, eventfd and epoll file descriptors
+    void timerfd_init_();
+
+    // close the file descriptors
+    void timerfd_close_();
+
+    // wake the service thread from timerfd_wait_()
+    void timerfd_notify_();
+
+    /*
+     Unlock the lock and wait until the timeout is reached or notify_() is 
+     called, then re-acquire the lock. A timeout of `nullptr` waits only for 
+     notify_(). Returns `true` if the timeout was reached.
+     */
+    bool timerfd_wait_(std::unique_lock<hce::spinlock>& lk, 
+                       const hce::chrono::time_point* timeout);
+
+    // update the overshoot estimates after a timed wait reached its timeout
+    inline void measure_overshoot_(const hce::chrono::time_point& timeout) {
+        if(adaptive_) [[likely]] {
+            auto overshoot = hce::chrono::now() - timeout;
+
+            if(overshoot > hce::chrono::duration(0)) [[likely]] {
+                tune_(overshoot);
+            } else [[unlikely]] {
+                tune_(hce::chrono::duration(0));
+            }
+        }
+    }
+
     inline void run() {
         HCE_HIGH_METHOD_ENTER("run");
         hce::chrono::time_point now = hce::chrono::now();
         hce::chrono::time_point prev = now;
         hce::chrono::time_point timeout;
-        hce::list<hce::timer::service::awaitable*> timed_out;
 
         auto update_now = [&](bool busy){ 
             prev = now;
@@ -448,36 +924,46 @@ private:
         // the high level service run loop, which continues till process exit
         while(running_) [[likely]] {
             // check for any ready timers 
-            if(timers_.size()) [[unlikely]] {
+            if(heap_.size()) [[unlikely]] {
                 // update the current timepoint 
                 update_now(false);
-                auto it = timers_.begin();
-                auto end = timers_.end();
 
                 auto timeout_ready = [&] {
-                    return it != end && (*it)->timeout <= now;
+                    return heap_.size() && heap_.front()->timeout <= now;
                 };
 
                 // check if a timer is ready to timeout
                 if(timeout_ready()) [[unlikely]] {
+                    timer** tail = &timed_out_;
+
+                    // move the ready timers in timeout order to the timed out 
+                    // list, where cancel() can observe them while their 
+                    // handlers execute
                     do {
-                        // let unique_ptr call destructor
-                        std::unique_ptr<timer> t(*it);
-                        // handle timeout callbacks outside lock
-                        timed_out.push_back(t->awt);
-                        it = timers_.erase(it);
+                        timer* t = heap_.front();
+                        heap_erase_(t);
+                        index_.erase(t->id);
+                        t->next = nullptr;
+                        *tail = t;
+                        tail = &(t->next);
                     } while(timeout_ready()); 
 
-                    // resume awaitables outside the lock
+                    // handle timeout callbacks outside the lock
                     lk.unlock();
 
-                    do {
-                        timed_out.front()->resume((void*)1); // resume awaitable
-                        timed_out.pop();
-                    } while(timed_out.size()); [[likely]]
+                    for(timer* t = timed_out_; t; t = t->next) [[likely]] {
+                        t->h(t->arg, true); // complete the timer
+                    }
 
                     // re-acquire the lock
                     lk.lock();
+
+                    // return the timers to the slab
+                    do {
+                        timer* t = timed_out_;
+                        timed_out_ = t->next;
+                        deallocate_(t);
+                    } while(timed_out_);
                 } else [[likely]] {
                     auto below_busy_wait_threshold = [&]{
                         // only ever need to wait if we haven't reached timeout
@@ -492,9 +978,17 @@ private:
                     };
                            
                     // update latest timeout to the latest timeout
-                    timeout = timers_.front()->timeout;
+                    timeout = heap_.front()->timeout;
+
+                    if(timerfd_ >= 0) [[unlikely]] {
+                        // the kernel wakes the thread precisely enough to 
+                        // wait for the timeout directly
+                        waiting_ = true;
 
-                    if(below_busy_wait_threshold()) [[unlikely]] {
+                        if(timerfd_wait_(lk, &timeout)) [[likely]] {
+                            measure_overshoot_(timeout);
+                        }
+                    } else if(below_busy_wait_threshold()) [[unlikely]] {
                         // spend as much time busy waiting as possible unlocked
                         lk_.unlock();
 
@@ -505,8 +999,10 @@ private:
 
                             lk_.lock();
                             // update latest timeout each check because the lock 
-                            // is not held
-                            timeout = timers_.front()->timeout;
+                            // is not held, timers may have been cancelled
+                            timeout = heap_.size() 
+                                ? heap_.front()->timeout 
+                                : now;
                             lk_.unlock();
 
                             // don't actually need to lock during this check
@@ -523,13 +1019,23 @@ private:
 
                         // wait till timeout
                         waiting_ = true;
-                        cv_.wait_until(lk, timeout);
+
+                        if(cv_.wait_until(lk, timeout) == 
+                           std::cv_status::timeout) [[likely]] 
+                        {
+                            measure_overshoot_(timeout);
+                        }
                     }
                 }
             } else {
                 // wait for something to happen
                 waiting_ = true;
-                cv_.wait(lk);
+
+                if(timerfd_ < 0) [[likely]] {
+                    cv_.wait(lk);
+                } else [[unlikely]] {
+                    timerfd_wait_(lk, nullptr);
+                }
             }
         }
 
@@ -543,9 +1049,24 @@ private:
     bool waiting_; // help guard against unnecessary system calls
     size_t micro_runtime_ticks_;
     size_t micro_busywait_ticks_;
-    const hce::chrono::duration busy_wait_threshold_;
+    const bool adaptive_;
+    const hce::chrono::duration busy_wait_threshold_minimum_;
+    const hce::chrono::duration busy_wait_threshold_maximum_;
+    hce::chrono::duration busy_wait_threshold_;
+    hce::chrono::duration early_wakeup_threshold_;
+    hce::chrono::duration early_wakeup_long_threshold_;
+    const double early_wakeup_ratio_;
+    hce::chrono::duration overshoot_;
+    hce::chrono::duration overshoot_deviation_;
     std::condition_variable_any cv_;
-    std::list<timer*,hce::allocator<timer*>> timers_;
+    int timerfd_ = -1; // timerfd backend file descriptors
+    int eventfd_ = -1;
+    int epollfd_ = -1;
+    std::vector<std::unique_ptr<timer[]>> slab_; // timer node chunks
+    timer* free_ = nullptr; // slab free list
+    std::vector<timer*,hce::allocator<timer*>> heap_; // min-heap of timers
+    index index_; // running timers by id
+    timer* timed_out_ = nullptr; // timers with executing handlers
     std::thread thd_;
     hce::config::timer::algorithm_function_ptr timeout_algorithm_;
 
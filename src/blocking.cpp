@@ -2,3 +2,15 @@
 #include "lifecycle.hpp"
 
 hce::blocking::service* hce::blocking::service::instance_ = nullptr;
+
+std::shared_ptr<hce::blocking::service::local_cache>& 
+hce::blocking::service::tl_local_cache_() {
+    // retire the thread's cached workers when the thread exits
+    struct holder {
+        ~holder() { service::release_local_cache_(cache); }
+        std::shared_ptr<local_cache> cache;
+    };
+
+    thread_local holder h;
+    return h.cache;
+}
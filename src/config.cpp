@@ -25,6 +25,7 @@
 #include "scheduler.hpp"
 #include "timer.hpp"
 #include "blocking.hpp"
+#include "io.hpp"
 #include "channel.hpp"
 #include "threadpool.hpp"
 #include "lifecycle.hpp"
@@ -72,6 +73,14 @@ size_t hce::config::blocking::reusable_block_worker_cache_size() {
     return hce::lifecycle::config::blocking::get().reusable_block_worker_cache_size;
 }
 
+size_t hce::config::blocking::worker_limit() {
+    return hce::lifecycle::config::blocking::get().worker_limit;
+}
+
+hce::chrono::duration hce::config::blocking::worker_keepalive() {
+    return hce::lifecycle::config::blocking::get().worker_keepalive;
+}
+
 int hce::config::timer::thread_priority() {
     return hce::lifecycle::config::timer::get().priority;
 }
@@ -80,6 +89,18 @@ hce::chrono::duration hce::config::timer::busy_wait_threshold() {
     return hce::lifecycle::config::timer::get().busy_wait_threshold;
 }
 
+bool hce::config::timer::adaptive() {
+    return hce::lifecycle::config::timer::get().adaptive;
+}
+
+hce::chrono::duration hce::config::timer::busy_wait_threshold_minimum() {
+    return hce::lifecycle::config::timer::get().busy_wait_threshold_minimum;
+}
+
+hce::chrono::duration hce::config::timer::busy_wait_threshold_maximum() {
+    return hce::lifecycle::config::timer::get().busy_wait_threshold_maximum;
+}
+
 hce::chrono::duration hce::config::timer::early_wakeup_threshold() {
     return hce::lifecycle::config::timer::get().early_wakeup_threshold;
 }
@@ -88,6 +109,18 @@ hce::chrono::duration hce::config::timer::early_wakeup_long_threshold() {
     return hce::lifecycle::config::timer::get().early_wakeup_long_threshold;
 }
 
+hce::config::timer::backend hce::config::timer::service_backend() {
+    return hce::lifecycle::config::timer::get().backend;
+}
+
 hce::config::timer::algorithm_function_ptr hce::config::timer::timeout_algorithm() {
     return hce::lifecycle::config::timer::get().algorithm;
 }
+
+hce::config::io::backend hce::config::io::service_backend() {
+    return hce::lifecycle::config::io::get().backend;
+}
+
+size_t hce::config::io::io_uring_entries() {
+    return hce::lifecycle::config::io::get().io_uring_entries;
+}
@@ -0,0 +1,736 @@
+//SPDX-License-Identifier: MIT
+//Author: Blayne Dennis
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#endif
+
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <optional>
+#include <algorithm>
+
+#include "io.hpp"
+#include "blocking.hpp"
+#include "scheduler.hpp"
+#include "lifecycle.hpp"
+
+hce::io::service* hce::io::service::instance_ = nullptr;
+
+namespace hce {
+namespace io {
+namespace detail {
+
+// Linux limits a single read or write to this many bytes
+constexpr size_t max_rw_count = 0x7ffff000;
+
+// the system call result of an operation as a negative errno on failure
+template <typename T>
+inline T result(T r) { return r < 0 ? -errno : r; }
+
+// an operation's completion handler, identified by an io_uring user_data or
+// registered with a scheduler's reactor
+using completion = hce::detail::scheduler::completion;
+
+// awaitable for a single io_uring operation
+template <typename T>
+struct operation : public scheduler::reschedule<operation_partial<T>> {
+    operation() {
+        HCE_MED_CONSTRUCTOR();
+        c_.complete = &operation<T>::complete_;
+        c_.ctx = this;
+    }
+
+    virtual ~operation() { HCE_MED_DESTRUCTOR(); }
+
+    static inline std::string info_name() {
+        return type::templatize<T>("hce::io::detail::operation");
+    }
+
+    inline std::string name() const { return operation<T>::info_name(); }
+
+    inline completion* get_completion() { return &c_; }
+
+    // storage for a path which must outlive the operation's submission
+    std::string path;
+
+private:
+    static inline void complete_(void* ctx, int res) {
+        auto o = static_cast<operation<T>*>(ctx);
+        o->t_.emplace(res);
+        o->resume(nullptr);
+    }
+
+    completion c_;
+};
+
+}
+}
+}
+
+#ifdef __linux__
+struct hce::io::service::ring : public printable {
+    ring() { HCE_HIGH_CONSTRUCTOR(); }
+
+    virtual ~ring() {
+        HCE_HIGH_DESTRUCTOR();
+
+        if(thd.joinable()) [[likely]] {
+            // the completion thread exits after the final completion
+            running.store(false, std::memory_order_release);
+            io_uring_sqe sqe{};
+            sqe.opcode = IORING_OP_NOP;
+            submit(sqe, nullptr);
+            thd.join();
+        }
+
+        if(sqes) { munmap(sqes, sqes_size); }
+        if(cq_ptr && cq_ptr != sq_ptr) { munmap(cq_ptr, cq_size); }
+        if(sq_ptr) { munmap(sq_ptr, sq_size); }
+        if(fd >= 0) { ::close(fd); }
+    }
+
+    static inline std::string info_name() {
+        return "hce::io::service::ring";
+    }
+
+    inline std::string name() const { return ring::info_name(); }
+
+    // create and map the io_uring instance, returning false on failure
+    bool init(unsigned entries) {
+        io_uring_params p{};
+        fd = (int)syscall(__NR_io_uring_setup, entries, &p);
+
+        if(fd < 0) [[unlikely]] { return false; }
+
+        // completions must not be dropped and submissions are consumed
+        // during io_uring_enter()
+        if(!(p.features & IORING_FEAT_NODROP) ||
+           !(p.features & IORING_FEAT_SUBMIT_STABLE)) [[unlikely]]
+        {
+            errno = ENOSYS;
+            return false;
+        }
+
+        sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cq_size = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+
+        if(p.features & IORING_FEAT_SINGLE_MMAP) [[likely]] {
+            sq_size = cq_size = std::max(sq_size, cq_size);
+        }
+
+        sq_ptr = map_(sq_size, IORING_OFF_SQ_RING);
+
+        if(!sq_ptr) [[unlikely]] { return false; }
+
+        if(p.features & IORING_FEAT_SINGLE_MMAP) [[likely]] {
+            cq_ptr = sq_ptr;
+        } else [[unlikely]] {
+            cq_ptr = map_(cq_size, IORING_OFF_CQ_RING);
+
+            if(!cq_ptr) [[unlikely]] { return false; }
+        }
+
+        sqes_size = p.sq_entries * sizeof(io_uring_sqe);
+        sqes = (io_uring_sqe*)map_(sqes_size, IORING_OFF_SQES);
+
+        if(!sqes) [[unlikely]] { return false; }
+
+        char* sq = (char*)sq_ptr;
+        char* cq = (char*)cq_ptr;
+        sq_head = (unsigned*)(sq + p.sq_off.head);
+        sq_tail = (unsigned*)(sq + p.sq_off.tail);
+        sq_mask = *(unsigned*)(sq + p.sq_off.ring_mask);
+        sq_entries = p.sq_entries;
+        sq_array = (unsigned*)(sq + p.sq_off.array);
+        cq_head = (unsigned*)(cq + p.cq_off.head);
+        cq_tail = (unsigned*)(cq + p.cq_off.tail);
+        cq_mask = *(unsigned*)(cq + p.cq_off.ring_mask);
+        cqes = (io_uring_cqe*)(cq + p.cq_off.cqes);
+
+        return supported_();
+    }
+
+    /*
+     Submit an operation, returning false with errno set on failure. 
+
+     The entry is written under `lk_`, which is only held long enough to 
+     copy it into the ring. io_uring_enter() is called under `enter_lk_`, a 
+     blocking mutex, so threads waiting for the kernel sleep instead of 
+     spinning. Each call submits every entry published so far, so a thread 
+     whose entry was already consumed by another thread's call returns 
+     without a system call.
+     */
+    bool submit(const io_uring_sqe& sqe, detail::completion* c) {
+        unsigned tail;
+
+        {
+            std::unique_lock<hce::spinlock> lk(lk_);
+
+            while(true) {
+                tail = *sq_tail;
+
+                if(tail - std::atomic_ref<unsigned>(*sq_head).load(
+                       std::memory_order_acquire) < sq_entries) [[likely]] 
+                {
+                    break;
+                }
+
+                // an entry the kernel has not consumed must not be 
+                // overwritten, so submit the published entries first
+                lk.unlock();
+
+                {
+                    std::lock_guard<std::mutex> elk(enter_lk_);
+                    if(!enter_(tail)) [[unlikely]] { return false; }
+                }
+
+                lk.lock();
+            }
+
+            unsigned idx = tail & sq_mask;
+
+            sqes[idx] = sqe;
+            sqes[idx].user_data = (__u64)c;
+            sq_array[idx] = idx;
+
+            if(c) [[likely]] { ++outstanding; }
+
+            std::atomic_ref<unsigned>(*sq_tail).store(
+                tail + 1,
+                std::memory_order_release);
+        }
+
+        std::lock_guard<std::mutex> elk(enter_lk_);
+
+        if(enter_(tail + 1)) [[likely]] {
+            return true;
+        } else [[unlikely]] {
+            int err = errno;
+            std::lock_guard<hce::spinlock> lk(lk_);
+
+            // enter_() failed before the kernel consumed the entry, and no 
+            // other io_uring_enter() can consume it while `enter_lk_` is held
+            if(*sq_tail == tail + 1) [[likely]] {
+                std::atomic_ref<unsigned>(*sq_tail).store(
+                    tail,
+                    std::memory_order_release);
+            } else [[unlikely]] {
+                // later entries were published, so leave a no-op in its place
+                unsigned idx = tail & sq_mask;
+                sqes[idx] = io_uring_sqe{};
+                sqes[idx].opcode = IORING_OP_NOP;
+                sqes[idx].user_data = 0;
+            }
+
+            if(c) [[likely]] { --outstanding; }
+
+            errno = err;
+            return false;
+        }
+    }
+
+    // submit an operation's awaitable, completing it immediately on failure
+    template <typename T>
+    inline hce::awt<T> submit(io_uring_sqe& sqe, detail::operation<T>* op) {
+        detail::completion* c = op->get_completion();
+
+        if(!submit(sqe, c)) [[unlikely]] {
+            c->complete(c->ctx, -errno);
+        }
+
+        return hce::awt<T>(op);
+    }
+
+    // completion thread run function
+    void run() {
+        while(true) {
+            unsigned head = *cq_head;
+            unsigned tail = std::atomic_ref<unsigned>(*cq_tail).load(
+                std::memory_order_acquire);
+
+            while(head != tail) {
+                io_uring_cqe* cqe = &(cqes[head & cq_mask]);
+                auto c = (detail::completion*)cqe->user_data;
+                int res = cqe->res;
+                ++head;
+
+                // release the entry before resuming the operation
+                std::atomic_ref<unsigned>(*cq_head).store(
+                    head,
+                    std::memory_order_release);
+
+                if(c) [[likely]] {
+                    --outstanding;
+                    c->complete(c->ctx, res);
+                }
+            }
+
+            if(!running.load(std::memory_order_acquire) &&
+               !outstanding.load()) [[unlikely]]
+            {
+                break;
+            }
+
+            // wait for at least one completion
+            syscall(__NR_io_uring_enter,
+                    fd,
+                    0,
+                    1,
+                    IORING_ENTER_GETEVENTS,
+                    nullptr,
+                    0);
+        }
+    }
+
+    int fd = -1;
+    std::atomic<size_t> outstanding{0};
+    std::atomic<bool> running{true};
+    std::thread thd;
+
+private:
+    /*
+     Call io_uring_enter() until the kernel has consumed every submission 
+     entry before `tail`. A successful call can consume fewer entries than 
+     requested, in which case the remainder are submitted again. Every 
+     published entry is submitted, including those after `tail`. Returns 
+     false with errno set on failure. `enter_lk_` must be held.
+     */
+    inline bool enter_(unsigned tail) {
+        while(true) {
+            unsigned head = std::atomic_ref<unsigned>(*sq_head).load(
+                std::memory_order_acquire);
+
+            if((int)(tail - head) <= 0) [[likely]] { return true; }
+
+            unsigned pending = std::atomic_ref<unsigned>(*sq_tail).load(
+                std::memory_order_acquire) - head;
+
+            int r = (int)syscall(
+                __NR_io_uring_enter, fd, pending, 0, 0, nullptr, 0);
+
+            if(r > 0) [[likely]] {
+                continue;
+            } else if(r == 0 || 
+                      errno == EINTR || 
+                      errno == EAGAIN || 
+                      errno == EBUSY) 
+            {
+                // the completion thread is draining a full completion queue
+                std::this_thread::yield();
+            } else [[unlikely]] {
+                return false;
+            }
+        }
+    }
+
+    inline void* map_(size_t size, off_t offset) {
+        void* p = mmap(nullptr,
+                       size,
+                       PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE,
+                       fd,
+                       offset);
+        return p == MAP_FAILED ? nullptr : p;
+    }
+
+    // verify the kernel supports every operation this service submits
+    inline bool supported_() {
+        const size_t ops = 256;
+        const size_t size =
+            sizeof(io_uring_probe) + ops * sizeof(io_uring_probe_op);
+        std::unique_ptr<char[]> buf(new char[size]());
+        auto probe = (io_uring_probe*)buf.get();
+
+        if(syscall(__NR_io_uring_register,
+                   fd,
+                   IORING_REGISTER_PROBE,
+                   probe,
+                   ops) < 0) [[unlikely]]
+        {
+            return false;
+        }
+
+        for(int op : { IORING_OP_NOP,
+                       IORING_OP_READ,
+                       IORING_OP_WRITE,
+                       IORING_OP_FSYNC,
+                       IORING_OP_OPENAT })
+        {
+            if(op > probe->last_op ||
+               !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) [[unlikely]]
+            {
+                errno = ENOSYS;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // synchronizes writing submission entries from all threads
+    hce::spinlock lk_;
+
+    // serializes io_uring_enter() submissions, which can wait on the kernel
+    std::mutex enter_lk_;
+
+    unsigned* sq_head = nullptr;
+    unsigned* sq_tail = nullptr;
+    unsigned sq_mask = 0;
+    unsigned sq_entries = 0;
+    unsigned* sq_array = nullptr;
+    io_uring_sqe* sqes = nullptr;
+
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned cq_mask = 0;
+    io_uring_cqe* cqes = nullptr;
+
+    void* sq_ptr = nullptr;
+    size_t sq_size = 0;
+    void* cq_ptr = nullptr;
+    size_t cq_size = 0;
+    size_t sqes_size = 0;
+};
+#else
+struct hce::io::service::ring { };
+#endif
+
+hce::io::service::service() {
+    HCE_HIGH_CONSTRUCTOR();
+
+#ifdef __linux__
+    if(hce::config::io::service_backend() ==
+       hce::config::io::backend::io_uring) [[likely]]
+    {
+        std::unique_ptr<ring> r(new ring);
+
+        if(r->init((unsigned)hce::config::io::io_uring_entries())) [[likely]] {
+            r->thd = std::thread(&ring::run, r.get());
+            ring_ = std::move(r);
+        } else [[unlikely]] {
+            HCE_WARNING_METHOD_BODY(
+                "service",
+                "falling back to blocking backend: ",
+                std::strerror(errno));
+        }
+    }
+#endif
+
+    service::instance_ = this;
+}
+
+hce::io::service::~service() {
+    HCE_HIGH_DESTRUCTOR();
+    service::instance_ = nullptr;
+
+    // waits for outstanding operations and joins the completion thread
+    ring_.reset();
+}
+
+hce::config::io::backend hce::io::service::backend() const {
+    return ring_
+        ? hce::config::io::backend::io_uring
+        : hce::config::io::backend::blocking;
+}
+
+size_t hce::io::service::outstanding() const {
+#ifdef __linux__
+    return ring_ ? ring_->outstanding.load() : 0;
+#else
+    return 0;
+#endif
+}
+
+hce::awt<hce::io::file> hce::io::file::openat(int dirfd,
+                                              std::string path,
+                                              int flags,
+                                              mode_t mode) {
+    HCE_MED_FUNCTION_ENTER("hce::io::file::openat", dirfd, path, flags, mode);
+
+#ifdef __linux__
+    auto& s = service::get();
+
+    if(s.ring_) [[likely]] {
+        auto op = new detail::operation<file>;
+        op->path = std::move(path);
+
+        io_uring_sqe sqe{};
+        sqe.opcode = IORING_OP_OPENAT;
+        sqe.fd = dirfd;
+        sqe.addr = (__u64)op->path.c_str();
+        sqe.len = mode;
+        sqe.open_flags = (__u32)(flags | O_CLOEXEC);
+        return s.ring_->submit(sqe, op);
+    }
+#endif
+
+    return hce::block([=]{
+        return file(detail::result(
+            ::openat(dirfd, path.c_str(), flags | O_CLOEXEC, mode)));
+    });
+}
+
+hce::awt<hce::io::file> hce::io::file::open(std::string path,
+                                            int flags,
+                                            mode_t mode) {
+    return file::openat(AT_FDCWD, std::move(path), flags, mode);
+}
+
+hce::awt<ssize_t> hce::io::file::read(void* buf, size_t len, off_t offset) {
+    HCE_MED_METHOD_ENTER("read", buf, len, offset);
+    len = std::min(len, detail::max_rw_count);
+
+#ifdef __linux__
+    auto& s = service::get();
+
+    if(s.ring_) [[likely]] {
+        io_uring_sqe sqe{};
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = fd_;
+        sqe.addr = (__u64)buf;
+        sqe.len = (__u32)len;
+        sqe.off = (__u64)offset;
+        return s.ring_->submit(sqe, new detail::operation<ssize_t>);
+    }
+#endif
+
+    int fd = fd_;
+
+    return hce::block([=]{
+        return detail::result(::pread(fd, buf, len, offset));
+    });
+}
+
+hce::awt<ssize_t> hce::io::file::write(const void* buf,
+                                       size_t len,
+                                       off_t offset) {
+    HCE_MED_METHOD_ENTER("write", buf, len, offset);
+    len = std::min(len, detail::max_rw_count);
+
+#ifdef __linux__
+    auto& s = service::get();
+
+    if(s.ring_) [[likely]] {
+        io_uring_sqe sqe{};
+        sqe.opcode = IORING_OP_WRITE;
+        sqe.fd = fd_;
+        sqe.addr = (__u64)buf;
+        sqe.len = (__u32)len;
+        sqe.off = (__u64)offset;
+        return s.ring_->submit(sqe, new detail::operation<ssize_t>);
+    }
+#endif
+
+    int fd = fd_;
+
+    return hce::block([=]{
+        return detail::result(::pwrite(fd, buf, len, offset));
+    });
+}
+
+hce::awt<int> hce::io::file::fsync() {
+    HCE_MED_METHOD_ENTER("fsync");
+
+#ifdef __linux__
+    auto& s = service::get();
+
+    if(s.ring_) [[likely]] {
+        io_uring_sqe sqe{};
+        sqe.opcode = IORING_OP_FSYNC;
+        sqe.fd = fd_;
+        return s.ring_->submit(sqe, new detail::operation<int>);
+    }
+#endif
+
+    int fd = fd_;
+    return hce::block([=]{ return detail::result(::fsync(fd)); });
+}
+
+void hce::io::file::close() {
+    if(fd_ >= 0) [[likely]] {
+        hce::io::cancel(fd_);
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+hce::awt<int> hce::io::service::ready_(int fd, bool write) {
+    if(hce::scheduler::in()) [[likely]] {
+        auto& sch = hce::scheduler::local();
+
+        if(sch.reactor()) [[likely]] {
+            auto op = new detail::operation<int>;
+            hce::awt<int> awt(op);
+            int err = hce::detail::scheduler::reactor_register(
+                fd, write, op->get_completion());
+
+            if(err) [[unlikely]] {
+                // epoll rejects descriptors which are always ready, such as 
+                // regular files
+                op->get_completion()->complete(op, err == EPERM ? 0 : -err);
+            }
+
+            return awt;
+        }
+    }
+
+    return hce::block([=]{
+        pollfd p{};
+        p.fd = fd;
+        p.events = write ? POLLOUT : POLLIN;
+        int r;
+
+        do {
+            r = ::poll(&p, 1, -1);
+        } while(r < 0 && errno == EINTR);
+
+        if(r < 0) [[unlikely]] { 
+            return -errno; 
+        } else if(p.revents & POLLNVAL) [[unlikely]] {
+            return -EBADF;
+        } else [[likely]] {
+            return 0;
+        }
+    });
+}
+
+hce::awt<int> hce::io::readable(int fd) {
+    HCE_MED_FUNCTION_ENTER("hce::io::readable", fd);
+    return service::ready_(fd, false);
+}
+
+hce::awt<int> hce::io::writable(int fd) {
+    HCE_MED_FUNCTION_ENTER("hce::io::writable", fd);
+    return service::ready_(fd, true);
+}
+
+void hce::io::cancel(int fd) {
+    HCE_MED_FUNCTION_ENTER("hce::io::cancel", fd);
+    hce::detail::scheduler::reactor_deregister(fd);
+}
+
+hce::awt<ssize_t> hce::io::sendfile(int out_fd, 
+                                    int in_fd, 
+                                    off_t offset, 
+                                    size_t count) 
+{
+    HCE_MED_FUNCTION_ENTER("hce::io::sendfile", out_fd, in_fd, offset, count);
+
+#ifdef __linux__
+    return detail::perform<ssize_t>(
+        { out_fd, true },
+        [=, sent=(size_t)0]() mutable -> std::optional<ssize_t> {
+            while(sent < count) {
+                off_t off = offset + (off_t)sent;
+                ssize_t r = ::sendfile(out_fd, 
+                                       in_fd, 
+                                       &off, 
+                                       std::min(count - sent, 
+                                                detail::max_rw_count));
+
+                if(r > 0) [[likely]] {
+                    sent += r;
+                } else if(r == 0) [[unlikely]] {
+                    // the end of in_fd
+                    break;
+                } else if(errno == EINTR) [[unlikely]] {
+                    continue;
+                } else if(errno == EAGAIN) {
+                    return std::nullopt;
+                } else if(sent) [[unlikely]] {
+                    // report the bytes already transferred, like write(), 
+                    // the error is returned by the next call
+                    break;
+                } else {
+                    return -errno;
+                }
+            }
+
+            return (ssize_t)sent;
+        });
+#else
+    return detail::perform<ssize_t>(
+        { -1, true }, 
+        []{ return std::optional<ssize_t>(-ENOSYS); });
+#endif
+}
+
+hce::awt<ssize_t> hce::io::splice(int in_fd, 
+                                  off_t in_offset, 
+                                  int out_fd, 
+                                  off_t out_offset, 
+                                  size_t count) 
+{
+    HCE_MED_FUNCTION_ENTER("hce::io::splice", 
+                           in_fd, 
+                           in_offset, 
+                           out_fd, 
+                           out_offset, 
+                           count);
+
+#ifdef __linux__
+    return detail::perform<ssize_t>(
+        { out_fd, true },
+        [=, moved=(size_t)0](detail::readiness& rd) 
+        mutable -> std::optional<ssize_t> 
+        {
+            while(moved < count) {
+                loff_t in_off = in_offset + (loff_t)moved;
+                loff_t out_off = out_offset + (loff_t)moved;
+                ssize_t r = ::splice(in_fd, 
+                                     in_offset < 0 ? nullptr : &in_off,
+                                     out_fd,
+                                     out_offset < 0 ? nullptr : &out_off,
+                                     std::min(count - moved, 
+                                              detail::max_rw_count),
+                                     SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+
+                if(r > 0) [[likely]] {
+                    moved += r;
+                } else if(r == 0) [[unlikely]] {
+                    // the end of in_fd
+                    break;
+                } else if(errno == EINTR) [[unlikely]] {
+                    continue;
+                } else if(errno == EAGAIN) {
+                    // either side can block, await the one which isn't ready
+                    pollfd p[2] = {};
+                    p[0].fd = in_fd;
+                    p[0].events = POLLIN;
+                    p[1].fd = out_fd;
+                    p[1].events = POLLOUT;
+                    ::poll(p, 2, 0);
+
+                    if(p[0].revents) {
+                        rd = { out_fd, true };
+                    } else {
+                        rd = { in_fd, false };
+                    }
+
+                    return std::nullopt;
+                } else if(moved) [[unlikely]] {
+                    // report the bytes already moved, like write(), the 
+                    // error is returned by the next call
+                    break;
+                } else {
+                    return -errno;
+                }
+            }
+
+            return (ssize_t)moved;
+        });
+#else
+    return detail::perform<ssize_t>(
+        { -1, true }, 
+        []{ return std::optional<ssize_t>(-ENOSYS); });
+#endif
+}
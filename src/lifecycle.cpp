@@ -89,8 +89,19 @@
 #endif 
 
 // the limit of reusable block workers shared among the entire process
-#ifndef HCEPROCESSREUSABLEBLOCKWORKERPROCESSLIMIT
-#define HCEPROCESSREUSABLEBLOCKWORKERPROCESSLIMIT 1
+#ifndef HCEREUSABLEBLOCKWORKERCACHESIZE
+#define HCEREUSABLEBLOCKWORKERCACHESIZE 1
+#endif
+
+// the maximum count of block worker threads executing blocking calls at once, 
+// 0 for no limit
+#ifndef HCEBLOCKWORKERLIMIT
+#define HCEBLOCKWORKERLIMIT 0
+#endif
+
+// how long idle block workers beyond the reusable count persist
+#ifndef HCEBLOCKWORKERKEEPALIVEMILLISECONDS
+#define HCEBLOCKWORKERKEEPALIVEMILLISECONDS 10000
 #endif
 
 // the limit of reusable block workers for the global scheduler cache
@@ -103,6 +114,11 @@
 #define HCEREUSABLEBLOCKWORKERDEFAULTSCHEDULERLIMIT 0
 #endif 
 
+// the limit of reusable block workers for threadpool scheduler caches
+#ifndef HCEREUSABLEBLOCKWORKERTHREADPOOLLIMIT
+#define HCEREUSABLEBLOCKWORKERTHREADPOOLLIMIT 1
+#endif 
+
 /*
  The count of threadpool schedulers. A value greater than 1 will cause the 
  threadpool to launch count-1 schedulers (the global scheduler is always the 
@@ -113,6 +129,15 @@
 #define HCETHREADPOOLSCHEDULERCOUNT 0
 #endif
 
+/*
+ If 1 the global and threadpool schedulers wait for work in an epoll reactor, 
+ so hce::net and hce::io readiness operations on them suspend instead of 
+ occupying a blocking worker. Unsupported platforms ignore this value.
+ */
+#ifndef HCESCHEDULERREACTOR
+#define HCESCHEDULERREACTOR 1
+#endif
+
 // the limit of reusable coroutine resources for in threadpool schedulers
 #ifndef HCEREUSABLECOROUTINEHANDLETHREADPOOLLIMIT
 #define HCEREUSABLECOROUTINEHANDLETHREADPOOLLIMIT HCEREUSABLECOROUTINEHANDLEDEFAULTSCHEDULERLIMIT
@@ -122,6 +147,22 @@
 #define HCETIMERBUSYWAITMICROSECONDTHRESHOLD 5000
 #endif
 
+#ifndef HCETIMERBACKEND
+#define HCETIMERBACKEND 0
+#endif
+
+#ifndef HCETIMERADAPTIVE
+#define HCETIMERADAPTIVE 1
+#endif
+
+#ifndef HCETIMERBUSYWAITMICROSECONDMINIMUM
+#define HCETIMERBUSYWAITMICROSECONDMINIMUM 100
+#endif
+
+#ifndef HCETIMERBUSYWAITMICROSECONDMAXIMUM
+#define HCETIMERBUSYWAITMICROSECONDMAXIMUM 10000
+#endif
+
 #ifndef HCETIMEREARLYWAKEUPMICROSECONDTHRESHOLD
 #define HCETIMEREARLYWAKEUPMICROSECONDTHRESHOLD 10000
 #endif
@@ -130,6 +171,14 @@
 #define HCETIMEREARLYWAKEUPMICROSECONDLONGTHRESHOLD 250000
 #endif
 
+#ifndef HCEIOBACKEND
+#define HCEIOBACKEND 1
+#endif
+
+#ifndef HCEIOURINGENTRIES
+#define HCEIOURINGENTRIES 256
+#endif
+
 hce::spinlock hce::lifecycle::slk_;
 hce::lifecycle* hce::lifecycle::instance_ = nullptr;
 
@@ -143,6 +192,7 @@ hce::lifecycle::config::threadpool hce::lifecycle::config::threadpool::global_(
     hce::lifecycle::config::memory::global_);
 hce::lifecycle::config::blocking hce::lifecycle::config::blocking::global_;
 hce::lifecycle::config::timer hce::lifecycle::config::timer::global_;
+hce::lifecycle::config::io hce::lifecycle::config::io::global_;
 
 hce::lifecycle::config::logging::logging() :
     loglevel(HCELOGLEVEL)
@@ -230,6 +280,8 @@ info::impl info::scheduler_impl_("scheduler", info::bucket_count_, info::schedul
 hce::config::scheduler::config::config() :
     loglevel(HCELOGLEVEL),
     reusable_coroutine_handle_limit(HCEREUSABLECOROUTINEHANDLEDEFAULTSCHEDULERLIMIT),
+    reusable_block_worker_limit(HCEREUSABLEBLOCKWORKERDEFAULTSCHEDULERLIMIT),
+    reactor(false),
     // pull directly from the global memory config
     cache_info(hce::lifecycle::config::memory::global_.scheduler) 
 { }
@@ -250,6 +302,8 @@ hce::lifecycle::config::scheduler::scheduler(const hce::lifecycle::config::memor
         hce::config::scheduler::config c;
         c.loglevel = HCELOGLEVEL;
         c.reusable_coroutine_handle_limit = HCEREUSABLECOROUTINEHANDLEGLOBALSCHEDULERLIMIT;
+        c.reusable_block_worker_limit = HCEREUSABLEBLOCKWORKERGLOBALSCHEDULERLIMIT;
+        c.reactor = HCESCHEDULERREACTOR;
         c.cache_info = m.global;
         return c;
     }())
@@ -261,6 +315,8 @@ hce::lifecycle::config::threadpool::threadpool(const hce::lifecycle::config::mem
         hce::config::scheduler::config c;
         c.loglevel = HCELOGLEVEL;
         c.reusable_coroutine_handle_limit = HCEREUSABLECOROUTINEHANDLETHREADPOOLLIMIT;
+        c.reusable_block_worker_limit = HCEREUSABLEBLOCKWORKERTHREADPOOLLIMIT;
+        c.reactor = HCESCHEDULERREACTOR;
         c.cache_info = m.scheduler;
         return c;
     }()),
@@ -268,7 +324,10 @@ hce::lifecycle::config::threadpool::threadpool(const hce::lifecycle::config::mem
 { }
 
 hce::lifecycle::config::blocking::blocking() :
-     reusable_block_worker_cache_size(HCEREUSABLEBLOCKWORKERCACHESIZE)
+     reusable_block_worker_cache_size(HCEREUSABLEBLOCKWORKERCACHESIZE),
+     worker_limit(HCEBLOCKWORKERLIMIT),
+     worker_keepalive(
+        std::chrono::milliseconds(HCEBLOCKWORKERKEEPALIVEMILLISECONDS))
 { }
 
 hce::lifecycle::config::timer::timer() :
@@ -290,15 +349,28 @@ hce::lifecycle::config::timer::timer() :
     busy_wait_threshold(
         std::chrono::microseconds(
             HCETIMERBUSYWAITMICROSECONDTHRESHOLD)),
+    adaptive(HCETIMERADAPTIVE),
+    busy_wait_threshold_minimum(
+        std::chrono::microseconds(
+            HCETIMERBUSYWAITMICROSECONDMINIMUM)),
+    busy_wait_threshold_maximum(
+        std::chrono::microseconds(
+            HCETIMERBUSYWAITMICROSECONDMAXIMUM)),
     early_wakeup_threshold(
         std::chrono::microseconds(
             HCETIMEREARLYWAKEUPMICROSECONDTHRESHOLD)),
     early_wakeup_long_threshold(
         std::chrono::microseconds(
             HCETIMEREARLYWAKEUPMICROSECONDLONGTHRESHOLD)),
+    backend((hce::config::timer::backend)HCETIMERBACKEND),
     algorithm(&(hce::timer::service::default_timeout_algorithm))
 { }
 
+hce::lifecycle::config::io::io() :
+    backend((hce::config::io::backend)HCEIOBACKEND),
+    io_uring_entries(HCEIOURINGENTRIES)
+{ }
+
 hce::lifecycle::logging_init::logging_init() {
     struct do_once {
         do_once() {
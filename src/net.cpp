@@ -0,0 +1,438 @@
+//SPDX-License-Identifier: MIT
+//Author: Blayne Dennis
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include "net.hpp"
+#include "io.hpp"
+
+// platforms without MSG_NOSIGNAL report SIGPIPE with their own mechanisms
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace hce {
+namespace net {
+namespace detail {
+
+// set O_NONBLOCK on a descriptor if it isn't already, returning 0 or an errno
+inline int set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL);
+
+    if(flags < 0) [[unlikely]] {
+        return errno;
+    } else if(flags & O_NONBLOCK) [[likely]] {
+        return 0;
+    } else if(fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) [[unlikely]] {
+        return errno;
+    } else [[likely]] {
+        return 0;
+    }
+}
+
+// create a non-blocking close-on-exec socket, returning it or a negative errno
+inline int make_socket(int family, int type) {
+#ifdef SOCK_NONBLOCK
+    int fd = ::socket(family, type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    return fd < 0 ? -errno : fd;
+#else
+    int fd = ::socket(family, type, 0);
+
+    if(fd < 0) [[unlikely]] { return -errno; }
+
+    int err = set_nonblocking(fd);
+
+    if(err) [[unlikely]] {
+        ::close(fd);
+        return -err;
+    }
+
+    return fd;
+#endif
+}
+
+// the result of a failed system call which would block
+inline bool would_block() { return errno == EAGAIN || errno == EWOULDBLOCK; }
+
+}
+}
+}
+
+hce::net::address::address(const sockaddr* sa, socklen_t size) :
+    size_(std::min(size, (socklen_t)sizeof(storage_)))
+{
+    std::memset(&storage_, 0, sizeof(storage_));
+    std::memcpy(&storage_, sa, size_);
+}
+
+std::string hce::net::address::content() const {
+    std::stringstream ss;
+    char buf[INET6_ADDRSTRLEN];
+
+    switch(family()) {
+        case AF_INET:
+            inet_ntop(AF_INET,
+                      &(((const sockaddr_in*)&storage_)->sin_addr),
+                      buf,
+                      sizeof(buf));
+            ss << buf << ":" << port();
+            break;
+        case AF_INET6:
+            inet_ntop(AF_INET6,
+                      &(((const sockaddr_in6*)&storage_)->sin6_addr),
+                      buf,
+                      sizeof(buf));
+            ss << "[" << buf << "]:" << port();
+            break;
+        case AF_UNIX:
+            ss << ((const sockaddr_un*)&storage_)->sun_path;
+            break;
+        default:
+            ss << "invalid";
+            break;
+    }
+
+    return ss.str();
+}
+
+hce::net::address hce::net::address::ip(const std::string& host,
+                                        uint16_t port) {
+    address a;
+    std::memset(&a.storage_, 0, sizeof(a.storage_));
+    auto in = (sockaddr_in*)&a.storage_;
+    auto in6 = (sockaddr_in6*)&a.storage_;
+
+    if(inet_pton(AF_INET, host.c_str(), &(in->sin_addr)) == 1) {
+        in->sin_family = AF_INET;
+        in->sin_port = htons(port);
+        a.size_ = sizeof(sockaddr_in);
+    } else if(inet_pton(AF_INET6, host.c_str(), &(in6->sin6_addr)) == 1) {
+        in6->sin6_family = AF_INET6;
+        in6->sin6_port = htons(port);
+        a.size_ = sizeof(sockaddr_in6);
+    } else [[unlikely]] {
+        a.storage_.ss_family = AF_UNSPEC;
+    }
+
+    return a;
+}
+
+hce::net::address hce::net::address::local(const std::string& path) {
+    address a;
+    std::memset(&a.storage_, 0, sizeof(a.storage_));
+    auto un = (sockaddr_un*)&a.storage_;
+
+    if(path.size() < sizeof(un->sun_path)) [[likely]] {
+        un->sun_family = AF_UNIX;
+        std::memcpy(un->sun_path, path.c_str(), path.size() + 1);
+        a.size_ = offsetof(sockaddr_un, sun_path) + path.size() + 1;
+    } else [[unlikely]] {
+        a.storage_.ss_family = AF_UNSPEC;
+    }
+
+    return a;
+}
+
+uint16_t hce::net::address::port() const {
+    switch(family()) {
+        case AF_INET:
+            return ntohs(((const sockaddr_in*)&storage_)->sin_port);
+        case AF_INET6:
+            return ntohs(((const sockaddr_in6*)&storage_)->sin6_port);
+        default:
+            return 0;
+    }
+}
+
+hce::net::stream::stream(int fd) :
+    fd_(fd < 0 ? -1 : fd),
+    error_(fd < 0 ? -fd : 0)
+{
+    if(fd_ >= 0) [[likely]] {
+        int err = detail::set_nonblocking(fd_);
+
+        if(err) [[unlikely]] {
+            close();
+            error_ = err;
+        }
+    }
+}
+
+hce::awt<hce::net::stream> hce::net::stream::connect(const address& a) {
+    HCE_MED_FUNCTION_ENTER("hce::net::stream::connect", a);
+    int fd = a ? detail::make_socket(a.family(), SOCK_STREAM) : -EINVAL;
+
+    if(fd < 0) [[unlikely]] {
+        return hce::io::detail::perform<stream>(
+            {-1, true}, 
+            [fd]() -> std::optional<stream> { return stream(fd); });
+    }
+
+    return hce::io::detail::perform<stream>(
+        {fd, true},
+        [fd, a, started=false]() mutable -> std::optional<stream> {
+            int err = 0;
+
+            if(!started) [[likely]] {
+                started = true;
+
+                if(::connect(fd, a.data(), a.size()) == 0) [[unlikely]] {
+                    return stream(fd);
+                } else if(errno == EINPROGRESS || errno == EINTR) [[likely]] {
+                    // the connection completes asynchronously
+                    return std::nullopt;
+                } else [[unlikely]] {
+                    err = errno;
+                }
+            } else {
+                socklen_t len = sizeof(err);
+
+                if(getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0) {
+                    err = errno;
+                }
+            }
+
+            if(err) [[unlikely]] {
+                ::close(fd);
+                return stream(-err);
+            }
+
+            return stream(fd);
+        });
+}
+
+std::pair<hce::net::stream,hce::net::stream> hce::net::stream::pair() {
+    int fds[2];
+
+    if(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) [[unlikely]] {
+        int err = errno;
+        return std::pair<stream,stream>(stream(-err), stream(-err));
+    }
+
+    return std::pair<stream,stream>(stream(fds[0]), stream(fds[1]));
+}
+
+hce::awt<ssize_t> hce::net::stream::read_some(void* buf, size_t len) {
+    HCE_MED_METHOD_ENTER("read_some", buf, len);
+    const int fd = fd_;
+
+    return hce::io::detail::perform<ssize_t>(
+        {fd, false},
+        [fd, buf, len]() -> std::optional<ssize_t> {
+            while(true) {
+                ssize_t r = ::recv(fd, buf, len, 0);
+
+                if(r >= 0) [[likely]] {
+                    return r;
+                } else if(errno == EINTR) [[unlikely]] {
+                    continue;
+                } else if(detail::would_block()) {
+                    return std::nullopt;
+                } else [[unlikely]] {
+                    return -errno;
+                }
+            }
+        });
+}
+
+hce::awt<ssize_t> hce::net::stream::write_all(const void* buf, size_t len) {
+    HCE_MED_METHOD_ENTER("write_all", buf, len);
+    const int fd = fd_;
+
+    return hce::io::detail::perform<ssize_t>(
+        {fd, true},
+        [fd, buf, len, written=(size_t)0]() mutable -> std::optional<ssize_t> {
+            while(written < len) {
+                ssize_t r = ::send(fd,
+                                   (const char*)buf + written,
+                                   len - written,
+                                   MSG_NOSIGNAL);
+
+                if(r >= 0) [[likely]] {
+                    written += r;
+                } else if(errno == EINTR) [[unlikely]] {
+                    continue;
+                } else if(detail::would_block()) {
+                    return std::nullopt;
+                } else [[unlikely]] {
+                    return -errno;
+                }
+            }
+
+            return (ssize_t)len;
+        });
+}
+
+hce::awt<ssize_t> hce::net::stream::readv(const iovec* iov, int count) {
+    HCE_MED_METHOD_ENTER("readv", iov, count);
+    const int fd = fd_;
+
+    return hce::io::detail::perform<ssize_t>(
+        {fd, false},
+        [fd, v=std::vector<iovec>(iov, iov + count)]()
+        -> std::optional<ssize_t>
+        {
+            while(true) {
+                ssize_t r = ::readv(fd, v.data(), (int)v.size());
+
+                if(r >= 0) [[likely]] {
+                    return r;
+                } else if(errno == EINTR) [[unlikely]] {
+                    continue;
+                } else if(detail::would_block()) {
+                    return std::nullopt;
+                } else [[unlikely]] {
+                    return -errno;
+                }
+            }
+        });
+}
+
+hce::awt<ssize_t> hce::net::stream::writev(const iovec* iov, int count) {
+    HCE_MED_METHOD_ENTER("writev", iov, count);
+    const int fd = fd_;
+    ssize_t total = 0;
+
+    for(int i=0; i<count; ++i) { total += (ssize_t)iov[i].iov_len; }
+
+    return hce::io::detail::perform<ssize_t>(
+        {fd, true},
+        [fd, total, v=std::vector<iovec>(iov, iov + count), first=(size_t)0]()
+        mutable -> std::optional<ssize_t>
+        {
+            while(true) {
+                // skip the buffers which have been completely written
+                while(first < v.size() && v[first].iov_len == 0) { ++first; }
+
+                if(first == v.size()) [[unlikely]] { return total; }
+
+                msghdr msg{};
+                msg.msg_iov = v.data() + first;
+                msg.msg_iovlen = v.size() - first;
+                ssize_t r = ::sendmsg(fd, &msg, MSG_NOSIGNAL);
+
+                if(r >= 0) [[likely]] {
+                    // advance past the written bytes
+                    for(size_t i=first; r && i<v.size(); ++i) {
+                        size_t n = std::min((size_t)r, v[i].iov_len);
+                        v[i].iov_base = (char*)v[i].iov_base + n;
+                        v[i].iov_len -= n;
+                        r -= n;
+                    }
+                } else if(errno == EINTR) [[unlikely]] {
+                    continue;
+                } else if(detail::would_block()) {
+                    return std::nullopt;
+                } else [[unlikely]] {
+                    return -errno;
+                }
+            }
+        });
+}
+
+int hce::net::stream::shutdown(int how) {
+    return ::shutdown(fd_, how) < 0 ? -errno : 0;
+}
+
+hce::net::address hce::net::stream::peer_address() const {
+    sockaddr_storage ss;
+    socklen_t len = sizeof(ss);
+
+    if(::getpeername(fd_, (sockaddr*)&ss, &len) < 0) [[unlikely]] {
+        return address();
+    }
+
+    return address((const sockaddr*)&ss, len);
+}
+
+void hce::net::stream::close() {
+    if(fd_ >= 0) [[likely]] {
+        hce::io::cancel(fd_);
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+hce::net::listener hce::net::listener::bind(const address& a, int backlog) {
+    HCE_MED_FUNCTION_ENTER("hce::net::listener::bind", a, backlog);
+    listener l;
+    int fd = a ? detail::make_socket(a.family(), SOCK_STREAM) : -EINVAL;
+
+    if(fd < 0) [[unlikely]] {
+        l.error_ = -fd;
+        return l;
+    }
+
+    if(a.family() == AF_INET || a.family() == AF_INET6) {
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    }
+
+    if(::bind(fd, a.data(), a.size()) < 0 || ::listen(fd, backlog) < 0) {
+        l.error_ = errno;
+        ::close(fd);
+    } else [[likely]] {
+        l.fd_ = fd;
+    }
+
+    return l;
+}
+
+hce::awt<hce::net::stream> hce::net::listener::accept() {
+    HCE_MED_METHOD_ENTER("accept");
+    const int fd = fd_;
+
+    return hce::io::detail::perform<stream>(
+        {fd, false},
+        [fd]() -> std::optional<stream> {
+            while(true) {
+#ifdef SOCK_NONBLOCK
+                int s = ::accept4(fd,
+                                  nullptr,
+                                  nullptr,
+                                  SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+                int s = ::accept(fd, nullptr, nullptr);
+#endif
+
+                if(s >= 0) [[likely]] {
+                    return stream(s);
+                } else if(errno == EINTR || errno == ECONNABORTED) {
+                    continue;
+                } else if(detail::would_block()) {
+                    return std::nullopt;
+                } else [[unlikely]] {
+                    return stream(-errno);
+                }
+            }
+        });
+}
+
+hce::net::address hce::net::listener::local_address() const {
+    sockaddr_storage ss;
+    socklen_t len = sizeof(ss);
+
+    if(::getsockname(fd_, (sockaddr*)&ss, &len) < 0) [[unlikely]] {
+        return address();
+    }
+
+    return address((const sockaddr*)&ss, len);
+}
+
+void hce::net::listener::close() {
+    if(fd_ >= 0) [[likely]] {
+        hce::io::cancel(fd_);
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
@@ -1,5 +1,13 @@
 //SPDX-License-Identifier: MIT
 //Author: Blayne Dennis 
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+#include <cerrno>
 #include <memory>
 #include <unordered_set>
 
@@ -23,3 +31,238 @@ hce::detail::scheduler::tl_this_scheduler_local_queue() {
     thread_local std::unique_ptr<hce::list<std::coroutine_handle<>>>* tllq = nullptr;
     return tllq;
 }
+
+int hce::detail::scheduler::reactor_register(int fd, 
+                                             bool write, 
+                                             completion* c) 
+{
+    return tl_this_scheduler()->reactor_register_(fd, write, c);
+}
+
+void hce::detail::scheduler::reactor_deregister(int fd) {
+    hce::scheduler* sch = tl_this_scheduler();
+
+    if(sch && sch->reactor()) [[unlikely]] { sch->reactor_deregister_(fd); }
+}
+
+#ifdef __linux__
+namespace hce {
+namespace detail {
+namespace scheduler {
+
+/*
+ Arm a descriptor's oneshot registration for its remaining waiters. The 
+ descriptor is usually still registered from a previous wait, otherwise it is 
+ added. Returns 0 on success, else an errno value.
+ */
+inline int reactor_arm(int epollfd, 
+                       int fd, 
+                       completion* reader, 
+                       completion* writer) 
+{
+    epoll_event ev{};
+    ev.events = EPOLLONESHOT | 
+                (reader ? EPOLLIN | EPOLLRDHUP : 0) | 
+                (writer ? EPOLLOUT : 0);
+    ev.data.fd = fd;
+
+    if(epoll_ctl(epollfd, EPOLL_CTL_MOD, fd, &ev) == 0) [[likely]] { 
+        return 0; 
+    } else if(errno == ENOENT && 
+              epoll_ctl(epollfd, EPOLL_CTL_ADD, fd, &ev) == 0) 
+    {
+        return 0;
+    } else [[unlikely]] {
+        return errno;
+    }
+}
+
+}
+}
+}
+
+void hce::scheduler::reactor_init_() {
+    reactor_eventfd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    reactor_epollfd_ = epoll_create1(EPOLL_CLOEXEC);
+
+    bool success = reactor_eventfd_ >= 0 && reactor_epollfd_ >= 0;
+
+    if(success) [[likely]] {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = reactor_eventfd_;
+        success = 
+            epoll_ctl(reactor_epollfd_, 
+                      EPOLL_CTL_ADD, 
+                      reactor_eventfd_, 
+                      &ev) == 0;
+    }
+
+    if(!success) [[unlikely]] {
+        HCE_ERROR_METHOD_BODY(
+            "reactor_init_",
+            "falling back to condition_variable backend: ",
+            std::strerror(errno));
+        reactor_close_();
+    }
+}
+
+void hce::scheduler::reactor_close_() {
+    for(int* fd : { &reactor_eventfd_, &reactor_epollfd_ }) {
+        if(*fd >= 0) { 
+            close(*fd); 
+            *fd = -1;
+        }
+    }
+}
+
+void hce::scheduler::reactor_notify_() {
+    uint64_t one = 1;
+
+    // a full eventfd counter means the scheduler thread will wake anyway
+    [[maybe_unused]] auto r = write(reactor_eventfd_, &one, sizeof(one));
+}
+
+void hce::scheduler::reactor_wait_(std::unique_lock<hce::spinlock>& lk, 
+                                   int timeout) 
+{
+    // coroutines_notify_() writes the eventfd, so no wakeup is lost while 
+    // unlocked
+    lk.unlock();
+
+    epoll_event events[64];
+    int n = epoll_wait(reactor_epollfd_, events, 64, timeout);
+
+    for(int i=0; i<n; ++i) {
+        const int fd = events[i].data.fd;
+
+        if(fd == reactor_eventfd_) [[unlikely]] {
+            // drain the descriptor so it stops being readable
+            uint64_t count;
+            [[maybe_unused]] auto r = read(fd, &count, sizeof(count));
+            continue;
+        }
+
+        auto it = reactor_waiters_.find(fd);
+
+        if(it == reactor_waiters_.end()) [[unlikely]] { continue; }
+
+        const uint32_t e = events[i].events;
+        auto& w = it->second;
+        detail::scheduler::completion* reader = nullptr;
+        detail::scheduler::completion* writer = nullptr;
+
+        // errors and hangups are reported to every waiter, whose next system 
+        // call on the descriptor will return the condition
+        if(w.reader && (e & (EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP))) {
+            reader = w.reader;
+            w.reader = nullptr;
+        }
+
+        if(w.writer && (e & (EPOLLOUT | EPOLLERR | EPOLLHUP))) {
+            writer = w.writer;
+            w.writer = nullptr;
+        }
+
+        if(w.reader || w.writer) [[unlikely]] {
+            // the oneshot registration must be rearmed for the remaining 
+            // waiter
+            int err = detail::scheduler::reactor_arm(
+                reactor_epollfd_, fd, w.reader, w.writer);
+
+            if(err) [[unlikely]] {
+                auto r = w.reader;
+                auto wr = w.writer;
+                reactor_waiters_.erase(it);
+                if(r) { r->complete(r->ctx, -err); }
+                if(wr) { wr->complete(wr->ctx, -err); }
+            }
+        } else [[likely]] {
+            reactor_waiters_.erase(it);
+        }
+
+        // completions reschedule onto the local queue
+        if(reader) { reader->complete(reader->ctx, 0); }
+        if(writer) { writer->complete(writer->ctx, 0); }
+    }
+
+    lk.lock();
+}
+
+int hce::scheduler::reactor_register_(int fd, 
+                                      bool write, 
+                                      detail::scheduler::completion* c) 
+{
+    // a halted scheduler will never wait on its reactor again
+    if(reactor_cancelled_) [[unlikely]] { return ECANCELED; }
+
+    auto& w = reactor_waiters_[fd];
+    auto& slot = write ? w.writer : w.reader;
+
+    // only one waiter in each direction is supported per descriptor
+    if(slot) [[unlikely]] { return EBUSY; }
+
+    slot = c;
+    int err = detail::scheduler::reactor_arm(
+        reactor_epollfd_, fd, w.reader, w.writer);
+
+    if(err) [[unlikely]] {
+        slot = nullptr;
+
+        if(!(w.reader || w.writer)) { reactor_waiters_.erase(fd); }
+    }
+
+    return err;
+}
+
+void hce::scheduler::reactor_deregister_(int fd) {
+    // the descriptor may still be registered from a previous wait
+    epoll_ctl(reactor_epollfd_, EPOLL_CTL_DEL, fd, nullptr);
+
+    auto it = reactor_waiters_.find(fd);
+
+    if(it != reactor_waiters_.end()) [[unlikely]] {
+        auto w = it->second;
+        reactor_waiters_.erase(it);
+        if(w.reader) { w.reader->complete(w.reader->ctx, -ECANCELED); }
+        if(w.writer) { w.writer->complete(w.writer->ctx, -ECANCELED); }
+    }
+}
+
+void hce::scheduler::reactor_cancel_() {
+    reactor_cancelled_ = true;
+
+    // completions cannot register new waiters, so the map can be traded
+    auto waiters = std::move(reactor_waiters_);
+    reactor_waiters_.clear();
+
+    for(auto& [fd, w] : waiters) {
+        epoll_ctl(reactor_epollfd_, EPOLL_CTL_DEL, fd, nullptr);
+        if(w.reader) { w.reader->complete(w.reader->ctx, -ECANCELED); }
+        if(w.writer) { w.writer->complete(w.writer->ctx, -ECANCELED); }
+    }
+}
+#else 
+void hce::scheduler::reactor_init_() {
+    HCE_ERROR_METHOD_BODY(
+        "reactor_init_",
+        "epoll is unsupported, falling back to condition_variable backend");
+}
+
+void hce::scheduler::reactor_close_() { }
+void hce::scheduler::reactor_notify_() { }
+
+void hce::scheduler::reactor_wait_(std::unique_lock<hce::spinlock>& lk, 
+                                   int timeout) 
+{ }
+
+int hce::scheduler::reactor_register_(int fd, 
+                                      bool write, 
+                                      detail::scheduler::completion* c) 
+{
+    return ENOSYS;
+}
+
+void hce::scheduler::reactor_deregister_(int fd) { }
+void hce::scheduler::reactor_cancel_() { }
+#endif
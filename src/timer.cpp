@@ -1,5 +1,14 @@
 //SPDX-License-Identifier: MIT
 //Author: Blayne Dennis 
+#ifdef __linux__
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
 #include "timer.hpp"
 #include "lifecycle.hpp"
 
@@ -9,9 +18,12 @@ hce::chrono::time_point hce::timer::service::default_timeout_algorithm(
         const hce::chrono::time_point& now, 
         const hce::chrono::time_point& requested_timeout)
 {
-    static const auto btw = hce::config::timer::busy_wait_threshold();
-    static const auto ewt = hce::config::timer::early_wakeup_threshold();
-    static const auto ewlt = hce::config::timer::early_wakeup_long_threshold();
+    // called by the service thread with the lock held, so the current 
+    // (possibly tuned) thresholds can be read directly
+    const service& s = service::get();
+    const auto btw = s.busy_wait_threshold_;
+    const auto ewt = s.early_wakeup_threshold_;
+    const auto ewlt = s.early_wakeup_long_threshold_;
     auto timeout = requested_timeout;
     auto requested_timeout_dur = requested_timeout - now;
 
@@ -35,3 +47,105 @@ hce::chrono::time_point hce::timer::service::default_timeout_algorithm(
 
     return timeout;
 }
+
+#ifdef __linux__
+void hce::timer::service::timerfd_init_() {
+    timerfd_ = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    eventfd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    epollfd_ = epoll_create1(EPOLL_CLOEXEC);
+
+    bool success = timerfd_ >= 0 && eventfd_ >= 0 && epollfd_ >= 0;
+
+    if(success) [[likely]] {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = timerfd_;
+        success = epoll_ctl(epollfd_, EPOLL_CTL_ADD, timerfd_, &ev) == 0;
+        ev.data.fd = eventfd_;
+        success = success && 
+            epoll_ctl(epollfd_, EPOLL_CTL_ADD, eventfd_, &ev) == 0;
+    }
+
+    if(!success) [[unlikely]] {
+        HCE_ERROR_METHOD_BODY(
+            "timerfd_init_",
+            "falling back to condition_variable backend: ",
+            std::strerror(errno));
+        timerfd_close_();
+    }
+}
+
+void hce::timer::service::timerfd_close_() {
+    for(int* fd : { &timerfd_, &eventfd_, &epollfd_ }) {
+        if(*fd >= 0) { 
+            close(*fd); 
+            *fd = -1;
+        }
+    }
+}
+
+void hce::timer::service::timerfd_notify_() {
+    uint64_t one = 1;
+
+    // a full eventfd counter means the service thread will wake anyway
+    [[maybe_unused]] auto r = write(eventfd_, &one, sizeof(one));
+}
+
+bool hce::timer::service::timerfd_wait_(
+        std::unique_lock<hce::spinlock>& lk, 
+        const hce::chrono::time_point* timeout) 
+{
+    // an all zero itimerspec disarms the timer
+    itimerspec spec{};
+
+    if(timeout) [[likely]] {
+        // steady_clock is CLOCK_MONOTONIC on Linux
+        auto ns = hce::chrono::to<std::chrono::nanoseconds>(
+            timeout->time_since_epoch()).count();
+
+        // a zero it_value would disarm the timer instead of firing it
+        if(ns <= 0) [[unlikely]] { ns = 1; }
+
+        spec.it_value.tv_sec = ns / 1000000000;
+        spec.it_value.tv_nsec = ns % 1000000000;
+    }
+
+    timerfd_settime(timerfd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+
+    // notify_() writes the eventfd, so no wakeup is lost while unlocked
+    lk.unlock();
+
+    bool timed_out = false;
+    epoll_event events[2];
+    int n = epoll_wait(epollfd_, events, 2, -1);
+    uint64_t count;
+
+    for(int i=0; i<n; ++i) {
+        // drain the descriptor so it stops being readable
+        if(read(events[i].data.fd, &count, sizeof(count)) > 0 && 
+           events[i].data.fd == timerfd_) 
+        {
+            timed_out = true;
+        }
+    }
+
+    lk.lock();
+    return timed_out;
+}
+#else 
+void hce::timer::service::timerfd_init_() {
+    HCE_ERROR_METHOD_BODY(
+        "timerfd_init_",
+        "timerfd is unsupported, falling back to condition_variable backend");
+}
+
+void hce::timer::service::timerfd_close_() { }
+void hce::timer::service::timerfd_notify_() { }
+
+bool hce::timer::service::timerfd_wait_(
+        std::unique_lock<hce::spinlock>& lk, 
+        const hce::chrono::time_point* timeout) 
+{
+    return false;
+}
+#endif
@@ -1,16 +1,23 @@
 //SPDX-License-Identifier: Apache-2.0
 //Author: Blayne Dennis 
 #include <deque>
+#include <optional>
 #include <string>
 #include <thread>
 #include <chrono>
 #include <vector>
 #include <algorithm>
+#include <array>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
 
 #include "loguru.hpp"
 #include "atomic.hpp"
 #include "scheduler.hpp"
 #include "blocking.hpp"
+#include "timer.hpp"
 
 #include <gtest/gtest.h> 
 #include "test_helpers.hpp"
@@ -27,8 +34,12 @@ size_t block_T() {
     const size_t reusable_block_worker_cache_size = 
         hce::config::blocking::reusable_block_worker_cache_size();
 
+    const bool keepalive = 
+        hce::config::blocking::worker_keepalive() > hce::chrono::duration(0);
+
     auto post_block_expected_worker_count = [&](size_t blocks_executed) {
-        return reusable_block_worker_cache_size < blocks_executed
+        // idle workers beyond the cache size persist for their keepalive
+        return !keepalive && reusable_block_worker_cache_size < blocks_executed
             ? reusable_block_worker_cache_size
             : blocks_executed;
     };
@@ -509,8 +520,13 @@ size_t block_worker_cache_size_T(const size_t cache_size) {
             }
             
             if(worker_count_check) {
-                // worker count in the cache should have grown to this
-                size_t expected_count = std::min(cache_size, reusable_block_worker_cache_size);
+                // worker count in the cache should have grown to this, idle 
+                // workers beyond the cache size persist for their keepalive
+                size_t expected_count = 
+                    hce::config::blocking::worker_keepalive() > 
+                    hce::chrono::duration(0)
+                    ? cache_size
+                    : std::min(cache_size, reusable_block_worker_cache_size);
                 EXPECT_EQ(expected_count, hce::blocking::service::get().worker_count());
             }
 
@@ -538,3 +554,429 @@ TEST(blocking, block_worker_and_block_worker_cache_size) {
     EXPECT_EQ(expected, test::blocking::block_worker_cache_size_T<std::string>(10));
     EXPECT_EQ(expected, test::blocking::block_worker_cache_size_T<test::CustomObject>(10));
 }
+
+namespace test {
+namespace blocking {
+
+hce::co<void> co_block_sleep(std::atomic<size_t>& max_worker_count) {
+    co_await hce::block([&]{
+        size_t count = hce::blocking::service::get().worker_count();
+        size_t max = max_worker_count.load();
+
+        while(max < count && 
+              !max_worker_count.compare_exchange_weak(max, count)) { }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    });
+}
+
+// block until `count` blocking calls are running at once
+hce::co<bool> co_block_rendezvous(std::mutex& mtx, 
+                                  std::condition_variable& cv, 
+                                  size_t& arrived,
+                                  size_t count) {
+    co_return co_await hce::block([&]{
+        std::unique_lock<std::mutex> lk(mtx);
+        ++arrived;
+        cv.notify_all();
+        return cv.wait_for(lk, std::chrono::seconds(10), [&]{ 
+            return arrived >= count; 
+        });
+    });
+}
+
+}
+}
+
+TEST(blocking, block_worker_unlimited) {
+    auto& service = hce::blocking::service::get();
+    // more than the count of calls which would fit under a small limit
+    const size_t block_count = 100;
+    std::mutex mtx;
+    std::condition_variable cv;
+    size_t arrived = 0;
+    auto lf = hce::scheduler::make();
+    std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+    std::deque<hce::awt<bool>> awts;
+
+    // there is no worker limit by default
+    EXPECT_EQ(0u, hce::config::blocking::worker_limit());
+    EXPECT_EQ(0u, service.worker_limit());
+
+    // blocking calls which wait on each other all get a worker
+    for(size_t i=0; i<block_count; ++i) {
+        awts.push_back(sch->schedule(
+            test::blocking::co_block_rendezvous(mtx, cv, arrived, block_count)));
+    }
+
+    while(awts.size()) {
+        EXPECT_TRUE((bool)awts.front());
+        awts.pop_front();
+    }
+
+    EXPECT_EQ(block_count, arrived);
+    EXPECT_EQ(0u, service.queued());
+}
+
+TEST(blocking, block_worker_limit) {
+    auto& service = hce::blocking::service::get();
+    const size_t worker_limit = 8;
+    const size_t block_count = worker_limit * 2;
+    const auto keepalive = std::chrono::milliseconds(200);
+    const auto default_keepalive = service.worker_keepalive();
+    std::atomic<size_t> max_worker_count(0);
+    auto lf = hce::scheduler::make();
+    std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+    std::deque<hce::awt<void>> awts;
+
+    service.set_worker_limit(worker_limit);
+    EXPECT_EQ(worker_limit, service.worker_limit());
+    service.set_worker_keepalive(keepalive);
+    EXPECT_EQ(hce::chrono::duration(keepalive), service.worker_keepalive());
+    service.clear_worker_cache();
+
+    // more blocking calls than the limit are queued instead of spawning threads
+    for(size_t i=0; i<block_count; ++i) {
+        awts.push_back(sch->schedule(
+            test::blocking::co_block_sleep(max_worker_count)));
+    }
+
+    while(awts.size()) {
+        awts.pop_front();
+    }
+
+    EXPECT_LE(max_worker_count.load(), worker_limit);
+    EXPECT_GT(max_worker_count.load(), 0u);
+    EXPECT_EQ(0u, service.queued());
+
+    const size_t trims = service.get_counters().trims;
+    const size_t worker_count = service.worker_count();
+    EXPECT_LE(worker_count, worker_limit);
+    ASSERT_GT(worker_count, service.worker_cache_size());
+
+    // excess idle workers are trimmed after the keepalive
+    std::this_thread::sleep_for(keepalive + std::chrono::milliseconds(300));
+    EXPECT_LT(service.worker_count(), worker_count);
+    EXPECT_LE(service.worker_count(), service.worker_cache_size());
+    EXPECT_GT(service.get_counters().trims, trims);
+
+    // queued calls get workers when the limit is raised
+    {
+        std::mutex mtx;
+        std::condition_variable cv;
+        size_t arrived = 0;
+        std::deque<hce::awt<bool>> rendezvous;
+
+        for(size_t i=0; i<block_count; ++i) {
+            rendezvous.push_back(sch->schedule(
+                test::blocking::co_block_rendezvous(
+                    mtx, cv, arrived, block_count)));
+        }
+
+        // wait for the limit's worth of calls to be running
+        {
+            std::unique_lock<std::mutex> lk(mtx);
+            cv.wait(lk, [&]{ return arrived >= worker_limit; });
+        }
+
+        EXPECT_GT(service.queued(), 0u);
+        service.set_worker_limit(0);
+
+        while(rendezvous.size()) {
+            EXPECT_TRUE((bool)rendezvous.front());
+            rendezvous.pop_front();
+        }
+    }
+
+    service.set_worker_keepalive(default_keepalive);
+}
+
+namespace test {
+namespace blocking {
+
+hce::co<void> co_block_reuse() {
+    // first call has no idle worker to reuse
+    co_await hce::block([]{ });
+
+    // give the worker time to become idle
+    co_await hce::sleep(std::chrono::milliseconds(50));
+
+    // second call reuses the idle worker
+    co_await hce::block([]{ });
+}
+
+}
+}
+
+TEST(blocking, block_worker_counters) {
+    auto& service = hce::blocking::service::get();
+    auto lf = hce::scheduler::make();
+    std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+
+    EXPECT_EQ(hce::config::blocking::worker_keepalive(), 
+              service.worker_keepalive());
+
+    service.clear_worker_cache();
+    service.reset_counters();
+
+    auto counters = service.get_counters();
+    EXPECT_EQ(0u, counters.hits);
+    EXPECT_EQ(0u, counters.misses);
+    EXPECT_EQ(0u, counters.spawns);
+    EXPECT_EQ(0u, counters.trims);
+
+    sch->schedule(test::blocking::co_block_reuse());
+    counters = service.get_counters();
+
+    // an idle worker is kept if there is cache space or a keepalive
+    if(service.worker_cache_size() || 
+       service.worker_keepalive() > std::chrono::milliseconds(50)) 
+    {
+        EXPECT_EQ(1u, counters.hits);
+        EXPECT_EQ(1u, counters.misses);
+        EXPECT_EQ(1u, counters.spawns);
+    } else {
+        EXPECT_EQ(0u, counters.hits);
+        EXPECT_EQ(2u, counters.misses);
+        EXPECT_EQ(2u, counters.spawns);
+    }
+}
+
+namespace test {
+namespace blocking {
+
+hce::co<void> co_block_local_reuse(size_t count) {
+    for(size_t i = 0; i < count; ++i) {
+        // each awaitable returns its worker to the scheduler's local cache 
+        // when destroyed
+        co_await hce::block([]{ });
+    }
+}
+
+hce::co<void> co_block_outlive(std::optional<hce::awt<void>>& out) {
+    // the awaitable is awaited after the scheduler's thread exits
+    out.emplace(hce::block([]{ 
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }));
+    co_return;
+}
+
+}
+}
+
+TEST(blocking, block_worker_local_cache) {
+    auto& service = hce::blocking::service::get();
+
+    // a scheduler without a local cache only uses the process-wide workers
+    {
+        auto lf = hce::scheduler::make();
+        std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+        EXPECT_EQ(0u, sch->reusable_block_worker_limit());
+
+        service.reset_counters();
+        sch->schedule(test::blocking::co_block_local_reuse(3));
+        EXPECT_EQ(0u, service.get_counters().local_hits);
+    }
+
+    // a scheduler with a local cache reuses its own worker 
+    {
+        hce::config::scheduler::config c;
+        c.reusable_block_worker_limit = 1;
+        auto lf = hce::scheduler::make(c);
+        std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+        EXPECT_EQ(1u, sch->reusable_block_worker_limit());
+
+        service.reset_counters();
+        sch->schedule(test::blocking::co_block_local_reuse(10));
+        auto counters = service.get_counters();
+        EXPECT_EQ(9u, counters.local_hits);
+        EXPECT_EQ(1u, counters.spawns);
+        EXPECT_EQ(0u, counters.hits);
+    }
+
+    // the scheduler's thread has been joined, releasing its local cache
+    EXPECT_EQ(0u, service.get_counters().local_hits);
+
+    // an awaitable holding a local worker can outlive the cache's thread
+    {
+        std::optional<hce::awt<void>> awt;
+
+        {
+            hce::config::scheduler::config c;
+            c.reusable_block_worker_limit = 1;
+            auto lf = hce::scheduler::make(c);
+            std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+            sch->schedule(test::blocking::co_block_outlive(awt));
+        }
+
+        ASSERT_TRUE(awt);
+        EXPECT_TRUE(awt->valid());
+
+        // the worker is retired instead of returned to the released cache
+        awt.reset();
+    }
+}
+
+namespace test {
+namespace blocking {
+
+hce::co<size_t> co_block_inline_result(size_t count) {
+    size_t sum = 0;
+
+    for(size_t i = 0; i < count; ++i) {
+        // a capture too large for any small buffer optimization
+        std::array<size_t,64> large;
+        large.fill(i);
+
+        // move-only result stored inline in the awaitable
+        std::unique_ptr<size_t> p = co_await hce::block([large]{ 
+            return std::unique_ptr<size_t>(new size_t(large[63]));
+        });
+
+        sum += *p;
+    }
+
+    co_return sum;
+}
+
+}
+}
+
+TEST(blocking, block_inline_result) {
+    const size_t count = 100;
+    const size_t expected = (count * (count - 1)) / 2;
+
+    // process-wide workers
+    {
+        auto lf = hce::scheduler::make();
+        std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+        size_t sum = sch->schedule(test::blocking::co_block_inline_result(count));
+        EXPECT_EQ(expected, sum);
+    }
+
+    // scheduler local workers
+    {
+        hce::config::scheduler::config c;
+        c.reusable_block_worker_limit = 1;
+        auto lf = hce::scheduler::make(c);
+        std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+        size_t sum = sch->schedule(test::blocking::co_block_inline_result(count));
+        EXPECT_EQ(expected, sum);
+    }
+}
+
+namespace test {
+namespace blocking {
+
+hce::co<void> co_block_lane(hce::blocking::lane l,
+                            std::atomic<size_t>& concurrent,
+                            std::atomic<size_t>& max_concurrent) {
+    co_await hce::block(l, [&]{
+        size_t count = ++concurrent;
+        size_t max = max_concurrent.load();
+
+        while(max < count && 
+              !max_concurrent.compare_exchange_weak(max, count)) { }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        --concurrent;
+    });
+}
+
+}
+}
+
+TEST(blocking, block_lane) {
+    const size_t block_count = 16;
+    auto lf = hce::scheduler::make();
+    std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+
+    for(size_t limit : { 1u, 2u, 4u }) {
+        auto l = hce::blocking::lane::make("test", limit);
+        std::atomic<size_t> concurrent(0);
+        std::atomic<size_t> max_concurrent(0);
+        std::deque<hce::awt<void>> awts;
+
+        EXPECT_EQ(std::string("test"), l.label());
+        EXPECT_EQ(limit, l.limit());
+
+        // calls beyond the lane's limit are queued in the lane
+        for(size_t i=0; i<block_count; ++i) {
+            awts.push_back(sch->schedule(
+                test::blocking::co_block_lane(l, concurrent, max_concurrent)));
+        }
+
+        while(awts.size()) {
+            awts.pop_front();
+        }
+
+        EXPECT_LE(max_concurrent.load(), limit);
+        EXPECT_GT(max_concurrent.load(), 0u);
+        EXPECT_EQ(0u, l.active());
+        EXPECT_EQ(0u, l.queued());
+    }
+
+    // a limit of 0 is treated as 1
+    EXPECT_EQ(1u, hce::blocking::lane::make("zero", 0).limit());
+
+    // calls outside a coroutine execute immediately 
+    auto l = hce::blocking::lane::make("immediate", 1);
+    int i = hce::block(l, []{ return 3; });
+    EXPECT_EQ(3, i);
+}
+
+namespace test {
+namespace blocking {
+
+hce::co<std::vector<size_t>> co_block_all(std::vector<size_t> v) {
+    co_return co_await hce::block_all(v, [](size_t i) { 
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return i * i; 
+    });
+}
+
+hce::co<size_t> co_block_all_void(std::list<size_t> l) {
+    std::atomic<size_t> sum(0);
+    co_await hce::block_all(std::move(l), [&](size_t i) { sum += i; });
+    co_return sum.load();
+}
+
+}
+}
+
+TEST(blocking, block_all) {
+    auto lf = hce::scheduler::make();
+    std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+
+    for(size_t count : { 0u, 1u, 10u, 100u }) {
+        std::vector<size_t> v;
+        std::list<size_t> l;
+
+        for(size_t i = 0; i < count; ++i) {
+            v.push_back(i);
+            l.push_back(i);
+        }
+
+        // results are returned in the order of the range
+        std::vector<size_t> results = sch->schedule(
+            test::blocking::co_block_all(v));
+        ASSERT_EQ(count, results.size());
+
+        for(size_t i = 0; i < count; ++i) {
+            EXPECT_EQ(i * i, results[i]);
+        }
+
+        size_t sum = sch->schedule(test::blocking::co_block_all_void(l));
+        EXPECT_EQ((count * (count ? count - 1 : 0)) / 2, sum);
+
+        // calls outside a coroutine execute immediately 
+        std::vector<size_t> immediate = hce::block_all(v, [](size_t i) { 
+            return i + 1; 
+        });
+        ASSERT_EQ(count, immediate.size());
+
+        for(size_t i = 0; i < count; ++i) {
+            EXPECT_EQ(i + 1, immediate[i]);
+        }
+    }
+}
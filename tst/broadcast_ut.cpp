@@ -0,0 +1,239 @@
+//SPDX-License-Identifier: Apache-2.0
+//Author: Blayne Dennis
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <memory>
+
+#include "loguru.hpp"
+#include "logging.hpp"
+#include "coroutine.hpp"
+#include "scheduler.hpp"
+#include "threadpool.hpp"
+#include "broadcast.hpp"
+
+#include <gtest/gtest.h>
+#include "test_helpers.hpp"
+
+namespace test {
+namespace broadcast {
+
+template <typename T>
+hce::co<size_t> co_publish(hce::broadcast<T> b, size_t count) {
+    size_t sent = 0;
+
+    for(size_t i = 0; i < count; ++i) {
+        if(co_await b.send((T)test::init<T>(i))) { ++sent; }
+    }
+
+    b.close();
+    co_return sent;
+}
+
+template <typename T>
+hce::co<size_t> co_copy_subscriber(typename hce::broadcast<T>::subscriber s) {
+    size_t received = 0;
+    T t;
+
+    while(co_await s.recv(t)) {
+        if((T)test::init<T>(received) != t) { break; }
+        ++received;
+    }
+
+    co_return received;
+}
+
+template <typename T>
+hce::co<size_t> co_shared_subscriber(typename hce::broadcast<T>::subscriber s) {
+    size_t received = 0;
+    std::shared_ptr<const T> p;
+
+    while(co_await s.recv(p)) {
+        if((T)test::init<T>(received) != *p) { break; }
+        ++received;
+    }
+
+    co_return received;
+}
+
+// every subscriber receives every value, in order, from a blocking broadcast
+template <typename T>
+void fan_out_T() {
+    const size_t count = 1000;
+    const size_t subscriber_count = 8;
+    auto b = hce::broadcast<T>::make(4);
+    std::vector<hce::awt<size_t>> receivers;
+
+    for(size_t i = 0; i < subscriber_count; ++i) {
+        auto s = b.subscribe();
+
+        if(i % 2) {
+            receivers.push_back(hce::threadpool::schedule(
+                co_shared_subscriber<T>(std::move(s))));
+        } else {
+            receivers.push_back(hce::threadpool::schedule(
+                co_copy_subscriber<T>(std::move(s))));
+        }
+    }
+
+    EXPECT_EQ(subscriber_count, b.subscribers());
+    EXPECT_EQ(count, (size_t)hce::schedule(co_publish<T>(b, count)));
+
+    for(auto& r : receivers) {
+        EXPECT_EQ(count, (size_t)std::move(r));
+    }
+}
+
+template <typename T>
+void shared_value_T() {
+    auto b = hce::broadcast<T>::make(4);
+    auto s1 = b.subscribe();
+    auto s2 = b.subscribe();
+    std::shared_ptr<const T> p1;
+    std::shared_ptr<const T> p2;
+    T t;
+
+    EXPECT_TRUE((bool)b.send((T)test::init<T>(3)));
+    EXPECT_EQ(1, s1.used());
+    EXPECT_EQ(1, s2.used());
+    EXPECT_TRUE((bool)s1.recv(p1));
+    EXPECT_TRUE((bool)s2.recv(p2));
+    EXPECT_EQ(p1.get(), p2.get());
+    EXPECT_EQ((T)test::init<T>(3), *p1);
+
+    // a shared value is published without copying it
+    auto p3 = std::make_shared<const T>((T)test::init<T>(4));
+    EXPECT_TRUE((bool)b.send(p3));
+    EXPECT_TRUE((bool)s1.recv(p1));
+    EXPECT_EQ(p3.get(), p1.get());
+    EXPECT_TRUE((bool)s2.recv(t));
+    EXPECT_EQ((T)test::init<T>(4), t);
+
+    // new subscribers only receive later values
+    auto s3 = b.subscribe();
+    EXPECT_EQ(0, s3.used());
+}
+
+}
+}
+
+TEST(broadcast, fan_out) {
+    test::broadcast::fan_out_T<int>();
+    test::broadcast::fan_out_T<size_t>();
+    test::broadcast::fan_out_T<double>();
+    test::broadcast::fan_out_T<std::string>();
+    test::broadcast::fan_out_T<test::CustomObject>();
+}
+
+TEST(broadcast, shared_value) {
+    test::broadcast::shared_value_T<int>();
+    test::broadcast::shared_value_T<std::string>();
+    test::broadcast::shared_value_T<test::CustomObject>();
+}
+
+TEST(broadcast, block) {
+    auto b = hce::broadcast<int>::make(2);
+    auto fast = b.subscribe();
+    auto slow = b.subscribe();
+    int i;
+
+    EXPECT_TRUE((bool)b.send(0));
+    EXPECT_TRUE((bool)b.send(1));
+    EXPECT_TRUE((bool)fast.recv(i));
+    EXPECT_TRUE((bool)fast.recv(i));
+
+    // the slowest subscriber throttles the sender
+    auto send_awt = hce::schedule([](hce::broadcast<int> b) -> hce::co<bool> {
+        co_return co_await b.send(2);
+    }(b));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(0, fast.used());
+    EXPECT_EQ(2, slow.used());
+
+    EXPECT_TRUE((bool)slow.recv(i));
+    EXPECT_EQ(0, i);
+    EXPECT_TRUE((bool)std::move(send_awt));
+    EXPECT_EQ(1, fast.used());
+    EXPECT_EQ(2, slow.used());
+
+    // unsubscribing the slowest subscriber unblocks the sender
+    send_awt = hce::schedule([](hce::broadcast<int> b) -> hce::co<bool> {
+        co_return co_await b.send(3);
+    }(b));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(2, slow.used());
+    slow = hce::broadcast<int>::subscriber();
+    EXPECT_TRUE((bool)std::move(send_awt));
+    EXPECT_EQ(1, b.subscribers());
+
+    EXPECT_TRUE((bool)fast.recv(i));
+    EXPECT_EQ(2, i);
+    EXPECT_TRUE((bool)fast.recv(i));
+    EXPECT_EQ(3, i);
+}
+
+TEST(broadcast, lag) {
+    auto b = hce::broadcast<int>::make(2, hce::broadcast<int>::overflow::lag);
+    auto s = b.subscribe();
+    int i;
+
+    for(int v = 0; v < 5; ++v) {
+        EXPECT_TRUE((bool)b.send(v));
+    }
+
+    EXPECT_EQ(3, s.lagged());
+    EXPECT_EQ(2, s.used());
+    EXPECT_TRUE((bool)s.recv(i));
+    EXPECT_EQ(3, i);
+    EXPECT_TRUE((bool)s.recv(i));
+    EXPECT_EQ(4, i);
+    EXPECT_FALSE(s.dropped());
+}
+
+TEST(broadcast, drop) {
+    auto b = hce::broadcast<int>::make(2, hce::broadcast<int>::overflow::drop);
+    auto fast = b.subscribe();
+    auto slow = b.subscribe();
+    int i;
+
+    for(int v = 0; v < 5; ++v) {
+        EXPECT_TRUE((bool)b.send(v));
+        EXPECT_TRUE((bool)fast.recv(i));
+        EXPECT_EQ(v, i);
+    }
+
+    EXPECT_TRUE(slow.dropped());
+    EXPECT_FALSE(fast.dropped());
+    EXPECT_EQ(1, b.subscribers());
+    EXPECT_FALSE((bool)slow.recv(i));
+}
+
+TEST(broadcast, close) {
+    auto b = hce::broadcast<int>::make(4);
+    auto s1 = b.subscribe();
+    auto s2 = b.subscribe();
+    int i;
+
+    EXPECT_TRUE((bool)b.send(0));
+    EXPECT_TRUE((bool)s1.recv(i));
+
+    // a parked receive fails when the broadcast is closed
+    auto recv_awt = hce::schedule([](hce::broadcast<int>::subscriber s) -> hce::co<bool> {
+        int i;
+        co_return co_await s.recv(i);
+    }(s1));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    b.close();
+    EXPECT_TRUE(b.closed());
+    EXPECT_FALSE((bool)std::move(recv_awt));
+    EXPECT_FALSE((bool)b.send(1));
+
+    // values published before the close can still be received
+    EXPECT_TRUE((bool)s2.recv(i));
+    EXPECT_EQ(0, i);
+    EXPECT_FALSE((bool)s2.recv(i));
+}
@@ -2,12 +2,15 @@
 //Author: Blayne Dennis 
 #include <mutex>
 #include <functional>
+#include <vector>
+#include <algorithm>
 
 #include "loguru.hpp"
 #include "atomic.hpp"
 #include "logging.hpp"
 #include "coroutine.hpp"
 #include "scheduler.hpp"
+#include "threadpool.hpp"
 #include "channel.hpp"
 
 #include <gtest/gtest.h>  
@@ -858,3 +861,1202 @@ TEST(channel, send_recv_interrupt_close) {
     ASSERT_EQ(5,success_count);
 }
 
+
+namespace test {
+namespace channel {
+
+template <typename T>
+hce::co<bool> co_recv_timeout(hce::chan<T> ch, T& t, hce::chrono::duration dur) {
+    co_return co_await ch.recv(t, dur);
+}
+
+template <typename T>
+hce::co<bool> co_send_timeout(hce::chan<T> ch, hce::chrono::duration dur) {
+    co_return co_await ch.send((T)test::init<T>(1), dur);
+}
+
+template <typename T>
+size_t send_recv_timeout_T() {
+    std::string fname = hce::type::templatize<T>("send_recv_timeout_T");
+    size_t success_count=0;
+    const hce::chrono::duration dur = std::chrono::milliseconds(10);
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "thread recv timeout");
+        auto test = [&](hce::chan<T> ch) {
+            T t;
+            auto start = hce::chrono::now();
+            ASSERT_FALSE((bool)ch.recv(t, dur));
+            ASSERT_GE(hce::chrono::now() - start, dur);
+
+            // the timed out receive must no longer be parked
+            ASSERT_EQ(hce::channel::result::failure, (hce::channel::result)ch.try_recv(t));
+            ASSERT_FALSE(ch.closed());
+            ++success_count;
+        };
+
+        test(hce::chan<T>::make());
+        test(hce::chan<T>::make(1));
+        test(hce::chan<T>::make(-1));
+        test(hce::chan<T>::template make<std::mutex>());
+        test(hce::chan<T>::template make<std::mutex>(1));
+        test(hce::chan<T>::template make<std::mutex>(-1));
+    }
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "thread send timeout");
+        auto test = [&](hce::chan<T> ch) {
+            // fill the buffer if there is one
+            if(ch.size() > 0) {
+                ASSERT_TRUE((bool)ch.send((T)test::init<T>(0)));
+            }
+
+            auto start = hce::chrono::now();
+            ASSERT_FALSE((bool)ch.send((T)test::init<T>(1), dur));
+            ASSERT_GE(hce::chrono::now() - start, dur);
+
+            T t;
+
+            if(ch.size() > 0) {
+                ASSERT_EQ(hce::channel::result::success, (hce::channel::result)ch.try_recv(t));
+                ASSERT_EQ((T)test::init<T>(0), t);
+            }
+
+            // the timed out send must no longer be parked
+            ASSERT_EQ(hce::channel::result::failure, (hce::channel::result)ch.try_recv(t));
+            ++success_count;
+        };
+
+        test(hce::chan<T>::make());
+        test(hce::chan<T>::make(1));
+        test(hce::chan<T>::template make<std::mutex>());
+        test(hce::chan<T>::template make<std::mutex>(1));
+    }
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "thread recv before timeout");
+        auto test = [&](hce::chan<T> ch) {
+            std::thread thd([](hce::chan<T> ch) {
+                ch.send((T)test::init<T>(1));
+            }, ch);
+
+            T t;
+            ASSERT_TRUE((bool)ch.recv(t, std::chrono::seconds(10)));
+            ASSERT_EQ((T)test::init<T>(1), t);
+            thd.join();
+            ++success_count;
+        };
+
+        test(hce::chan<T>::make());
+        test(hce::chan<T>::make(1));
+        test(hce::chan<T>::make(-1));
+    }
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "coroutine recv timeout");
+        auto test = [&](hce::chan<T> ch) {
+            auto lf = hce::scheduler::make();
+            std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+            T t;
+            ASSERT_FALSE((bool)sch->schedule(
+                test::channel::co_recv_timeout<T>(ch, t, dur)));
+            ++success_count;
+        };
+
+        test(hce::chan<T>::make());
+        test(hce::chan<T>::make(1));
+        test(hce::chan<T>::make(-1));
+    }
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "coroutine send timeout");
+        auto lf = hce::scheduler::make();
+        std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+        auto ch = hce::chan<T>::make();
+        EXPECT_FALSE((bool)sch->schedule(
+            test::channel::co_send_timeout<T>(ch, dur)));
+        ++success_count;
+    }
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "coroutine recv before timeout");
+        auto test = [&](hce::chan<T> ch) {
+            auto lf = hce::scheduler::make();
+            std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+            T t;
+            auto awt = sch->schedule(test::channel::co_recv_timeout<T>(
+                ch, t, std::chrono::seconds(10)));
+            ch.send((T)test::init<T>(1));
+            ASSERT_TRUE((bool)awt);
+            ASSERT_EQ((T)test::init<T>(1), t);
+            ++success_count;
+        };
+
+        test(hce::chan<T>::make());
+        test(hce::chan<T>::make(1));
+        test(hce::chan<T>::make(-1));
+    }
+
+    return success_count;
+}
+
+}
+}
+
+TEST(channel, send_recv_timeout) {
+    const size_t expected = 20;
+    ASSERT_EQ(expected, test::channel::send_recv_timeout_T<int>());
+    ASSERT_EQ(expected, test::channel::send_recv_timeout_T<size_t>());
+    ASSERT_EQ(expected, test::channel::send_recv_timeout_T<double>());
+    ASSERT_EQ(expected, test::channel::send_recv_timeout_T<std::string>());
+    ASSERT_EQ(expected, test::channel::send_recv_timeout_T<test::CustomObject>());
+}
+
+namespace test {
+namespace channel {
+
+template <typename T>
+hce::co<size_t> co_spsc_send(hce::chan<T> ch, size_t count) {
+    size_t sent = 0;
+
+    for(size_t i = 0; i < count; ++i) {
+        if(co_await ch.send((T)test::init<T>(i))) { ++sent; }
+    }
+
+    ch.close();
+    co_return sent;
+}
+
+template <typename T>
+hce::co<size_t> co_spsc_recv(hce::chan<T> ch) {
+    size_t received = 0;
+    T t;
+
+    while(co_await ch.recv(t)) { 
+        if((T)test::init<T>(received) != t) { break; }
+        ++received; 
+    }
+
+    co_return received;
+}
+
+template <typename T>
+size_t spsc_T() {
+    std::string fname = hce::type::templatize<T>("spsc_T");
+    size_t success_count=0;
+    const size_t count = 200;
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "construct");
+        auto ch = hce::chan<T>::template make<hce::channel::spsc>(3);
+        EXPECT_EQ(typeid(hce::channel::spsc<T>), ch.type_info());
+        EXPECT_EQ(3, ch.size());
+        EXPECT_EQ(0, ch.used());
+        EXPECT_FALSE(ch.closed());
+
+        ch.template construct<hce::channel::spsc>(0);
+        EXPECT_EQ(typeid(hce::channel::spsc<T>), ch.type_info());
+        EXPECT_EQ(1, ch.size());
+        ++success_count;
+    }
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "try operations and close");
+        auto ch = hce::chan<T>::template make<hce::channel::spsc>(2);
+        T t;
+
+        EXPECT_EQ(hce::channel::result::failure, (hce::channel::result)ch.try_recv(t));
+        EXPECT_EQ(hce::channel::result::success, (hce::channel::result)ch.try_send((T)test::init<T>(0)));
+        EXPECT_EQ(hce::channel::result::success, (hce::channel::result)ch.try_send((T)test::init<T>(1)));
+        EXPECT_EQ(hce::channel::result::failure, (hce::channel::result)ch.try_send((T)test::init<T>(2)));
+        EXPECT_EQ(2, ch.used());
+
+        // values sent before close can still be received
+        ch.close();
+        EXPECT_TRUE(ch.closed());
+        EXPECT_EQ(hce::channel::result::closed, (hce::channel::result)ch.try_send((T)test::init<T>(2)));
+        EXPECT_FALSE((bool)ch.send((T)test::init<T>(2)));
+        EXPECT_EQ(hce::channel::result::success, (hce::channel::result)ch.try_recv(t));
+        EXPECT_EQ((T)test::init<T>(0), t);
+        EXPECT_TRUE((bool)ch.recv(t));
+        EXPECT_EQ((T)test::init<T>(1), t);
+        EXPECT_EQ(hce::channel::result::closed, (hce::channel::result)ch.try_recv(t));
+        EXPECT_FALSE((bool)ch.recv(t));
+        ++success_count;
+    }
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "values remaining at destruction");
+        auto ch = hce::chan<T>::template make<hce::channel::spsc>(4);
+        EXPECT_TRUE((bool)ch.send((T)test::init<T>(0)));
+        EXPECT_TRUE((bool)ch.send((T)test::init<T>(1)));
+        ++success_count;
+    }
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "thread to thread");
+        auto test = [&](int sz) {
+            auto ch = hce::chan<T>::template make<hce::channel::spsc>(sz);
+            size_t received = 0;
+
+            std::thread thd([&]{
+                T t;
+
+                while(ch.recv(t)) { 
+                    if((T)test::init<T>(received) != t) { break; }
+                    ++received; 
+                }
+            });
+
+            for(size_t i = 0; i < count; ++i) {
+                ASSERT_TRUE((bool)ch.send((T)test::init<T>(i)));
+            }
+
+            ch.close();
+            thd.join();
+            ASSERT_EQ(count, received);
+            ++success_count;
+        };
+
+        test(1);
+        test(64);
+    }
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "thread to coroutine");
+        auto test = [&](int sz) {
+            auto lf = hce::scheduler::make();
+            std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+            auto ch = hce::chan<T>::template make<hce::channel::spsc>(sz);
+            auto awt = sch->schedule(test::channel::co_spsc_recv<T>(ch));
+
+            for(size_t i = 0; i < count; ++i) {
+                ASSERT_TRUE((bool)ch.send((T)test::init<T>(i)));
+            }
+
+            ch.close();
+            ASSERT_EQ(count, (size_t)std::move(awt));
+            ++success_count;
+        };
+
+        test(1);
+        test(64);
+    }
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "coroutine to thread");
+        auto test = [&](int sz) {
+            auto lf = hce::scheduler::make();
+            std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+            auto ch = hce::chan<T>::template make<hce::channel::spsc>(sz);
+            auto awt = sch->schedule(test::channel::co_spsc_send<T>(ch, count));
+            size_t received = 0;
+            T t;
+
+            while(ch.recv(t)) { 
+                ASSERT_EQ((T)test::init<T>(received), t);
+                ++received; 
+            }
+
+            ASSERT_EQ(count, received);
+            ASSERT_EQ(count, (size_t)std::move(awt));
+            ++success_count;
+        };
+
+        test(1);
+        test(64);
+    }
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "coroutine to coroutine");
+        auto lf = hce::scheduler::make();
+        std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+        auto ch = hce::chan<T>::template make<hce::channel::spsc>(8);
+        auto recv_awt = sch->schedule(test::channel::co_spsc_recv<T>(ch));
+        auto send_awt = sch->schedule(test::channel::co_spsc_send<T>(ch, count));
+        EXPECT_EQ(count, (size_t)std::move(send_awt));
+        EXPECT_EQ(count, (size_t)std::move(recv_awt));
+        ++success_count;
+    }
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "timeouts");
+        const hce::chrono::duration dur = std::chrono::milliseconds(10);
+        auto ch = hce::chan<T>::template make<hce::channel::spsc>(1);
+        T t;
+
+        auto start = hce::chrono::now();
+        EXPECT_FALSE((bool)ch.recv(t, dur));
+        EXPECT_GE(hce::chrono::now() - start, dur);
+
+        EXPECT_TRUE((bool)ch.send((T)test::init<T>(0), dur));
+        start = hce::chrono::now();
+        EXPECT_FALSE((bool)ch.send((T)test::init<T>(1), dur));
+        EXPECT_GE(hce::chrono::now() - start, dur);
+
+        // the timed out operations must no longer be parked
+        EXPECT_EQ(hce::channel::result::success, (hce::channel::result)ch.try_recv(t));
+        EXPECT_EQ((T)test::init<T>(0), t);
+        EXPECT_EQ(hce::channel::result::failure, (hce::channel::result)ch.try_recv(t));
+
+        auto lf = hce::scheduler::make();
+        std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+        auto awt = sch->schedule(test::channel::co_recv_timeout<T>(
+            ch, t, std::chrono::seconds(10)));
+        EXPECT_TRUE((bool)ch.send((T)test::init<T>(2)));
+        EXPECT_TRUE((bool)awt);
+        EXPECT_EQ((T)test::init<T>(2), t);
+        ++success_count;
+    }
+
+    return success_count;
+}
+
+}
+}
+
+TEST(channel, spsc) {
+    const size_t expected = 11;
+    ASSERT_EQ(expected, test::channel::spsc_T<int>());
+    ASSERT_EQ(expected, test::channel::spsc_T<size_t>());
+    ASSERT_EQ(expected, test::channel::spsc_T<double>());
+    ASSERT_EQ(expected, test::channel::spsc_T<std::string>());
+    ASSERT_EQ(expected, test::channel::spsc_T<test::CustomObject>());
+}
+
+namespace test {
+namespace channel {
+
+template <typename T>
+size_t mpmc_T() {
+    std::string fname = hce::type::templatize<T>("mpmc_T");
+    size_t success_count=0;
+    const size_t count = 200;
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "construct");
+        auto ch = hce::chan<T>::template make<hce::channel::mpmc>(3);
+        EXPECT_EQ(typeid(hce::channel::mpmc<T>), ch.type_info());
+        EXPECT_EQ(4, ch.size());
+        EXPECT_EQ(0, ch.used());
+        EXPECT_FALSE(ch.closed());
+
+        ch.template construct<hce::channel::mpmc>(0);
+        EXPECT_EQ(typeid(hce::channel::mpmc<T>), ch.type_info());
+        EXPECT_EQ(2, ch.size());
+        ++success_count;
+    }
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "try operations and close");
+        auto ch = hce::chan<T>::template make<hce::channel::mpmc>(2);
+        T t;
+
+        EXPECT_EQ(hce::channel::result::failure, (hce::channel::result)ch.try_recv(t));
+        EXPECT_EQ(hce::channel::result::success, (hce::channel::result)ch.try_send((T)test::init<T>(0)));
+        EXPECT_EQ(hce::channel::result::success, (hce::channel::result)ch.try_send((T)test::init<T>(1)));
+        EXPECT_EQ(hce::channel::result::failure, (hce::channel::result)ch.try_send((T)test::init<T>(2)));
+        EXPECT_EQ(2, ch.used());
+
+        // values sent before close can still be received
+        ch.close();
+        EXPECT_TRUE(ch.closed());
+        EXPECT_EQ(hce::channel::result::closed, (hce::channel::result)ch.try_send((T)test::init<T>(2)));
+        EXPECT_FALSE((bool)ch.send((T)test::init<T>(2)));
+        EXPECT_EQ(hce::channel::result::success, (hce::channel::result)ch.try_recv(t));
+        EXPECT_EQ((T)test::init<T>(0), t);
+        EXPECT_TRUE((bool)ch.recv(t));
+        EXPECT_EQ((T)test::init<T>(1), t);
+        EXPECT_EQ(hce::channel::result::closed, (hce::channel::result)ch.try_recv(t));
+        EXPECT_FALSE((bool)ch.recv(t));
+        ++success_count;
+    }
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "values remaining at destruction");
+        auto ch = hce::chan<T>::template make<hce::channel::mpmc>(4);
+
+        // wrap around the ring once
+        for(size_t i = 0; i < 6; ++i) {
+            EXPECT_TRUE((bool)ch.send((T)test::init<T>(i)));
+            
+            if(i < 3) {
+                T t;
+                EXPECT_TRUE((bool)ch.recv(t));
+                EXPECT_EQ((T)test::init<T>(i), t);
+            }
+        }
+
+        EXPECT_EQ(3, ch.used());
+        ++success_count;
+    }
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "thread to coroutine");
+        auto test = [&](int sz) {
+            auto lf = hce::scheduler::make();
+            std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+            auto ch = hce::chan<T>::template make<hce::channel::mpmc>(sz);
+            auto awt = sch->schedule(test::channel::co_spsc_recv<T>(ch));
+
+            for(size_t i = 0; i < count; ++i) {
+                ASSERT_TRUE((bool)ch.send((T)test::init<T>(i)));
+            }
+
+            ch.close();
+            ASSERT_EQ(count, (size_t)std::move(awt));
+            ++success_count;
+        };
+
+        test(2);
+        test(64);
+    }
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "coroutine to thread");
+        auto test = [&](int sz) {
+            auto lf = hce::scheduler::make();
+            std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+            auto ch = hce::chan<T>::template make<hce::channel::mpmc>(sz);
+            auto awt = sch->schedule(test::channel::co_spsc_send<T>(ch, count));
+            size_t received = 0;
+            T t;
+
+            while(ch.recv(t)) { 
+                ASSERT_EQ((T)test::init<T>(received), t);
+                ++received; 
+            }
+
+            ASSERT_EQ(count, received);
+            ASSERT_EQ(count, (size_t)std::move(awt));
+            ++success_count;
+        };
+
+        test(2);
+        test(64);
+    }
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "timeouts");
+        const hce::chrono::duration dur = std::chrono::milliseconds(10);
+        auto ch = hce::chan<T>::template make<hce::channel::mpmc>(2);
+        T t;
+
+        auto start = hce::chrono::now();
+        EXPECT_FALSE((bool)ch.recv(t, dur));
+        EXPECT_GE(hce::chrono::now() - start, dur);
+
+        EXPECT_TRUE((bool)ch.send((T)test::init<T>(0), dur));
+        EXPECT_TRUE((bool)ch.send((T)test::init<T>(1), dur));
+        start = hce::chrono::now();
+        EXPECT_FALSE((bool)ch.send((T)test::init<T>(2), dur));
+        EXPECT_GE(hce::chrono::now() - start, dur);
+
+        // the timed out operations must no longer be parked
+        EXPECT_EQ(hce::channel::result::success, (hce::channel::result)ch.try_recv(t));
+        EXPECT_EQ((T)test::init<T>(0), t);
+        EXPECT_EQ(hce::channel::result::success, (hce::channel::result)ch.try_recv(t));
+        EXPECT_EQ((T)test::init<T>(1), t);
+        EXPECT_EQ(hce::channel::result::failure, (hce::channel::result)ch.try_recv(t));
+
+        auto lf = hce::scheduler::make();
+        std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+        auto awt = sch->schedule(test::channel::co_recv_timeout<T>(
+            ch, t, std::chrono::seconds(10)));
+        EXPECT_TRUE((bool)ch.send((T)test::init<T>(3)));
+        EXPECT_TRUE((bool)awt);
+        EXPECT_EQ((T)test::init<T>(3), t);
+        ++success_count;
+    }
+
+    return success_count;
+}
+
+hce::co<size_t> co_mpmc_produce(hce::chan<size_t> ch, size_t first, size_t count) {
+    size_t sum = 0;
+
+    for(size_t i = first; i < first + count; ++i) {
+        if(co_await ch.send(i)) { sum += i; }
+    }
+
+    co_return sum;
+}
+
+hce::co<size_t> co_mpmc_consume(hce::chan<size_t> ch) {
+    size_t sum = 0;
+    size_t i;
+
+    while(co_await ch.recv(i)) { sum += i; }
+
+    co_return sum;
+}
+
+}
+}
+
+TEST(channel, mpmc) {
+    const size_t expected = 8;
+    ASSERT_EQ(expected, test::channel::mpmc_T<int>());
+    ASSERT_EQ(expected, test::channel::mpmc_T<size_t>());
+    ASSERT_EQ(expected, test::channel::mpmc_T<double>());
+    ASSERT_EQ(expected, test::channel::mpmc_T<std::string>());
+    ASSERT_EQ(expected, test::channel::mpmc_T<test::CustomObject>());
+}
+
+TEST(channel, mpmc_fan_in_fan_out) {
+    const size_t producers = 4;
+    const size_t consumers = 4;
+    const size_t count = 1000;
+    const size_t expected = (producers * count) * (producers * count - 1) / 2;
+
+    // coroutines spread across the threadpool
+    {
+        auto ch = hce::chan<size_t>::make<hce::channel::mpmc>(8);
+        std::vector<hce::awt<size_t>> produced;
+        std::vector<hce::awt<size_t>> consumed;
+
+        for(size_t c = 0; c < consumers; ++c) {
+            consumed.push_back(hce::threadpool::schedule(
+                test::channel::co_mpmc_consume(ch)));
+        }
+
+        for(size_t p = 0; p < producers; ++p) {
+            produced.push_back(hce::threadpool::schedule(
+                test::channel::co_mpmc_produce(ch, p * count, count)));
+        }
+
+        size_t produced_sum = 0;
+        size_t consumed_sum = 0;
+
+        for(auto& awt : produced) { produced_sum += (size_t)std::move(awt); }
+
+        ch.close();
+
+        for(auto& awt : consumed) { consumed_sum += (size_t)std::move(awt); }
+
+        EXPECT_EQ(expected, produced_sum);
+        EXPECT_EQ(expected, consumed_sum);
+    }
+
+    // system threads
+    {
+        auto ch = hce::chan<size_t>::make<hce::channel::mpmc>(8);
+        std::vector<std::thread> thds;
+        std::atomic<size_t> consumed_sum(0);
+
+        for(size_t c = 0; c < consumers; ++c) {
+            thds.push_back(std::thread([&]{
+                size_t sum = 0;
+                size_t i;
+
+                while(ch.recv(i)) { sum += i; }
+
+                consumed_sum += sum;
+            }));
+        }
+
+        std::vector<std::thread> producer_thds;
+
+        for(size_t p = 0; p < producers; ++p) {
+            producer_thds.push_back(std::thread([&,p]{
+                for(size_t i = p * count; i < (p + 1) * count; ++i) {
+                    ch.send(i);
+                }
+            }));
+        }
+
+        for(auto& thd : producer_thds) { thd.join(); }
+
+        ch.close();
+
+        for(auto& thd : thds) { thd.join(); }
+
+        EXPECT_EQ(expected, consumed_sum.load());
+    }
+}
+
+namespace test {
+namespace channel {
+
+// send every value with batches, then close
+template <typename T>
+hce::co<size_t> co_send_n_all(hce::chan<T> ch, std::vector<T> values) {
+    auto it = values.begin();
+
+    while(it != values.end()) {
+        size_t n = co_await ch.send_n(it, values.end());
+
+        if(!n) { break; }
+
+        it += n;
+    }
+
+    ch.close();
+    co_return (size_t)(it - values.begin());
+}
+
+// receive with batches until closed
+template <typename T>
+hce::co<std::vector<T>> co_recv_n_all(hce::chan<T> ch, size_t max) {
+    std::vector<T> values;
+    std::vector<T> batch(max);
+    size_t n;
+
+    while((n = co_await ch.recv_n(batch.begin(), max))) {
+        values.insert(values.end(), batch.begin(), batch.begin() + n);
+    }
+
+    co_return values;
+}
+
+template <typename T>
+size_t send_n_recv_n_T() {
+    std::string fname = hce::type::templatize<T>("send_n_recv_n_T");
+    size_t success_count=0;
+    const size_t count = 100;
+
+    std::vector<T> expected;
+
+    for(size_t i = 0; i < count; ++i) {
+        expected.push_back((T)test::init<T>(i));
+    }
+
+    std::vector<std::function<hce::chan<T>()>> makers = {
+        []{ return hce::chan<T>::make(); },
+        []{ return hce::chan<T>::make(1); },
+        []{ return hce::chan<T>::make(8); },
+        []{ return hce::chan<T>::make(-1); },
+        []{ return hce::chan<T>::template make<std::mutex>(8); },
+        []{ return hce::chan<T>::template make<hce::channel::spsc>(8); },
+        []{ return hce::chan<T>::template make<hce::channel::mpmc>(8); }
+    };
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "batches fill the buffer");
+        auto test = [&](hce::chan<T> ch) {
+            std::vector<T> values = expected;
+            std::vector<T> out(count);
+
+            if(ch.size() == 0) {
+                // nothing can be sent without a receiver
+                ASSERT_EQ(hce::channel::result::failure, (hce::channel::result)ch.try_recv(out[0]));
+            } else {
+                const size_t n = ch.send_n(values.begin(), values.end());
+                const size_t expected_n = ch.size() < 0 ? count : (size_t)ch.size();
+                ASSERT_EQ(expected_n, n);
+                ASSERT_EQ((int)expected_n, ch.used());
+
+                // receive in two batches
+                const size_t first = n / 2;
+                ASSERT_EQ(first, (size_t)ch.recv_n(out.begin(), first));
+                ASSERT_EQ(n - first, (size_t)ch.recv_n(out.begin() + first, count));
+
+                for(size_t i = 0; i < n; ++i) {
+                    ASSERT_EQ(expected[i], out[i]);
+                }
+            }
+
+            // empty ranges complete immediately
+            ASSERT_EQ(0u, (size_t)ch.send_n(values.end(), values.end()));
+            ASSERT_EQ(0u, (size_t)ch.recv_n(out.begin(), 0));
+
+            // closed
+            ch.close();
+            ASSERT_EQ(0u, (size_t)ch.send_n(values.begin(), values.end()));
+            ASSERT_EQ(0u, (size_t)ch.recv_n(out.begin(), count));
+            ++success_count;
+        };
+
+        for(auto& make : makers) { test(make()); }
+    }
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "coroutine send_n to thread recv_n");
+        auto test = [&](hce::chan<T> ch, size_t max) {
+            auto lf = hce::scheduler::make();
+            std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+            auto awt = sch->schedule(test::channel::co_send_n_all<T>(ch, expected));
+            std::vector<T> received;
+            std::vector<T> batch(max);
+            size_t n;
+
+            while((n = ch.recv_n(batch.begin(), max))) {
+                received.insert(received.end(), batch.begin(), batch.begin() + n);
+            }
+
+            ASSERT_EQ(count, (size_t)std::move(awt));
+            ASSERT_EQ(expected, received);
+            ++success_count;
+        };
+
+        for(auto& make : makers) { 
+            test(make(), 1); 
+            test(make(), 16); 
+        }
+    }
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "thread send_n to coroutine recv_n");
+        auto test = [&](hce::chan<T> ch, size_t max) {
+            auto lf = hce::scheduler::make();
+            std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+            auto awt = sch->schedule(test::channel::co_recv_n_all<T>(ch, max));
+            std::vector<T> values = expected;
+            auto it = values.begin();
+
+            while(it != values.end()) {
+                size_t n = ch.send_n(it, values.end());
+                ASSERT_NE(0u, n);
+                it += n;
+            }
+
+            ch.close();
+            ASSERT_EQ(expected, (std::vector<T>)std::move(awt));
+            ++success_count;
+        };
+
+        for(auto& make : makers) { 
+            test(make(), 1); 
+            test(make(), 16); 
+        }
+    }
+
+    {
+        HCE_INFO_FUNCTION_BODY(fname, "single operations and batches");
+        auto test = [&](hce::chan<T> ch) {
+            auto lf = hce::scheduler::make();
+            std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+
+            // parked single receives are completed by a batch
+            std::vector<T> received(4);
+            std::vector<hce::awt<bool>> awts;
+
+            for(size_t i = 0; i < received.size(); ++i) {
+                awts.push_back(sch->schedule(
+                    [](hce::chan<T> ch, T* t) -> hce::co<bool> {
+                        co_return co_await ch.recv(*t);
+                    }(ch, &(received[i]))));
+            }
+
+            std::vector<T> values = expected;
+            auto it = values.begin();
+
+            while(it != values.begin() + received.size()) {
+                it += (size_t)ch.send_n(it, values.begin() + received.size());
+            }
+
+            for(auto& awt : awts) { ASSERT_TRUE((bool)std::move(awt)); }
+
+            // every value was received once, in any order
+            for(size_t i = 0; i < received.size(); ++i) {
+                ASSERT_EQ(1, std::count(received.begin(), received.end(), expected[i]));
+            }
+
+            // parked single sends are completed by a batch
+            std::vector<hce::awt<bool>> send_awts;
+
+            for(size_t i = 0; i < 4; ++i) {
+                send_awts.push_back(sch->schedule(
+                    [](hce::chan<T> ch, T t) -> hce::co<bool> {
+                        co_return co_await ch.send(std::move(t));
+                    }(ch, expected[i])));
+            }
+
+            std::vector<T> out;
+            std::vector<T> batch(4);
+
+            while(out.size() < 4) {
+                size_t n = ch.recv_n(batch.begin(), 4);
+                ASSERT_NE(0u, n);
+                out.insert(out.end(), batch.begin(), batch.begin() + n);
+            }
+
+            for(auto& awt : send_awts) { ASSERT_TRUE((bool)std::move(awt)); }
+
+            for(size_t i = 0; i < 4; ++i) {
+                ASSERT_EQ(1, std::count(out.begin(), out.end(), expected[i]));
+            }
+
+            ++success_count;
+        };
+
+        for(auto& make : makers) { 
+            auto ch = make();
+
+            // spsc allows only one concurrent sender and receiver
+            if(ch.type_info() != typeid(hce::channel::spsc<T>)) { test(ch); }
+        }
+    }
+
+    return success_count;
+}
+
+}
+}
+
+TEST(channel, send_n_recv_n) {
+    const size_t expected = 41;
+    ASSERT_EQ(expected, test::channel::send_n_recv_n_T<int>());
+    ASSERT_EQ(expected, test::channel::send_n_recv_n_T<size_t>());
+    ASSERT_EQ(expected, test::channel::send_n_recv_n_T<double>());
+    ASSERT_EQ(expected, test::channel::send_n_recv_n_T<std::string>());
+    ASSERT_EQ(expected, test::channel::send_n_recv_n_T<test::CustomObject>());
+}
+
+namespace test {
+namespace channel {
+
+template <typename T, typename C>
+hce::co<size_t> co_embedded_send(C* c, size_t count) {
+    size_t sent = 0;
+
+    for(size_t i = 0; i < count; ++i) {
+        if(co_await c->embedded_send((T)test::init<T>(i))) { ++sent; }
+    }
+
+    c->close();
+    co_return sent;
+}
+
+template <typename T, typename C>
+hce::co<size_t> co_embedded_recv(C* c) {
+    size_t received = 0;
+    T t;
+
+    while(co_await c->embedded_recv(t)) { 
+        if((T)test::init<T>(received) != t) { break; }
+        ++received; 
+    }
+
+    co_return received;
+}
+
+// embedded operations between coroutines, and between a coroutine and a thread
+template <typename T, typename C>
+size_t embedded_C(std::function<std::shared_ptr<C>()> make) {
+    const size_t count = 100;
+    size_t success_count = 0;
+
+    {
+        auto c = make();
+        auto recv_awt = hce::schedule(co_embedded_recv<T>(c.get()));
+        auto send_awt = hce::schedule(co_embedded_send<T>(c.get(), count));
+        EXPECT_EQ(count, (size_t)std::move(send_awt));
+        EXPECT_EQ(count, (size_t)std::move(recv_awt));
+        ++success_count;
+    }
+
+    {
+        auto c = make();
+        auto recv_awt = hce::schedule(co_embedded_recv<T>(c.get()));
+
+        for(size_t i = 0; i < count; ++i) {
+            bool sent = c->embedded_send((T)test::init<T>(i));
+            EXPECT_TRUE(sent);
+        }
+
+        c->close();
+        EXPECT_EQ(count, (size_t)std::move(recv_awt));
+        ++success_count;
+    }
+
+    {
+        auto c = make();
+        auto send_awt = hce::schedule(co_embedded_send<T>(c.get(), count));
+        size_t received = 0;
+        T t;
+
+        while(true) {
+            bool success = c->embedded_recv(t);
+
+            if(!success || (T)test::init<T>(received) != t) { break; }
+            ++received;
+        }
+
+        EXPECT_EQ(count, (size_t)std::move(send_awt));
+        EXPECT_EQ(count, received);
+        ++success_count;
+    }
+
+    return success_count;
+}
+
+template <typename T>
+size_t embedded_T() {
+    std::string fname = hce::type::templatize<T>("embedded_T");
+    size_t success_count = 0;
+
+    HCE_INFO_FUNCTION_BODY(fname, "unbuffered");
+    success_count += embedded_C<T,hce::channel::unbuffered<T>>([]{ 
+        return std::make_shared<hce::channel::unbuffered<T>>(); 
+    });
+
+    HCE_INFO_FUNCTION_BODY(fname, "buffered");
+    success_count += embedded_C<T,hce::channel::buffered<T>>([]{ 
+        return std::make_shared<hce::channel::buffered<T>>(4); 
+    });
+
+    HCE_INFO_FUNCTION_BODY(fname, "unlimited");
+    success_count += embedded_C<T,hce::channel::unlimited<T>>([]{ 
+        return std::make_shared<hce::channel::unlimited<T>>(); 
+    });
+
+    HCE_INFO_FUNCTION_BODY(fname, "spsc");
+    success_count += embedded_C<T,hce::channel::spsc<T>>([]{ 
+        return std::make_shared<hce::channel::spsc<T>>(4); 
+    });
+
+    HCE_INFO_FUNCTION_BODY(fname, "mpmc");
+    success_count += embedded_C<T,hce::channel::mpmc<T>>([]{ 
+        return std::make_shared<hce::channel::mpmc<T>>(4); 
+    });
+
+    return success_count;
+}
+
+template <typename T, typename C>
+hce::co<size_t> co_typed_send(C c, size_t count) {
+    size_t sent = 0;
+
+    for(size_t i = 0; i < count; ++i) {
+        if(co_await c.send((T)test::init<T>(i))) { ++sent; }
+    }
+
+    c.close();
+    co_return sent;
+}
+
+template <typename T, typename C>
+hce::co<size_t> co_typed_recv(C c) {
+    size_t received = 0;
+    T t;
+
+    while(co_await c.recv(t)) { 
+        if((T)test::init<T>(received) != t) { break; }
+        ++received; 
+    }
+
+    co_return received;
+}
+
+// statically dispatched operations, including through a type-erased copy
+template <typename T, typename IMPLEMENTATION, typename... As>
+size_t typed_chan_C(As... as) {
+    const size_t count = 100;
+    size_t success_count = 0;
+
+    {
+        // copies in the coroutines outlive the original handle
+        auto c = hce::typed_chan<IMPLEMENTATION>::make(as...);
+        EXPECT_EQ(typeid(IMPLEMENTATION), c.type_info());
+        auto recv_awt = hce::schedule(co_typed_recv<T>(c));
+        auto send_awt = hce::schedule(co_typed_send<T>(c, count));
+        c = hce::typed_chan<IMPLEMENTATION>();
+        EXPECT_FALSE((bool)c);
+        EXPECT_EQ(count, (size_t)std::move(send_awt));
+        EXPECT_EQ(count, (size_t)std::move(recv_awt));
+        ++success_count;
+    }
+
+    {
+        // a type-erased chan shares the implementation
+        auto c = hce::typed_chan<IMPLEMENTATION>::make(as...);
+        hce::chan<T> erased = c;
+        EXPECT_EQ(c.type_info(), erased.type_info());
+        EXPECT_EQ((void*)&(c.context()), (void*)erased.context().get());
+        auto recv_awt = hce::schedule(co_typed_recv<T>(c));
+        c = hce::typed_chan<IMPLEMENTATION>();
+        auto send_awt = hce::schedule(co_typed_send<T>(erased, count));
+        erased = hce::chan<T>();
+        EXPECT_EQ(count, (size_t)std::move(send_awt));
+        EXPECT_EQ(count, (size_t)std::move(recv_awt));
+        ++success_count;
+    }
+
+    {
+        // operations from a thread
+        auto c = hce::typed_chan<IMPLEMENTATION>::make(as...);
+        auto send_awt = hce::schedule(co_typed_send<T>(c, count));
+        size_t received = 0;
+        T t;
+
+        while(true) {
+            bool success = c.recv(t);
+
+            if(!success || (T)test::init<T>(received) != t) { break; }
+            ++received;
+        }
+
+        EXPECT_EQ(count, (size_t)std::move(send_awt));
+        EXPECT_EQ(count, received);
+        EXPECT_TRUE(c.closed());
+        EXPECT_EQ(hce::channel::result::closed, (hce::channel::result)c.try_recv(t));
+        ++success_count;
+    }
+
+    return success_count;
+}
+
+template <typename T>
+size_t typed_chan_T() {
+    std::string fname = hce::type::templatize<T>("typed_chan_T");
+    size_t success_count = 0;
+
+    HCE_INFO_FUNCTION_BODY(fname, "unbuffered");
+    success_count += typed_chan_C<T,hce::channel::unbuffered<T>>();
+
+    HCE_INFO_FUNCTION_BODY(fname, "buffered");
+    success_count += typed_chan_C<T,hce::channel::buffered<T>>(4);
+
+    HCE_INFO_FUNCTION_BODY(fname, "unlimited");
+    success_count += typed_chan_C<T,hce::channel::unlimited<T>>();
+
+    HCE_INFO_FUNCTION_BODY(fname, "spsc");
+    success_count += typed_chan_C<T,hce::channel::spsc<T>>(4);
+
+    HCE_INFO_FUNCTION_BODY(fname, "mpmc");
+    success_count += typed_chan_C<T,hce::channel::mpmc<T>>(4);
+
+    return success_count;
+}
+
+template <typename T>
+hce::co<size_t> co_reader_send(hce::chan<T> ch, size_t count) {
+    size_t sent = 0;
+
+    for(size_t i = 0; i < count; ++i) {
+        if(co_await ch.send((T)test::init<T>(i))) { ++sent; }
+    }
+
+    ch.close();
+    co_return sent;
+}
+
+template <typename T>
+hce::co<size_t> co_reader_recv(hce::chan<T> ch) {
+    hce::channel::reader<T> r(ch, 8);
+    size_t received = 0;
+    T t;
+
+    while(co_await r.recv(t)) {
+        if((T)test::init<T>(received) != t) { break; }
+        ++received;
+    }
+
+    co_return received;
+}
+
+// batched receives from a coroutine and from a thread
+template <typename T>
+size_t reader_C(std::function<hce::chan<T>()> make) {
+    const size_t count = 100;
+    size_t success_count = 0;
+
+    {
+        auto ch = make();
+        auto recv_awt = hce::schedule(co_reader_recv<T>(ch));
+        auto send_awt = hce::schedule(co_reader_send<T>(ch, count));
+        EXPECT_EQ(count, (size_t)std::move(send_awt));
+        EXPECT_EQ(count, (size_t)std::move(recv_awt));
+        ++success_count;
+    }
+
+    {
+        auto ch = make();
+        auto send_awt = hce::schedule(co_reader_send<T>(ch, count));
+        hce::channel::reader<T> r(ch, 8);
+        size_t received = 0;
+        T t;
+
+        while(r.recv(t)) {
+            if((T)test::init<T>(received) != t) { break; }
+            ++received;
+        }
+
+        EXPECT_EQ(count, (size_t)std::move(send_awt));
+        EXPECT_EQ(count, received);
+        ++success_count;
+    }
+
+    return success_count;
+}
+
+template <typename T>
+size_t reader_T() {
+    std::string fname = hce::type::templatize<T>("reader_T");
+    size_t success_count = 0;
+
+    HCE_INFO_FUNCTION_BODY(fname, "unbuffered");
+    success_count += reader_C<T>([]{ return hce::chan<T>::make(0); });
+
+    HCE_INFO_FUNCTION_BODY(fname, "buffered");
+    success_count += reader_C<T>([]{ return hce::chan<T>::make(4); });
+
+    HCE_INFO_FUNCTION_BODY(fname, "unlimited");
+    success_count += reader_C<T>([]{ return hce::chan<T>::make(-1); });
+
+    HCE_INFO_FUNCTION_BODY(fname, "spsc");
+    success_count += reader_C<T>([]{ 
+        return hce::chan<T>::template make<hce::channel::spsc>(4); 
+    });
+
+    HCE_INFO_FUNCTION_BODY(fname, "mpmc");
+    success_count += reader_C<T>([]{ 
+        return hce::chan<T>::template make<hce::channel::mpmc>(4); 
+    });
+
+    return success_count;
+}
+
+}
+}
+
+TEST(channel, embedded) {
+    const size_t expected = 15;
+    ASSERT_EQ(expected, test::channel::embedded_T<int>());
+    ASSERT_EQ(expected, test::channel::embedded_T<size_t>());
+    ASSERT_EQ(expected, test::channel::embedded_T<double>());
+    ASSERT_EQ(expected, test::channel::embedded_T<std::string>());
+    ASSERT_EQ(expected, test::channel::embedded_T<test::CustomObject>());
+}
+
+TEST(channel, typed_chan) {
+    const size_t expected = 15;
+    ASSERT_EQ(expected, test::channel::typed_chan_T<int>());
+    ASSERT_EQ(expected, test::channel::typed_chan_T<size_t>());
+    ASSERT_EQ(expected, test::channel::typed_chan_T<double>());
+    ASSERT_EQ(expected, test::channel::typed_chan_T<std::string>());
+    ASSERT_EQ(expected, test::channel::typed_chan_T<test::CustomObject>());
+}
+
+TEST(channel, reader) {
+    const size_t expected = 10;
+    ASSERT_EQ(expected, test::channel::reader_T<int>());
+    ASSERT_EQ(expected, test::channel::reader_T<size_t>());
+    ASSERT_EQ(expected, test::channel::reader_T<double>());
+    ASSERT_EQ(expected, test::channel::reader_T<std::string>());
+    ASSERT_EQ(expected, test::channel::reader_T<test::CustomObject>());
+
+    // buffered values are received in one batch
+    auto ch = hce::chan<int>::make(-1);
+
+    for(int i = 0; i < 10; ++i) { 
+        EXPECT_EQ(hce::channel::result::success, (hce::channel::result)ch.try_send(i)); 
+    }
+
+    hce::channel::reader<int> r(ch, 64);
+    int i;
+    EXPECT_EQ(0, r.batched());
+    EXPECT_TRUE((bool)r.recv(i));
+    EXPECT_EQ(0, i);
+    EXPECT_EQ(9, r.batched());
+    EXPECT_EQ(0, ch.used());
+    ch.close();
+
+    for(int v = 1; v < 10; ++v) {
+        EXPECT_TRUE((bool)r.recv(i));
+        EXPECT_EQ(v, i);
+    }
+
+    EXPECT_FALSE((bool)r.recv(i));
+}
@@ -51,6 +51,28 @@ void launch_core_multiplier_op(F&& f, size_t multiplier, As&&... as)
     f(concurrent_count, std::forward<As>(as)...);
 }
 
+/// tag to construct channels with hce::channel::spsc
+struct spsc { };
+
+// construct an unbuffered channel with the given LOCK
+template <typename LOCK>
+void construct_channel(hce::chan<int>& ch) {
+    ch.construct<LOCK>(0);
+}
+
+template <>
+void construct_channel<spsc>(hce::chan<int>& ch) {
+    ch.construct<hce::channel::spsc>(1);
+}
+
+/// tag to construct channels with hce::channel::mpmc
+struct mpmc { };
+
+template <>
+void construct_channel<mpmc>(hce::chan<int>& ch) {
+    ch.construct<hce::channel::mpmc>(2);
+}
+
 template <typename LOCK>
 void system_thread_simple_communication_op(
         std::uint64_t thread_total, 
@@ -91,8 +113,8 @@ void system_thread_simple_communication_op(
 
     for(std::uint64_t c=0; c<repeat; ++c) {
         hce::chan<int> ch0, ch1;
-        ch0.construct<LOCK>(0);
-        ch1.construct<LOCK>(0);
+        construct_channel<LOCK>(ch0);
+        construct_channel<LOCK>(ch1);
         thds.push_back(std::thread(ops::com0,ch0,ch1,recv_total));
     }
 
@@ -115,8 +137,8 @@ void concurrent_simple_communication_op(
 
             for(std::uint64_t c=0; c<repeat; ++c) {
                 hce::chan<int> ch0, ch1;
-                ch0.construct<LOCK>(0);
-                ch1.construct<LOCK>(0);
+                construct_channel<LOCK>(ch0);
+                construct_channel<LOCK>(ch1);
                 awts.push_back(hce::threadpool::schedule(ops::com0(ch0,ch1,recv_total)));
             }
 
@@ -277,3 +299,97 @@ TEST(comparison_system_thread_simple_communication_over_mutex_channel, 8x_core_c
 TEST(comparison_system_thread_simple_communication_over_mutex_channel, 16x_core_count_coroutines_communicating_in_pairs_10000_msgs_sent_per_coroutine) {
     test::launch_core_multiplier_op(test::system_thread_simple_communication_op<std::mutex>, 16, 10000);
 }
+
+//------------------------------------------------------------------------------
+// hce::channel::spsc 
+
+// coroutine
+
+TEST(comparison_concurrent_simple_communication_over_spsc_channel, 1x_core_count_coroutines_communicating_in_pairs_10000_msgs_sent_per_coroutine) {
+    test::launch_core_multiplier_op(test::concurrent_simple_communication_op<test::spsc>, 1, 10000);
+}
+
+TEST(comparison_concurrent_simple_communication_over_spsc_channel, 2x_core_count_coroutines_communicating_in_pairs_10000_msgs_sent_per_coroutine) {
+    test::launch_core_multiplier_op(test::concurrent_simple_communication_op<test::spsc>, 2, 10000);
+}
+
+TEST(comparison_concurrent_simple_communication_over_spsc_channel, 4x_core_count_coroutines_communicating_in_pairs_10000_msgs_sent_per_coroutine) {
+    test::launch_core_multiplier_op(test::concurrent_simple_communication_op<test::spsc>, 4, 10000);
+}
+
+TEST(comparison_concurrent_simple_communication_over_spsc_channel, 8x_core_count_coroutines_communicating_in_pairs_10000_msgs_sent_per_coroutine) {
+    test::launch_core_multiplier_op(test::concurrent_simple_communication_op<test::spsc>, 8, 10000);
+}
+
+TEST(comparison_concurrent_simple_communication_over_spsc_channel, 16x_core_count_coroutines_communicating_in_pairs_10000_msgs_sent_per_coroutine) {
+    test::launch_core_multiplier_op(test::concurrent_simple_communication_op<test::spsc>, 16, 10000);
+}
+
+// thread
+
+TEST(comparison_system_thread_simple_communication_over_spsc_channel, 1x_core_count_coroutines_communicating_in_pairs_10000_msgs_sent_per_coroutine) {
+    test::launch_core_multiplier_op(test::system_thread_simple_communication_op<test::spsc>, 1, 10000);
+}
+
+TEST(comparison_system_thread_simple_communication_over_spsc_channel, 2x_core_count_coroutines_communicating_in_pairs_10000_msgs_sent_per_coroutine) {
+    test::launch_core_multiplier_op(test::system_thread_simple_communication_op<test::spsc>, 2, 10000);
+}
+
+TEST(comparison_system_thread_simple_communication_over_spsc_channel, 4x_core_count_coroutines_communicating_in_pairs_10000_msgs_sent_per_coroutine) {
+    test::launch_core_multiplier_op(test::system_thread_simple_communication_op<test::spsc>, 4, 10000);
+}
+
+TEST(comparison_system_thread_simple_communication_over_spsc_channel, 8x_core_count_coroutines_communicating_in_pairs_10000_msgs_sent_per_coroutine) {
+    test::launch_core_multiplier_op(test::system_thread_simple_communication_op<test::spsc>, 8, 10000);
+}
+
+TEST(comparison_system_thread_simple_communication_over_spsc_channel, 16x_core_count_coroutines_communicating_in_pairs_10000_msgs_sent_per_coroutine) {
+    test::launch_core_multiplier_op(test::system_thread_simple_communication_op<test::spsc>, 16, 10000);
+}
+
+//------------------------------------------------------------------------------
+// hce::channel::mpmc 
+
+// coroutine
+
+TEST(comparison_concurrent_simple_communication_over_mpmc_channel, 1x_core_count_coroutines_communicating_in_pairs_10000_msgs_sent_per_coroutine) {
+    test::launch_core_multiplier_op(test::concurrent_simple_communication_op<test::mpmc>, 1, 10000);
+}
+
+TEST(comparison_concurrent_simple_communication_over_mpmc_channel, 2x_core_count_coroutines_communicating_in_pairs_10000_msgs_sent_per_coroutine) {
+    test::launch_core_multiplier_op(test::concurrent_simple_communication_op<test::mpmc>, 2, 10000);
+}
+
+TEST(comparison_concurrent_simple_communication_over_mpmc_channel, 4x_core_count_coroutines_communicating_in_pairs_10000_msgs_sent_per_coroutine) {
+    test::launch_core_multiplier_op(test::concurrent_simple_communication_op<test::mpmc>, 4, 10000);
+}
+
+TEST(comparison_concurrent_simple_communication_over_mpmc_channel, 8x_core_count_coroutines_communicating_in_pairs_10000_msgs_sent_per_coroutine) {
+    test::launch_core_multiplier_op(test::concurrent_simple_communication_op<test::mpmc>, 8, 10000);
+}
+
+TEST(comparison_concurrent_simple_communication_over_mpmc_channel, 16x_core_count_coroutines_communicating_in_pairs_10000_msgs_sent_per_coroutine) {
+    test::launch_core_multiplier_op(test::concurrent_simple_communication_op<test::mpmc>, 16, 10000);
+}
+
+// thread
+
+TEST(comparison_system_thread_simple_communication_over_mpmc_channel, 1x_core_count_coroutines_communicating_in_pairs_10000_msgs_sent_per_coroutine) {
+    test::launch_core_multiplier_op(test::system_thread_simple_communication_op<test::mpmc>, 1, 10000);
+}
+
+TEST(comparison_system_thread_simple_communication_over_mpmc_channel, 2x_core_count_coroutines_communicating_in_pairs_10000_msgs_sent_per_coroutine) {
+    test::launch_core_multiplier_op(test::system_thread_simple_communication_op<test::mpmc>, 2, 10000);
+}
+
+TEST(comparison_system_thread_simple_communication_over_mpmc_channel, 4x_core_count_coroutines_communicating_in_pairs_10000_msgs_sent_per_coroutine) {
+    test::launch_core_multiplier_op(test::system_thread_simple_communication_op<test::mpmc>, 4, 10000);
+}
+
+TEST(comparison_system_thread_simple_communication_over_mpmc_channel, 8x_core_count_coroutines_communicating_in_pairs_10000_msgs_sent_per_coroutine) {
+    test::launch_core_multiplier_op(test::system_thread_simple_communication_op<test::mpmc>, 8, 10000);
+}
+
+TEST(comparison_system_thread_simple_communication_over_mpmc_channel, 16x_core_count_coroutines_communicating_in_pairs_10000_msgs_sent_per_coroutine) {
+    test::launch_core_multiplier_op(test::system_thread_simple_communication_op<test::mpmc>, 16, 10000);
+}
@@ -9,16 +9,16 @@ TEST(id, uid) {
     hce::uid uid;
     hce::uid uid2;
 
-    ASSERT_EQ(nullptr, uid.get());
-    ASSERT_EQ(nullptr, uid2.get());
+    ASSERT_EQ(0u, uid.get());
+    ASSERT_EQ(0u, uid2.get());
     ASSERT_FALSE(uid);
     ASSERT_FALSE(uid2);
     ASSERT_EQ(uid, uid2);
 
     uid.make();
 
-    ASSERT_NE(nullptr, uid.get());
-    ASSERT_EQ(nullptr, uid2.get());
+    ASSERT_NE(0u, uid.get());
+    ASSERT_EQ(0u, uid2.get());
     ASSERT_TRUE(uid);
     ASSERT_FALSE(uid2);
     ASSERT_EQ(uid, uid);
@@ -27,28 +27,28 @@ TEST(id, uid) {
 
     uid2 = std::move(uid);
 
-    ASSERT_EQ(nullptr, uid.get());
-    ASSERT_NE(nullptr, uid2.get());
+    ASSERT_EQ(0u, uid.get());
+    ASSERT_NE(0u, uid2.get());
     ASSERT_FALSE(uid);
     ASSERT_TRUE(uid2);
 
     uid.make();
     ASSERT_NE(uid, uid2);
-    ASSERT_NE(nullptr, uid.get());
-    ASSERT_NE(nullptr, uid2.get());
+    ASSERT_NE(0u, uid.get());
+    ASSERT_NE(0u, uid2.get());
     ASSERT_TRUE(uid);
     ASSERT_TRUE(uid2);
 
     uid2.reset();
-    ASSERT_NE(nullptr, uid.get());
-    ASSERT_EQ(nullptr, uid2.get());
+    ASSERT_NE(0u, uid.get());
+    ASSERT_EQ(0u, uid2.get());
     ASSERT_TRUE(uid);
     ASSERT_FALSE(uid2);
     ASSERT_NE(uid, uid2);
 
     uid.reset();
-    ASSERT_EQ(nullptr, uid.get());
-    ASSERT_EQ(nullptr, uid2.get());
+    ASSERT_EQ(0u, uid.get());
+    ASSERT_EQ(0u, uid2.get());
     ASSERT_FALSE(uid);
     ASSERT_FALSE(uid2);
     ASSERT_EQ(uid, uid2);
@@ -58,16 +58,16 @@ TEST(id, sid) {
     hce::sid sid;
     hce::sid sid2;
 
-    ASSERT_EQ(nullptr, sid.get());
-    ASSERT_EQ(nullptr, sid2.get());
+    ASSERT_EQ(0u, sid.get());
+    ASSERT_EQ(0u, sid2.get());
     ASSERT_FALSE(sid);
     ASSERT_FALSE(sid2);
     ASSERT_EQ(sid, sid2);
 
     sid.make();
 
-    ASSERT_NE(nullptr, sid.get());
-    ASSERT_EQ(nullptr, sid2.get());
+    ASSERT_NE(0u, sid.get());
+    ASSERT_EQ(0u, sid2.get());
     ASSERT_TRUE(sid);
     ASSERT_FALSE(sid2);
     ASSERT_EQ(sid, sid);
@@ -77,21 +77,21 @@ TEST(id, sid) {
     sid2 = sid;
 
     ASSERT_EQ(sid, sid2);
-    ASSERT_NE(nullptr, sid.get());
-    ASSERT_NE(nullptr, sid2.get());
+    ASSERT_NE(0u, sid.get());
+    ASSERT_NE(0u, sid2.get());
     ASSERT_TRUE(sid);
     ASSERT_TRUE(sid2);
 
     sid.reset();
     ASSERT_NE(sid, sid2);
-    ASSERT_EQ(nullptr, sid.get());
-    ASSERT_NE(nullptr, sid2.get());
+    ASSERT_EQ(0u, sid.get());
+    ASSERT_NE(0u, sid2.get());
     ASSERT_FALSE(sid);
     ASSERT_TRUE(sid2);
 
     sid2.reset();
-    ASSERT_EQ(nullptr, sid.get());
-    ASSERT_EQ(nullptr, sid2.get());
+    ASSERT_EQ(0u, sid.get());
+    ASSERT_EQ(0u, sid2.get());
     ASSERT_FALSE(sid);
     ASSERT_FALSE(sid2);
     ASSERT_EQ(sid, sid2);
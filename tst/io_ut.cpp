@@ -0,0 +1,642 @@
+//SPDX-License-Identifier: Apache-2.0
+//Author: Blayne Dennis
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <csignal>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <chrono>
+#include <memory>
+
+#include "loguru.hpp"
+#include "scheduler.hpp"
+#include "threadpool.hpp"
+#include "io.hpp"
+
+#include <gtest/gtest.h>
+#include "test_helpers.hpp"
+
+namespace test {
+namespace io {
+
+// create a unique temporary file path
+inline std::string temporary_path() {
+    char path[] = "/tmp/hce_io_ut_XXXXXX";
+    int fd = mkstemp(path);
+    ::close(fd);
+    return std::string(path);
+}
+
+hce::co<std::string> co_write_read(std::string path, std::string s) {
+    hce::io::file f = co_await hce::io::file::open(path, O_RDWR | O_TRUNC);
+
+    if(!f) { co_return std::string(); }
+
+    ssize_t written = co_await f.write(s.data(), s.size(), 0);
+
+    if(written != (ssize_t)s.size()) { co_return std::string(); }
+
+    int synced = co_await f.fsync();
+
+    if(synced != 0) { co_return std::string(); }
+
+    std::string buf(s.size(), '\0');
+    ssize_t read = co_await f.read(buf.data(), buf.size(), 0);
+    buf.resize(read < 0 ? 0 : read);
+    co_return buf;
+}
+
+hce::co<ssize_t> co_read_offset(hce::io::file* f, off_t offset, char* c) {
+    co_return co_await f->read(c, 1, offset);
+}
+
+// make a scheduler with an epoll reactor
+inline std::unique_ptr<hce::scheduler::lifecycle> make_reactor_scheduler() {
+    hce::config::scheduler::config cfg;
+    cfg.reactor = true;
+    return hce::scheduler::make(cfg);
+}
+
+// read count bytes from a non-blocking descriptor, awaiting readability
+hce::co<std::string> co_read_ready(int fd, size_t count) {
+    std::string s;
+    char buf[64];
+
+    while(s.size() < count) {
+        ssize_t r = ::read(fd, buf, std::min(sizeof(buf), count - s.size()));
+
+        if(r > 0) {
+            s.append(buf, r);
+        } else if(r < 0 && errno == EAGAIN) {
+            if(co_await hce::io::readable(fd)) { break; }
+        } else {
+            break;
+        }
+    }
+
+    co_return s;
+}
+
+// write a string to a non-blocking descriptor, awaiting writability
+hce::co<bool> co_write_ready(int fd, std::string s) {
+    size_t written = 0;
+
+    while(written < s.size()) {
+        if(co_await hce::io::writable(fd)) { co_return false; }
+
+        ssize_t r = ::write(fd, s.data() + written, s.size() - written);
+
+        if(r > 0) {
+            written += r;
+        } else if(!(r < 0 && errno == EAGAIN)) {
+            co_return false;
+        }
+    }
+
+    co_return true;
+}
+
+// read count bytes from a non-blocking descriptor, then close it
+hce::co<std::string> co_read_close(int fd, size_t count) {
+    std::string s;
+    char buf[4096];
+
+    while(s.size() < count) {
+        ssize_t r = ::read(fd, buf, std::min(sizeof(buf), count - s.size()));
+
+        if(r > 0) {
+            s.append(buf, r);
+        } else if(r < 0 && errno == EAGAIN) {
+            if(co_await hce::io::readable(fd)) { break; }
+        } else {
+            break;
+        }
+    }
+
+    ::close(fd);
+    co_return s;
+}
+
+// ignore SIGPIPE while in scope, so writes to closed peers fail with EPIPE
+struct ignore_sigpipe {
+    ignore_sigpipe() : previous(std::signal(SIGPIPE, SIG_IGN)) { }
+    ~ignore_sigpipe() { std::signal(SIGPIPE, previous); }
+    void (*previous)(int);
+};
+
+}
+}
+
+TEST(io, backend) {
+    auto& s = hce::io::service::get();
+
+#ifdef __linux__
+    // io_uring may be unavailable to the process, in which case the service
+    // falls back to the blocking backend
+    if(hce::config::io::service_backend() ==
+       hce::config::io::backend::blocking)
+    {
+        EXPECT_EQ(hce::config::io::backend::blocking, s.backend());
+    }
+#else
+    EXPECT_EQ(hce::config::io::backend::blocking, s.backend());
+#endif
+
+    EXPECT_EQ(0u, s.outstanding());
+}
+
+TEST(io, file_write_read) {
+    const std::string path = test::io::temporary_path();
+    const std::string s("hello hce::io::file");
+
+    // coroutine
+    {
+        auto lf = hce::scheduler::make();
+        std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+        std::string result = sch->schedule(test::io::co_write_read(path, s));
+        EXPECT_EQ(s, result);
+    }
+
+    // thread
+    {
+        hce::io::file f = hce::io::file::open(path, O_RDONLY);
+        ASSERT_TRUE((bool)f);
+        EXPECT_EQ(0, f.error());
+
+        std::string buf(s.size(), '\0');
+        ssize_t read = f.read(buf.data(), buf.size(), 0);
+        EXPECT_EQ((ssize_t)s.size(), read);
+        EXPECT_EQ(s, buf);
+
+        // reading past the end of the file returns 0
+        read = f.read(buf.data(), buf.size(), s.size());
+        EXPECT_EQ(0, read);
+    }
+
+    ::unlink(path.c_str());
+}
+
+TEST(io, file_errors) {
+    hce::io::file f = hce::io::file::open("/tmp/hce_io_ut_does/not/exist",
+                                          O_RDONLY);
+    EXPECT_FALSE((bool)f);
+    EXPECT_EQ(-1, f.fd());
+    EXPECT_EQ(ENOENT, f.error());
+
+    // operations on an invalid descriptor fail with a negative errno
+    char c;
+    ssize_t read = f.read(&c, 1, 0);
+    EXPECT_EQ(-EBADF, read);
+}
+
+TEST(io, file_concurrent_reads) {
+    const std::string path = test::io::temporary_path();
+    const size_t count = 1000;
+    std::string s;
+
+    for(size_t i = 0; i < count; ++i) {
+        s.push_back((char)('a' + (i % 26)));
+    }
+
+    {
+        hce::io::file f = hce::io::file::open(path, O_WRONLY | O_TRUNC);
+        ASSERT_TRUE((bool)f);
+        ssize_t written = f.write(s.data(), s.size(), 0);
+        ASSERT_EQ((ssize_t)s.size(), written);
+    }
+
+    hce::io::file f = hce::io::file::open(path, O_RDONLY);
+    ASSERT_TRUE((bool)f);
+
+    std::vector<char> results(count, '\0');
+    std::deque<hce::awt<ssize_t>> awts;
+
+    // every read is outstanding at once
+    for(size_t i = 0; i < count; ++i) {
+        awts.push_back(hce::threadpool::schedule(
+            test::io::co_read_offset(&f, i, &(results[i]))));
+    }
+
+    for(auto& awt : awts) {
+        ssize_t read = std::move(awt);
+        EXPECT_EQ(1, read);
+    }
+
+    for(size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(s[i], results[i]);
+    }
+
+    EXPECT_EQ(0u, hce::io::service::get().outstanding());
+    ::unlink(path.c_str());
+}
+
+TEST(io, file_concurrent_submitters) {
+    const std::string path = test::io::temporary_path();
+    const size_t count = 500;
+    const size_t scheduler_count = 4;
+    std::string s;
+
+    for(size_t i = 0; i < count; ++i) {
+        s.push_back((char)('a' + (i % 26)));
+    }
+
+    {
+        hce::io::file f = hce::io::file::open(path, O_WRONLY | O_TRUNC);
+        ASSERT_TRUE((bool)f);
+        ssize_t written = f.write(s.data(), s.size(), 0);
+        ASSERT_EQ((ssize_t)s.size(), written);
+    }
+
+    hce::io::file f = hce::io::file::open(path, O_RDONLY);
+    ASSERT_TRUE((bool)f);
+
+    std::vector<std::unique_ptr<hce::scheduler::lifecycle>> lfs;
+    std::vector<std::vector<char>> results(
+        scheduler_count, 
+        std::vector<char>(count, '\0'));
+    std::deque<hce::awt<ssize_t>> awts;
+
+    for(size_t i = 0; i < scheduler_count; ++i) {
+        lfs.push_back(hce::scheduler::make());
+    }
+
+    // every scheduler thread submits more reads than the ring has entries
+    for(size_t i = 0; i < count; ++i) {
+        for(size_t j = 0; j < scheduler_count; ++j) {
+            awts.push_back(lfs[j]->get_scheduler().schedule(
+                test::io::co_read_offset(&f, i, &(results[j][i]))));
+        }
+    }
+
+    for(auto& awt : awts) {
+        ssize_t read = std::move(awt);
+        EXPECT_EQ(1, read);
+    }
+
+    for(size_t j = 0; j < scheduler_count; ++j) {
+        for(size_t i = 0; i < count; ++i) {
+            EXPECT_EQ(s[i], results[j][i]);
+        }
+    }
+
+    EXPECT_EQ(0u, hce::io::service::get().outstanding());
+    ::unlink(path.c_str());
+}
+
+TEST(io, reactor_pipe) {
+    auto lf = test::io::make_reactor_scheduler();
+    std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+
+#ifdef __linux__
+    EXPECT_TRUE(sch->reactor());
+#endif
+
+    int fds[2];
+    ASSERT_EQ(0, ::pipe2(fds, O_NONBLOCK));
+
+    const std::string s("hello hce::io::readable");
+
+    // writes arrive from another thread while the reader is suspended
+    auto awt = sch->schedule(test::io::co_read_ready(fds[0], s.size()));
+
+    std::thread thd([&]{
+        for(char c : s) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            ASSERT_EQ(1, ::write(fds[1], &c, 1));
+        }
+    });
+
+    std::string result = std::move(awt);
+    thd.join();
+    EXPECT_EQ(s, result);
+
+    // the writer and reader can both await the same scheduler
+    const std::string big(1 << 20, 'x');
+    auto read_awt = sch->schedule(test::io::co_read_ready(fds[0], big.size()));
+    auto write_awt = sch->schedule(test::io::co_write_ready(fds[1], big));
+    EXPECT_TRUE((bool)std::move(write_awt));
+    EXPECT_EQ(big, (std::string)std::move(read_awt));
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+TEST(io, reactor_loopback_socket) {
+    auto lf = test::io::make_reactor_scheduler();
+    std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+
+    int listener = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    ASSERT_LE(0, listener);
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t len = sizeof(addr);
+    ASSERT_EQ(0, ::bind(listener, (sockaddr*)&addr, sizeof(addr)));
+    ASSERT_EQ(0, ::listen(listener, 1));
+    ASSERT_EQ(0, ::getsockname(listener, (sockaddr*)&addr, &len));
+
+    // await the incoming connection
+    auto accept_awt = sch->schedule([](int listener) -> hce::co<int> {
+        int r = co_await hce::io::readable(listener);
+        co_return r ? r : ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK);
+    }(listener));
+
+    int client = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    ASSERT_LE(0, client);
+    int r = ::connect(client, (sockaddr*)&addr, sizeof(addr));
+    EXPECT_TRUE(r == 0 || errno == EINPROGRESS);
+
+    int server = std::move(accept_awt);
+    ASSERT_LE(0, server);
+
+    const std::string s("hello loopback");
+    auto read_awt = sch->schedule(test::io::co_read_ready(server, s.size()));
+    auto write_awt = sch->schedule(test::io::co_write_ready(client, s));
+    EXPECT_TRUE((bool)std::move(write_awt));
+    EXPECT_EQ(s, (std::string)std::move(read_awt));
+
+    // a hangup is reported as readiness and the read returns end of file
+    read_awt = sch->schedule(test::io::co_read_ready(server, 1));
+    ::close(client);
+    EXPECT_EQ(std::string(), (std::string)std::move(read_awt));
+
+    ::close(server);
+    ::close(listener);
+}
+
+TEST(io, reactor_cancel) {
+#ifdef __linux__
+    int fds[2];
+    ASSERT_EQ(0, ::pipe2(fds, O_NONBLOCK));
+
+    auto co_readable = [](int fd) -> hce::co<int> {
+        co_return co_await hce::io::readable(fd);
+    };
+
+    // cancelling a descriptor before closing it resumes its waiters
+    {
+        auto lf = test::io::make_reactor_scheduler();
+        std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+        auto awt = sch->schedule(co_readable(fds[0]));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        sch->schedule([](int fd) -> hce::co<void> {
+            hce::io::cancel(fd);
+            co_return;
+        }(fds[0]));
+
+        EXPECT_EQ(-ECANCELED, (int)std::move(awt));
+
+        // the descriptor can be awaited again
+        awt = sch->schedule(co_readable(fds[0]));
+        ASSERT_EQ(1, ::write(fds[1], "x", 1));
+        EXPECT_EQ(0, (int)std::move(awt));
+
+        char c;
+        ASSERT_EQ(1, ::read(fds[0], &c, 1));
+    }
+
+    // halting a scheduler resumes its waiters
+    {
+        hce::awt<int> awt;
+
+        {
+            auto lf = test::io::make_reactor_scheduler();
+            std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+            awt = sch->schedule(co_readable(fds[0]));
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+
+        EXPECT_EQ(-ECANCELED, (int)std::move(awt));
+    }
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+#endif
+}
+
+TEST(io, readable_without_reactor) {
+    int fds[2];
+    ASSERT_EQ(0, ::pipe2(fds, O_NONBLOCK));
+
+    const std::string s("hello poll");
+
+    // coroutine on a scheduler without a reactor
+    {
+        auto lf = hce::scheduler::make();
+        std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+        EXPECT_FALSE(sch->reactor());
+
+        auto awt = sch->schedule(test::io::co_read_ready(fds[0], s.size()));
+        ASSERT_EQ((ssize_t)s.size(), ::write(fds[1], s.data(), s.size()));
+        EXPECT_EQ(s, (std::string)std::move(awt));
+    }
+
+    // thread
+    {
+        int r = hce::io::writable(fds[1]);
+        EXPECT_EQ(0, r);
+
+        // a closed descriptor
+        int closed = ::dup(fds[0]);
+        ::close(closed);
+        r = hce::io::readable(closed);
+        EXPECT_EQ(-EBADF, r);
+    }
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+TEST(io, sendfile) {
+    const std::string path = test::io::temporary_path();
+    std::string s;
+
+    // larger than the socket buffers, so the transfer suspends repeatedly
+    for(size_t i = 0; i < (4 << 20); ++i) {
+        s.push_back((char)('a' + ((i * 7) % 26)));
+    }
+
+    hce::io::file f = hce::io::file::open(path, O_RDWR | O_TRUNC);
+    ASSERT_TRUE((bool)f);
+    ASSERT_EQ((ssize_t)s.size(), (ssize_t)f.write(s.data(), s.size(), 0));
+
+    int fds[2];
+    ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds));
+
+    // coroutine
+    {
+        auto lf = test::io::make_reactor_scheduler();
+        std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+
+        auto read_awt = sch->schedule(
+            test::io::co_read_ready(fds[1], s.size() - 1));
+        auto send_awt = sch->schedule(
+            [](int out, int in, size_t count) -> hce::co<ssize_t> {
+                co_return co_await hce::io::sendfile(out, in, 1, count);
+            }(fds[0], f.fd(), s.size()));
+
+        // the transfer stops at the end of the file
+        EXPECT_EQ((ssize_t)s.size() - 1, (ssize_t)std::move(send_awt));
+        EXPECT_EQ(s.substr(1), (std::string)std::move(read_awt));
+    }
+
+    // thread
+    {
+        ssize_t sent = hce::io::sendfile(fds[0], f.fd(), 3, 5);
+        EXPECT_EQ(5, sent);
+
+        char buf[5];
+        ASSERT_EQ(5, ::read(fds[1], buf, 5));
+        EXPECT_EQ(s.substr(3, 5), std::string(buf, 5));
+
+        sent = hce::io::sendfile(fds[0], -1, 0, 5);
+        EXPECT_EQ(-EBADF, sent);
+    }
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+    ::unlink(path.c_str());
+}
+
+TEST(io, sendfile_peer_closed) {
+    test::io::ignore_sigpipe ignore;
+    const std::string path = test::io::temporary_path();
+    const size_t received = 1 << 16;
+    std::string s;
+
+    // larger than the socket buffers, so the peer closes mid-transfer
+    for(size_t i = 0; i < (8 << 20); ++i) {
+        s.push_back((char)('a' + ((i * 7) % 26)));
+    }
+
+    hce::io::file f = hce::io::file::open(path, O_RDWR | O_TRUNC);
+    ASSERT_TRUE((bool)f);
+    ASSERT_EQ((ssize_t)s.size(), (ssize_t)f.write(s.data(), s.size(), 0));
+
+    int fds[2];
+    ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds));
+
+    auto lf = test::io::make_reactor_scheduler();
+    std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+
+    auto read_awt = sch->schedule(test::io::co_read_close(fds[1], received));
+    auto send_awt = sch->schedule(
+        [](int out, int in, size_t count) -> hce::co<ssize_t> {
+            co_return co_await hce::io::sendfile(out, in, 0, count);
+        }(fds[0], f.fd(), s.size()));
+
+    // the bytes sent before the peer closed are reported
+    ssize_t sent = std::move(send_awt);
+    EXPECT_EQ(s.substr(0, received), (std::string)std::move(read_awt));
+    EXPECT_GE(sent, (ssize_t)received);
+    EXPECT_LT(sent, (ssize_t)s.size());
+
+    // the error is reported by the next call
+    EXPECT_EQ(-EPIPE, (ssize_t)hce::io::sendfile(fds[0], f.fd(), sent, 1));
+
+    ::close(fds[0]);
+    ::unlink(path.c_str());
+}
+
+TEST(io, splice_peer_closed) {
+    test::io::ignore_sigpipe ignore;
+    const std::string path = test::io::temporary_path();
+    const size_t received = 1 << 14;
+    std::string s;
+
+    // larger than the pipe buffer, so the reader closes mid-transfer
+    for(size_t i = 0; i < (1 << 20); ++i) {
+        s.push_back((char)('a' + ((i * 7) % 26)));
+    }
+
+    hce::io::file f = hce::io::file::open(path, O_RDWR | O_TRUNC);
+    ASSERT_TRUE((bool)f);
+    ASSERT_EQ((ssize_t)s.size(), (ssize_t)f.write(s.data(), s.size(), 0));
+
+    int fds[2];
+    ASSERT_EQ(0, ::pipe2(fds, O_NONBLOCK));
+
+    auto lf = test::io::make_reactor_scheduler();
+    std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+
+    auto read_awt = sch->schedule(test::io::co_read_close(fds[0], received));
+    auto splice_awt = sch->schedule(
+        [](int in, int out, size_t count) -> hce::co<ssize_t> {
+            co_return co_await hce::io::splice(in, 0, out, -1, count);
+        }(f.fd(), fds[1], s.size()));
+
+    // the bytes moved before the reader closed are reported
+    ssize_t moved = std::move(splice_awt);
+    EXPECT_EQ(s.substr(0, received), (std::string)std::move(read_awt));
+    EXPECT_GE(moved, (ssize_t)received);
+    EXPECT_LT(moved, (ssize_t)s.size());
+
+    // the error is reported by the next call
+    EXPECT_EQ(-EPIPE, (ssize_t)hce::io::splice(f.fd(), moved, fds[1], -1, 1));
+
+    ::close(fds[1]);
+    ::unlink(path.c_str());
+}
+
+TEST(io, splice) {
+    const std::string path = test::io::temporary_path();
+    std::string s;
+
+    // larger than the pipe buffer, so the transfer suspends repeatedly
+    for(size_t i = 0; i < (1 << 20); ++i) {
+        s.push_back((char)('a' + ((i * 7) % 26)));
+    }
+
+    hce::io::file f = hce::io::file::open(path, O_RDWR | O_TRUNC);
+    ASSERT_TRUE((bool)f);
+    ASSERT_EQ((ssize_t)s.size(), (ssize_t)f.write(s.data(), s.size(), 0));
+
+    int fds[2];
+    ASSERT_EQ(0, ::pipe2(fds, O_NONBLOCK));
+
+    auto lf = test::io::make_reactor_scheduler();
+    std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+
+    // file to pipe, awaiting the writability of the pipe
+    {
+        auto read_awt = sch->schedule(
+            test::io::co_read_ready(fds[0], s.size()));
+        auto splice_awt = sch->schedule(
+            [](int in, int out, size_t count) -> hce::co<ssize_t> {
+                co_return co_await hce::io::splice(in, 0, out, -1, count);
+            }(f.fd(), fds[1], s.size()));
+
+        EXPECT_EQ((ssize_t)s.size(), (ssize_t)std::move(splice_awt));
+        EXPECT_EQ(s, (std::string)std::move(read_awt));
+    }
+
+    // pipe to file, awaiting the readability of the pipe until end of file
+    {
+        const std::string s2("hello splice");
+        auto splice_awt = sch->schedule(
+            [](int in, int out, size_t count) -> hce::co<ssize_t> {
+                co_return co_await hce::io::splice(in, -1, out, 0, count);
+            }(fds[0], f.fd(), s.size()));
+
+        ASSERT_EQ((ssize_t)s2.size(), ::write(fds[1], s2.data(), s2.size()));
+        ::close(fds[1]);
+        EXPECT_EQ((ssize_t)s2.size(), (ssize_t)std::move(splice_awt));
+
+        std::string buf(s2.size(), '\0');
+        ASSERT_EQ((ssize_t)s2.size(), 
+                  (ssize_t)f.read(buf.data(), buf.size(), 0));
+        EXPECT_EQ(s2, buf);
+    }
+
+    ::close(fds[0]);
+    ::unlink(path.c_str());
+}
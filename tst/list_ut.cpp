@@ -373,6 +373,49 @@ void concatenate_list_T() {
     }
 }
 
+template <typename T>
+void remove_list_T() {
+    hce::list<T> q;
+
+    for(size_t i=0; i<10; ++i) {
+        q.push_back((T)test::init<T>(i));
+    }
+
+    EXPECT_EQ(10, q.size());
+
+    // remove head, tail and middle elements
+    EXPECT_TRUE(q.remove((T)test::init<T>(0)));
+    EXPECT_EQ(9, q.size());
+    EXPECT_TRUE(q.remove((T)test::init<T>(9)));
+    EXPECT_EQ(8, q.size());
+    EXPECT_TRUE(q.remove((T)test::init<T>(5)));
+    EXPECT_EQ(7, q.size());
+
+    // elements which are not present cannot be removed
+    EXPECT_FALSE(q.remove((T)test::init<T>(5)));
+    EXPECT_FALSE(q.remove((T)test::init<T>(100)));
+    EXPECT_EQ(7, q.size());
+
+    // ensure the tail is still valid
+    q.push_back((T)test::init<T>(10));
+    EXPECT_EQ(8, q.size());
+
+    for(size_t i : { 1, 2, 3, 4, 6, 7, 8, 10 }) {
+        EXPECT_EQ((T)test::init<T>(i), q.front());
+        q.pop();
+    }
+
+    EXPECT_TRUE(q.empty());
+
+    // ensure the list is valid after removing the only element
+    q.push_back((T)test::init<T>(1));
+    EXPECT_TRUE(q.remove((T)test::init<T>(1)));
+    EXPECT_TRUE(q.empty());
+    q.push_back((T)test::init<T>(2));
+    EXPECT_EQ(1, q.size());
+    EXPECT_EQ((T)test::init<T>(2), q.front());
+}
+
 }
 
 TEST(queue, emplace_back_front_pop) {
@@ -440,3 +483,14 @@ TEST(queue, concatenate_queue) {
     test::concatenate_list_T<std::string>();
     test::concatenate_list_T<test::CustomObject>();
 }
+
+TEST(queue, remove) {
+    test::remove_list_T<int>();
+    test::remove_list_T<unsigned int>();
+    test::remove_list_T<size_t>();
+    test::remove_list_T<float>();
+    test::remove_list_T<double>();
+    test::remove_list_T<char>();
+    test::remove_list_T<std::string>();
+    test::remove_list_T<test::CustomObject>();
+}
@@ -8,8 +8,15 @@ int main(int argc, char** argv) {
     // Enable fail-fast
     GTEST_FLAG_SET(fail_fast, true);
 
+    hce::lifecycle::config config;
+
+#ifdef HCETIMERBACKEND
+    // test configurations can select a timer service backend 
+    config.tmr.backend = (hce::config::timer::backend)HCETIMERBACKEND;
+#endif
+
     // initialize and manage hce framework memory
-    auto lifecycle = hce::initialize();
+    auto lifecycle = hce::lifecycle::initialize(config);
 
     return RUN_ALL_TESTS();
 }
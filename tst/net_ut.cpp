@@ -0,0 +1,308 @@
+//SPDX-License-Identifier: Apache-2.0
+//Author: Blayne Dennis
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <cerrno>
+#include <string>
+#include <vector>
+#include <deque>
+
+#include "loguru.hpp"
+#include "scheduler.hpp"
+#include "threadpool.hpp"
+#include "blocking.hpp"
+#include "net.hpp"
+
+#include <gtest/gtest.h>
+#include "test_helpers.hpp"
+
+namespace test {
+namespace net {
+
+// make a scheduler with an epoll reactor
+inline std::unique_ptr<hce::scheduler::lifecycle> make_reactor_scheduler() {
+    hce::config::scheduler::config cfg;
+    cfg.reactor = true;
+    return hce::scheduler::make(cfg);
+}
+
+// a pattern of bytes which is unlikely to be duplicated by a bug
+inline std::string make_payload(size_t size) {
+    std::string s;
+    s.reserve(size);
+
+    for(size_t i = 0; i < size; ++i) {
+        s.push_back((char)('a' + ((i * 7) % 26)));
+    }
+
+    return s;
+}
+
+// read exactly count bytes
+hce::co<std::string> co_read_exactly(hce::net::stream* s, size_t count) {
+    std::string buf(count, '\0');
+    size_t received = 0;
+
+    while(received < count) {
+        ssize_t r = co_await s->read_some(buf.data() + received,
+                                          count - received);
+
+        if(r <= 0) { break; }
+
+        received += r;
+    }
+
+    buf.resize(received);
+    co_return buf;
+}
+
+// accept a single connection and echo it until end of stream
+hce::co<ssize_t> co_echo_server(hce::net::listener* l) {
+    hce::net::stream s = co_await l->accept();
+
+    if(!s) { co_return -s.error(); }
+
+    ssize_t total = 0;
+    char buf[4096];
+
+    while(true) {
+        ssize_t r = co_await s.read_some(buf, sizeof(buf));
+
+        if(r <= 0) { break; }
+
+        ssize_t w = co_await s.write_all(buf, r);
+
+        if(w != r) { co_return -1; }
+
+        total += r;
+    }
+
+    co_return total;
+}
+
+// connect, write a payload with writev, and read the echo
+hce::co<std::string> co_echo_client(hce::net::address a, std::string payload) {
+    hce::net::stream s = co_await hce::net::stream::connect(a);
+
+    if(!s) { co_return std::string(); }
+
+    // split the payload across buffers
+    const size_t half = payload.size() / 2;
+    iovec iov[2];
+    iov[0].iov_base = payload.data();
+    iov[0].iov_len = half;
+    iov[1].iov_base = payload.data() + half;
+    iov[1].iov_len = payload.size() - half;
+
+    // the echo must be read concurrently, otherwise large payloads fill both
+    // socket buffers and deadlock
+    auto read_awt = hce::schedule(co_read_exactly(&s, payload.size()));
+    ssize_t w = co_await s.writev(iov, 2);
+
+    if(w != (ssize_t)payload.size()) { co_return std::string(); }
+
+    std::string echo = co_await std::move(read_awt);
+    s.shutdown(SHUT_WR);
+    co_return echo;
+}
+
+}
+}
+
+TEST(net, address) {
+    hce::net::address a = hce::net::address::ip("127.0.0.1", 8080);
+    ASSERT_TRUE((bool)a);
+    EXPECT_EQ(AF_INET, a.family());
+    EXPECT_EQ(8080, a.port());
+    EXPECT_EQ(std::string("127.0.0.1:8080"), a.content());
+
+    a = hce::net::address::ip("::1", 443);
+    ASSERT_TRUE((bool)a);
+    EXPECT_EQ(AF_INET6, a.family());
+    EXPECT_EQ(443, a.port());
+    EXPECT_EQ(std::string("[::1]:443"), a.content());
+
+    a = hce::net::address::ip("not a host", 1);
+    EXPECT_FALSE((bool)a);
+    EXPECT_EQ(AF_UNSPEC, a.family());
+
+    a = hce::net::address::local("/tmp/hce_net_ut.sock");
+    ASSERT_TRUE((bool)a);
+    EXPECT_EQ(AF_UNIX, a.family());
+    EXPECT_EQ(0, a.port());
+    EXPECT_EQ(std::string("/tmp/hce_net_ut.sock"), a.content());
+
+    EXPECT_FALSE((bool)hce::net::address::local(std::string(4096, 'x')));
+}
+
+TEST(net, socketpair) {
+    auto lf = test::net::make_reactor_scheduler();
+    std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+
+    auto p = hce::net::stream::pair();
+    ASSERT_TRUE((bool)p.first);
+    ASSERT_TRUE((bool)p.second);
+
+    // larger than the socket buffers, so both sides suspend repeatedly
+    const std::string payload = test::net::make_payload(4 << 20);
+
+    auto read_awt = sch->schedule(
+        test::net::co_read_exactly(&(p.second), payload.size()));
+    auto write_awt = sch->schedule(
+        [](hce::net::stream* s, const std::string* payload) -> hce::co<ssize_t> {
+            co_return co_await s->write_all(payload->data(), payload->size());
+        }(&(p.first), &payload));
+
+    EXPECT_EQ((ssize_t)payload.size(), (ssize_t)std::move(write_awt));
+    EXPECT_EQ(payload, (std::string)std::move(read_awt));
+
+    // threads complete operations without a reactor
+    const std::string s("hello thread");
+    ssize_t w = p.second.write_all(s.data(), s.size());
+    EXPECT_EQ((ssize_t)s.size(), w);
+
+    std::string buf(s.size(), '\0');
+    iovec iov[2];
+    iov[0].iov_base = buf.data();
+    iov[0].iov_len = 5;
+    iov[1].iov_base = buf.data() + 5;
+    iov[1].iov_len = s.size() - 5;
+    ssize_t r = p.first.readv(iov, 2);
+    EXPECT_EQ((ssize_t)s.size(), r);
+    EXPECT_EQ(s, buf);
+
+    // end of stream
+    p.second.close();
+    r = p.first.read_some(buf.data(), buf.size());
+    EXPECT_EQ(0, r);
+}
+
+TEST(net, loopback_echo) {
+    auto lf = test::net::make_reactor_scheduler();
+    std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+
+    hce::net::listener l = hce::net::listener::bind(
+        hce::net::address::ip("127.0.0.1", 0));
+    ASSERT_TRUE((bool)l);
+
+    hce::net::address a = l.local_address();
+    ASSERT_EQ(AF_INET, a.family());
+    ASSERT_NE(0, a.port());
+
+    const std::string payload = test::net::make_payload(1 << 20);
+    auto server_awt = sch->schedule(test::net::co_echo_server(&l));
+    auto client_awt = sch->schedule(test::net::co_echo_client(a, payload));
+
+    EXPECT_EQ(payload, (std::string)std::move(client_awt));
+    EXPECT_EQ((ssize_t)payload.size(), (ssize_t)std::move(server_awt));
+}
+
+TEST(net, idle_connections) {
+    auto lf = test::net::make_reactor_scheduler();
+    std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+    const size_t count = 500;
+
+    std::vector<std::pair<hce::net::stream,hce::net::stream>> pairs;
+    std::deque<hce::awt<std::string>> awts;
+
+    for(size_t i = 0; i < count; ++i) {
+        pairs.push_back(hce::net::stream::pair());
+        ASSERT_TRUE((bool)pairs.back().first);
+    }
+
+    // every reader is suspended in the reactor at once, without a thread each
+    for(auto& p : pairs) {
+        awts.push_back(sch->schedule(test::net::co_read_exactly(&(p.first), 1)));
+    }
+
+    for(size_t i = 0; i < count; ++i) {
+        char c = (char)('a' + (i % 26));
+        ASSERT_EQ(1, ::write(pairs[i].second.fd(), &c, 1));
+    }
+
+    for(size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(std::string(1, (char)('a' + (i % 26))),
+                  (std::string)std::move(awts[i]));
+    }
+}
+
+TEST(net, threadpool_idle_connections) {
+    auto& service = hce::blocking::service::get();
+    const size_t worker_limit = 4;
+    const size_t count = worker_limit * 50;
+
+#ifdef __linux__
+    // the threadpool schedulers wait for work in a reactor by default
+    for(auto& sch : hce::threadpool::service::get().schedulers()) {
+        EXPECT_TRUE(sch->reactor());
+    }
+#endif
+
+    std::vector<std::pair<hce::net::stream,hce::net::stream>> pairs;
+    std::deque<hce::awt<std::string>> awts;
+
+    for(size_t i = 0; i < count; ++i) {
+        pairs.push_back(hce::net::stream::pair());
+        ASSERT_TRUE((bool)pairs.back().first);
+    }
+
+    // more idle readers than blocking workers cannot each hold a worker
+    service.set_worker_limit(worker_limit);
+
+    for(auto& p : pairs) {
+        awts.push_back(hce::threadpool::schedule(
+            test::net::co_read_exactly(&(p.first), 1)));
+    }
+
+    // blocking calls are not starved by the idle connections
+    auto block_awt = hce::threadpool::schedule([]() -> hce::co<int> {
+        co_return co_await hce::block([]{ return 1; });
+    }());
+
+    EXPECT_EQ(1, (int)std::move(block_awt));
+
+    for(size_t i = 0; i < count; ++i) {
+        char c = (char)('a' + (i % 26));
+        ASSERT_EQ(1, ::write(pairs[i].second.fd(), &c, 1));
+    }
+
+    for(size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(std::string(1, (char)('a' + (i % 26))),
+                  (std::string)std::move(awts[i]));
+    }
+
+    service.set_worker_limit(0);
+}
+
+TEST(net, errors) {
+    // an unused port
+    hce::net::address a;
+
+    {
+        hce::net::listener l = hce::net::listener::bind(
+            hce::net::address::ip("127.0.0.1", 0));
+        ASSERT_TRUE((bool)l);
+        a = l.local_address();
+    }
+
+    auto lf = test::net::make_reactor_scheduler();
+    std::shared_ptr<hce::scheduler> sch = lf->get_scheduler();
+
+    auto connect_awt = sch->schedule(
+        [](hce::net::address a) -> hce::co<int> {
+            hce::net::stream s = co_await hce::net::stream::connect(a);
+            co_return s ? 0 : s.error();
+        }(a));
+
+    EXPECT_EQ(ECONNREFUSED, (int)std::move(connect_awt));
+
+    // thread
+    hce::net::stream s = hce::net::stream::connect(hce::net::address());
+    EXPECT_FALSE((bool)s);
+    EXPECT_EQ(EINVAL, s.error());
+
+    hce::net::listener l = hce::net::listener::bind(hce::net::address());
+    EXPECT_FALSE((bool)l);
+    EXPECT_EQ(EINVAL, l.error());
+}
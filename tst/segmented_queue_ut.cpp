@@ -0,0 +1,168 @@
+//SPDX-License-Identifier: Apache-2.0
+//Author: Blayne Dennis
+#include <string>
+#include <memory>
+
+#include "segmented_queue.hpp"
+
+#include <gtest/gtest.h>
+#include "test_helpers.hpp"
+
+namespace test {
+namespace segmented_queue {
+
+template <typename T, size_t SEGMENT_SIZE>
+void push_pop_T() {
+    hce::segmented_queue<T,hce::pool_allocator<T>,SEGMENT_SIZE> q;
+    const size_t count = SEGMENT_SIZE * 10 + 1;
+
+    EXPECT_EQ(0, q.size());
+    EXPECT_TRUE(q.empty());
+
+    for(size_t i=0; i<count; ++i) {
+        if(i % 2) {
+            T t = test::init<T>(i);
+            q.push_back(t);
+        } else {
+            q.emplace_back((T)test::init<T>(i));
+        }
+    }
+
+    EXPECT_EQ(count, q.size());
+    EXPECT_FALSE(q.empty());
+
+    for(size_t i=0; i<count; ++i) {
+        EXPECT_EQ((T)test::init<T>(i), q.front());
+        q.pop();
+        EXPECT_EQ(count - (i+1), q.size());
+    }
+
+    EXPECT_EQ(0, q.size());
+    EXPECT_TRUE(q.empty());
+}
+
+// the queue repeatedly grows and shrinks across segment boundaries
+template <typename T, size_t SEGMENT_SIZE>
+void interleaved_push_pop_T() {
+    hce::segmented_queue<T,hce::pool_allocator<T>,SEGMENT_SIZE> q;
+    size_t pushed = 0;
+    size_t popped = 0;
+
+    for(size_t round=0; round<20; ++round) {
+        const size_t push_count = (round % 3) * SEGMENT_SIZE + round;
+
+        for(size_t i=0; i<push_count; ++i) {
+            q.push_back((T)test::init<T>(pushed));
+            ++pushed;
+        }
+
+        EXPECT_EQ(pushed - popped, q.size());
+
+        while(q.size() > round % 2) {
+            EXPECT_EQ((T)test::init<T>(popped), q.front());
+            q.pop();
+            ++popped;
+        }
+    }
+
+    while(!q.empty()) {
+        EXPECT_EQ((T)test::init<T>(popped), q.front());
+        q.pop();
+        ++popped;
+    }
+
+    EXPECT_EQ(pushed, popped);
+}
+
+template <typename T, size_t SEGMENT_SIZE>
+void copy_move_T() {
+    typedef hce::segmented_queue<T,hce::pool_allocator<T>,SEGMENT_SIZE> Q;
+    const size_t count = SEGMENT_SIZE * 3 + 2;
+    Q q;
+
+    for(size_t i=0; i<count; ++i) {
+        q.push_back((T)test::init<T>(i));
+    }
+
+    // pop part of the first segment so the copy starts mid-segment
+    q.pop();
+
+    Q copied(q);
+    Q assigned;
+    assigned.push_back((T)test::init<T>(0));
+    assigned = q;
+
+    EXPECT_EQ(count - 1, q.size());
+    EXPECT_EQ(count - 1, copied.size());
+    EXPECT_EQ(count - 1, assigned.size());
+
+    Q moved(std::move(q));
+    EXPECT_EQ(0, q.size());
+    EXPECT_TRUE(q.empty());
+    EXPECT_EQ(count - 1, moved.size());
+
+    Q move_assigned;
+    move_assigned = std::move(copied);
+    EXPECT_EQ(0, copied.size());
+    EXPECT_EQ(count - 1, move_assigned.size());
+
+    for(size_t i=1; i<count; ++i) {
+        EXPECT_EQ((T)test::init<T>(i), moved.front());
+        EXPECT_EQ((T)test::init<T>(i), assigned.front());
+        EXPECT_EQ((T)test::init<T>(i), move_assigned.front());
+        moved.pop();
+        assigned.pop();
+        move_assigned.pop();
+    }
+
+    EXPECT_TRUE(moved.empty());
+    EXPECT_TRUE(assigned.empty());
+    EXPECT_TRUE(move_assigned.empty());
+}
+
+}
+}
+
+TEST(segmented_queue, push_pop) {
+    test::segmented_queue::push_pop_T<int,1>();
+    test::segmented_queue::push_pop_T<int,4>();
+    test::segmented_queue::push_pop_T<int,128>();
+    test::segmented_queue::push_pop_T<size_t,4>();
+    test::segmented_queue::push_pop_T<double,4>();
+    test::segmented_queue::push_pop_T<char,4>();
+    test::segmented_queue::push_pop_T<std::string,4>();
+    test::segmented_queue::push_pop_T<std::string,128>();
+    test::segmented_queue::push_pop_T<test::CustomObject,4>();
+}
+
+TEST(segmented_queue, interleaved_push_pop) {
+    test::segmented_queue::interleaved_push_pop_T<int,1>();
+    test::segmented_queue::interleaved_push_pop_T<int,4>();
+    test::segmented_queue::interleaved_push_pop_T<int,128>();
+    test::segmented_queue::interleaved_push_pop_T<std::string,4>();
+    test::segmented_queue::interleaved_push_pop_T<test::CustomObject,4>();
+}
+
+TEST(segmented_queue, copy_move) {
+    test::segmented_queue::copy_move_T<int,4>();
+    test::segmented_queue::copy_move_T<int,128>();
+    test::segmented_queue::copy_move_T<std::string,4>();
+    test::segmented_queue::copy_move_T<test::CustomObject,4>();
+}
+
+TEST(segmented_queue, destruct_values) {
+    auto p = std::make_shared<int>(0);
+
+    {
+        hce::segmented_queue<std::shared_ptr<int>,
+                             hce::pool_allocator<std::shared_ptr<int>>,
+                             4> q;
+
+        for(size_t i=0; i<10; ++i) { q.push_back(p); }
+
+        q.pop();
+        EXPECT_EQ(10, p.use_count());
+    }
+
+    EXPECT_EQ(1, p.use_count());
+}
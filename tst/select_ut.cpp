@@ -0,0 +1,416 @@
+//SPDX-License-Identifier: Apache-2.0
+//Author: Blayne Dennis
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+#include "loguru.hpp"
+#include "logging.hpp"
+#include "coroutine.hpp"
+#include "scheduler.hpp"
+#include "threadpool.hpp"
+#include "channel.hpp"
+#include "select.hpp"
+
+#include <gtest/gtest.h>
+#include "test_helpers.hpp"
+
+namespace test {
+namespace select {
+
+// every channel implementation
+enum kind {
+    unbuffered,
+    buffered,
+    unlimited,
+    spsc,
+    mpmc,
+    kind_count
+};
+
+template <typename T>
+hce::chan<T> make(int k) {
+    switch(k) {
+        case buffered: return hce::chan<T>::make(2);
+        case unlimited: return hce::chan<T>::make(-1);
+        case spsc: return hce::chan<T>::template make<hce::channel::spsc>(2);
+        case mpmc: return hce::chan<T>::template make<hce::channel::mpmc>(2);
+        default: return hce::chan<T>::make(0);
+    }
+}
+
+template <typename T>
+hce::co<void> co_send(hce::chan<T> ch, T t) {
+    co_await ch.send(std::move(t));
+}
+
+template <typename T>
+hce::co<size_t> co_send_count(hce::chan<T> ch, size_t first, size_t count) {
+    size_t sent = 0;
+
+    for(size_t i = first; i < first + count; ++i) {
+        if(co_await ch.send((T)test::init<T>(i))) { ++sent; }
+    }
+
+    co_return sent;
+}
+
+template <typename T>
+hce::co<T> co_recv(hce::chan<T> ch) {
+    T t;
+    co_await ch.recv(t);
+    co_return t;
+}
+
+// receive count values from either channel with selects
+template <typename T>
+hce::co<std::vector<T>> co_select_recv(hce::chan<T> ch1, hce::chan<T> ch2, size_t count) {
+    std::vector<T> received;
+
+    while(received.size() < count) {
+        T t1;
+        T t2;
+        hce::select s;
+        const size_t c1 = s.recv(ch1, t1);
+        const size_t c2 = s.recv(ch2, t2);
+        const size_t completed = co_await s.await();
+
+        if(!s.success()) { break; }
+        else if(completed == c1) { received.push_back(std::move(t1)); }
+        else if(completed == c2) { received.push_back(std::move(t2)); }
+        else { break; }
+    }
+
+    co_return received;
+}
+
+// send values first..first+count to either channel with selects
+template <typename T>
+hce::co<size_t> co_select_send(hce::chan<T> ch1, hce::chan<T> ch2, size_t first, size_t count) {
+    size_t sent = 0;
+
+    for(size_t i = first; i < first + count; ++i) {
+        hce::select s;
+        s.send(ch1, (T)test::init<T>(i));
+        s.send(ch2, (T)test::init<T>(i));
+        co_await s.await();
+
+        if(!s.success()) { break; }
+        ++sent;
+    }
+
+    co_return sent;
+}
+
+template <typename T>
+size_t recv_T() {
+    std::string fname = hce::type::templatize<T>("recv_T");
+    size_t success_count = 0;
+
+    for(int k = 0; k < kind_count; ++k) {
+        HCE_INFO_FUNCTION_BODY(fname, "kind ", k);
+
+        // the second channel has a value
+        {
+            auto ch1 = make<T>(k);
+            auto ch2 = make<T>(k);
+            auto awt = hce::schedule(co_send(ch2, (T)test::init<T>(3)));
+
+            T t1;
+            T t2;
+            hce::select s;
+            EXPECT_EQ(0, s.recv(ch1, t1));
+            EXPECT_EQ(1, s.recv(ch2, t2));
+            EXPECT_EQ(1, (size_t)s.await());
+            EXPECT_TRUE(s.success());
+            EXPECT_EQ((T)test::init<T>(3), t2);
+            awt.wait();
+
+            // nothing remains parked on the channel which did not complete
+            EXPECT_EQ(hce::channel::result::failure,
+                      (hce::channel::result)ch1.try_recv(t1));
+        }
+
+        // the value arrives after the select suspends
+        {
+            auto ch1 = make<T>(k);
+            auto ch2 = make<T>(k);
+
+            std::thread thd([&]{
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                ch1.send((T)test::init<T>(4));
+            });
+
+            T t1;
+            T t2;
+            hce::select s;
+            s.recv(ch1, t1);
+            s.recv(ch2, t2);
+            EXPECT_EQ(0, (size_t)s.await());
+            EXPECT_TRUE(s.success());
+            EXPECT_EQ((T)test::init<T>(4), t1);
+            thd.join();
+        }
+
+        // a closed channel completes unsuccessfully
+        {
+            auto ch1 = make<T>(k);
+            auto ch2 = make<T>(k);
+            ch2.close();
+
+            T t1;
+            T t2;
+            hce::select s;
+            s.recv(ch1, t1);
+            s.recv(ch2, t2);
+            EXPECT_EQ(1, (size_t)s.await());
+            EXPECT_FALSE(s.success());
+        }
+
+        ++success_count;
+    }
+
+    return success_count;
+}
+
+template <typename T>
+size_t send_T() {
+    std::string fname = hce::type::templatize<T>("send_T");
+    size_t success_count = 0;
+
+    for(int k = 0; k < kind_count; ++k) {
+        HCE_INFO_FUNCTION_BODY(fname, "kind ", k);
+
+        // the second channel has a receiver
+        {
+            auto ch1 = make<T>(k);
+            auto ch2 = make<T>(k);
+
+            // fill the first channel, if it can be filled
+            if(k == buffered || k == spsc || k == mpmc) {
+                while(hce::channel::result::success == 
+                      (hce::channel::result)ch1.try_send((T)test::init<T>(0))) { }
+            }
+
+            auto awt = hce::schedule(co_recv(ch2));
+            T t(test::init<T>(5));
+
+            hce::select s;
+            const size_t c1 = s.send(ch1, (T)test::init<T>(6));
+            const size_t c2 = s.send(ch2, t);
+            const size_t completed = s.await();
+            EXPECT_TRUE(s.success());
+
+            if(k == unlimited) {
+                // unlimited sends never block
+                EXPECT_EQ(c1, completed);
+                EXPECT_TRUE((bool)ch2.send((T)test::init<T>(5)));
+            } else {
+                EXPECT_EQ(c2, completed);
+            }
+
+            EXPECT_EQ((T)test::init<T>(5), (T)std::move(awt));
+        }
+
+        // a closed channel completes unsuccessfully
+        {
+            auto ch = make<T>(k);
+            ch.close();
+
+            hce::select s;
+            EXPECT_EQ(0, s.send(ch, (T)test::init<T>(7)));
+            EXPECT_EQ(0, (size_t)s.await());
+            EXPECT_FALSE(s.success());
+        }
+
+        ++success_count;
+    }
+
+    return success_count;
+}
+
+template <typename T>
+size_t timeout_otherwise_T() {
+    std::string fname = hce::type::templatize<T>("timeout_otherwise_T");
+    size_t success_count = 0;
+
+    for(int k = 0; k < kind_count; ++k) {
+        HCE_INFO_FUNCTION_BODY(fname, "kind ", k);
+
+        // nothing completes before the timeout
+        {
+            auto ch1 = make<T>(k);
+            auto ch2 = make<T>(k);
+
+            T t1;
+            T t2;
+            hce::select s;
+            s.recv(ch1, t1);
+            s.recv(ch2, t2);
+            const size_t timeout = s.timeout(std::chrono::milliseconds(10));
+            EXPECT_EQ(2, timeout);
+            EXPECT_EQ(timeout, (size_t)s.await());
+            EXPECT_FALSE(s.success());
+
+            // the receives were cancelled, so a send must not find them
+            if(k == unbuffered) {
+                EXPECT_EQ(hce::channel::result::failure,
+                          (hce::channel::result)ch1.try_send((T)test::init<T>(0)));
+            } else {
+                EXPECT_EQ(hce::channel::result::success,
+                          (hce::channel::result)ch1.try_send((T)test::init<T>(0)));
+                EXPECT_EQ(1, ch1.used());
+            }
+        }
+
+        // a case completes before the timeout
+        {
+            auto ch = make<T>(k);
+            auto awt = hce::schedule(co_send(ch, (T)test::init<T>(8)));
+
+            T t;
+            hce::select s;
+            s.recv(ch, t);
+            s.timeout(std::chrono::seconds(10));
+            EXPECT_EQ(0, (size_t)s.await());
+            EXPECT_TRUE(s.success());
+            EXPECT_EQ((T)test::init<T>(8), t);
+            awt.wait();
+        }
+
+        // nothing can complete immediately
+        {
+            auto ch = make<T>(k);
+
+            T t;
+            hce::select s;
+            s.recv(ch, t);
+            const size_t otherwise = s.otherwise();
+            EXPECT_EQ(1, otherwise);
+            EXPECT_EQ(otherwise, s.otherwise());
+            EXPECT_EQ(otherwise, (size_t)s.await());
+            EXPECT_FALSE(s.success());
+        }
+
+        // a case can complete immediately
+        {
+            auto ch = make<T>(k);
+            auto awt = hce::schedule(co_send(ch, (T)test::init<T>(9)));
+
+            // wait for the sender to complete or park
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+            T t;
+            hce::select s;
+            s.otherwise();
+            s.recv(ch, t);
+            EXPECT_EQ(1, (size_t)s.await());
+            EXPECT_TRUE(s.success());
+            EXPECT_EQ((T)test::init<T>(9), t);
+            awt.wait();
+        }
+
+        ++success_count;
+    }
+
+    return success_count;
+}
+
+template <typename T>
+size_t exactly_one_T() {
+    std::string fname = hce::type::templatize<T>("exactly_one_T");
+    size_t success_count = 0;
+    const size_t count = 200;
+
+    for(int k = 0; k < kind_count; ++k) {
+        HCE_INFO_FUNCTION_BODY(fname, "kind ", k);
+
+        // each channel has a single producer, so spsc channels are valid, and 
+        // the coroutines are spread across the threadpool to race the cases
+        {
+            auto ch1 = make<T>(k);
+            auto ch2 = make<T>(k);
+            auto recv_awt = hce::threadpool::schedule(co_select_recv(ch1, ch2, 2 * count));
+            auto send1_awt = hce::threadpool::schedule(co_send_count(ch1, 0, count));
+            auto send2_awt = hce::threadpool::schedule(co_send_count(ch2, count, count));
+
+            EXPECT_EQ(count, (size_t)std::move(send1_awt));
+            EXPECT_EQ(count, (size_t)std::move(send2_awt));
+
+            std::vector<T> received = std::move(recv_awt);
+            EXPECT_EQ(2 * count, received.size());
+
+            // values from each channel arrive in order
+            size_t next1 = 0;
+            size_t next2 = count;
+
+            for(auto& t : received) {
+                if(next1 < count && (T)test::init<T>(next1) == t) { ++next1; }
+                else if(next2 < 2 * count && (T)test::init<T>(next2) == t) { ++next2; }
+                else { ADD_FAILURE() << "unexpected value"; break; }
+            }
+
+            EXPECT_EQ(count, next1);
+            EXPECT_EQ(2 * count, next2);
+        }
+
+        // selects on both sides of the channels
+        if(k != unlimited) {
+            auto ch1 = make<T>(k);
+            auto ch2 = make<T>(k);
+            auto recv_awt = hce::threadpool::schedule(co_select_recv(ch1, ch2, count));
+            auto send_awt = hce::threadpool::schedule(co_select_send(ch1, ch2, 0, count));
+
+            EXPECT_EQ(count, (size_t)std::move(send_awt));
+            std::vector<T> received = std::move(recv_awt);
+            EXPECT_EQ(count, received.size());
+
+            // the channels are raced, so values can arrive out of order
+            for(size_t i = 0; i < count; ++i) {
+                auto it = std::find(
+                    received.begin(), 
+                    received.end(), 
+                    (T)test::init<T>(i));
+                EXPECT_NE(received.end(), it);
+                if(it != received.end()) { received.erase(it); }
+            }
+        }
+
+        ++success_count;
+    }
+
+    return success_count;
+}
+
+}
+}
+
+TEST(select, recv) {
+    const size_t expected = test::select::kind_count;
+    ASSERT_EQ(expected, test::select::recv_T<int>());
+    ASSERT_EQ(expected, test::select::recv_T<std::string>());
+    ASSERT_EQ(expected, test::select::recv_T<test::CustomObject>());
+}
+
+TEST(select, send) {
+    const size_t expected = test::select::kind_count;
+    ASSERT_EQ(expected, test::select::send_T<int>());
+    ASSERT_EQ(expected, test::select::send_T<std::string>());
+    ASSERT_EQ(expected, test::select::send_T<test::CustomObject>());
+}
+
+TEST(select, timeout_otherwise) {
+    const size_t expected = test::select::kind_count;
+    ASSERT_EQ(expected, test::select::timeout_otherwise_T<int>());
+    ASSERT_EQ(expected, test::select::timeout_otherwise_T<std::string>());
+    ASSERT_EQ(expected, test::select::timeout_otherwise_T<test::CustomObject>());
+}
+
+TEST(select, exactly_one) {
+    const size_t expected = test::select::kind_count;
+    ASSERT_EQ(expected, test::select::exactly_one_T<int>());
+    ASSERT_EQ(expected, test::select::exactly_one_T<std::string>());
+    ASSERT_EQ(expected, test::select::exactly_one_T<test::CustomObject>());
+}
@@ -0,0 +1,215 @@
+//SPDX-License-Identifier: Apache-2.0
+//Author: Blayne Dennis
+#include <string>
+#include <vector>
+#include <set>
+#include <thread>
+#include <chrono>
+
+#include "loguru.hpp"
+#include "logging.hpp"
+#include "coroutine.hpp"
+#include "scheduler.hpp"
+#include "slot_chan.hpp"
+
+#include <gtest/gtest.h>
+#include "test_helpers.hpp"
+
+namespace test {
+namespace slot_chan {
+
+template <typename T>
+hce::co<size_t> co_produce(hce::slot_chan<T> ch, size_t count) {
+    size_t committed = 0;
+    typename hce::slot_chan<T>::reserved r;
+
+    for(size_t i = 0; i < count; ++i) {
+        if(!co_await ch.reserve(r)) { break; }
+        *r = (T)test::init<T>(i);
+        if(r.commit()) { ++committed; }
+    }
+
+    ch.close();
+    co_return committed;
+}
+
+template <typename T>
+hce::co<size_t> co_consume(hce::slot_chan<T> ch, std::set<T*>* slots) {
+    size_t borrowed = 0;
+    typename hce::slot_chan<T>::borrowed b;
+
+    while(co_await ch.borrow(b)) {
+        if((T)test::init<T>(borrowed) != *b) { break; }
+        slots->insert(&(*b));
+        b.release();
+        ++borrowed;
+    }
+
+    co_return borrowed;
+}
+
+// values are transferred in place through a fixed set of slots
+template <typename T>
+void produce_consume_T() {
+    const size_t count = 1000;
+    const size_t size = 4;
+    std::set<T*> slots;
+
+    // between coroutines
+    {
+        auto ch = hce::slot_chan<T>::make(size);
+        EXPECT_EQ(size, ch.size());
+        auto consume_awt = hce::schedule(co_consume<T>(ch, &slots));
+        auto produce_awt = hce::schedule(co_produce<T>(ch, count));
+        EXPECT_EQ(count, (size_t)std::move(produce_awt));
+        EXPECT_EQ(count, (size_t)std::move(consume_awt));
+        EXPECT_GE(size, slots.size());
+    }
+
+    // between a coroutine and a thread
+    {
+        auto ch = hce::slot_chan<T>::make(size);
+        auto produce_awt = hce::schedule(co_produce<T>(ch, count));
+        typename hce::slot_chan<T>::borrowed b;
+        size_t borrowed = 0;
+
+        while(ch.borrow(b)) {
+            EXPECT_EQ((T)test::init<T>(borrowed), *b);
+            ++borrowed;
+        }
+
+        EXPECT_EQ(count, (size_t)std::move(produce_awt));
+        EXPECT_EQ(count, borrowed);
+    }
+}
+
+}
+}
+
+TEST(slot_chan, produce_consume) {
+    test::slot_chan::produce_consume_T<int>();
+    test::slot_chan::produce_consume_T<size_t>();
+    test::slot_chan::produce_consume_T<double>();
+    test::slot_chan::produce_consume_T<std::string>();
+    test::slot_chan::produce_consume_T<test::CustomObject>();
+}
+
+TEST(slot_chan, throttle) {
+    auto ch = hce::slot_chan<int>::make(2);
+    hce::slot_chan<int>::reserved r1;
+    hce::slot_chan<int>::reserved r2;
+
+    EXPECT_TRUE((bool)ch.reserve(r1));
+    EXPECT_TRUE((bool)ch.reserve(r2));
+
+    // every slot is reserved, so reserving waits for one to be freed
+    auto reserve_awt = hce::schedule([](hce::slot_chan<int> ch) -> hce::co<bool> {
+        hce::slot_chan<int>::reserved r;
+
+        if(co_await ch.reserve(r)) {
+            *r = 3;
+            co_return r.commit();
+        } else {
+            co_return false;
+        }
+    }(ch));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    *r1 = 1;
+    EXPECT_TRUE(r1.commit());
+    EXPECT_FALSE((bool)r1);
+    EXPECT_EQ(1, ch.used());
+
+    // releasing a borrowed slot frees it for the waiting reservation
+    hce::slot_chan<int>::borrowed b;
+    EXPECT_TRUE((bool)ch.borrow(b));
+    EXPECT_EQ(1, *b);
+    b.release();
+    EXPECT_TRUE((bool)std::move(reserve_awt));
+    EXPECT_EQ(1, ch.used());
+
+    EXPECT_TRUE((bool)ch.borrow(b));
+    EXPECT_EQ(3, *b);
+    EXPECT_EQ(0, ch.used());
+
+    // an uncommitted reservation frees its slot when destroyed, and a borrow
+    // releases its previous slot
+    r2 = hce::slot_chan<int>::reserved();
+    EXPECT_TRUE((bool)ch.reserve(r1));
+    EXPECT_TRUE(r1.commit());
+    EXPECT_TRUE((bool)ch.borrow(b));
+    EXPECT_TRUE((bool)ch.reserve(r1));
+    b.release();
+    EXPECT_TRUE((bool)ch.reserve(r2));
+}
+
+TEST(slot_chan, close) {
+    auto ch = hce::slot_chan<int>::make(4);
+    hce::slot_chan<int>::reserved r;
+    hce::slot_chan<int>::borrowed b;
+
+    EXPECT_TRUE((bool)ch.reserve(r));
+    *r = 1;
+    EXPECT_TRUE(r.commit());
+    EXPECT_TRUE((bool)ch.reserve(r));
+
+    auto borrow_awt = hce::schedule([](hce::slot_chan<int> ch) -> hce::co<int> {
+        hce::slot_chan<int>::borrowed b;
+        int sum = 0;
+
+        while(co_await ch.borrow(b)) { sum += *b; }
+
+        co_return sum;
+    }(ch));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ch.close();
+    EXPECT_TRUE(ch.closed());
+
+    // a parked borrow fails once every committed slot is borrowed
+    EXPECT_EQ(1, (int)std::move(borrow_awt));
+
+    // a reservation cannot be committed after the channel is closed
+    *r = 2;
+    EXPECT_FALSE(r.commit());
+    EXPECT_FALSE((bool)ch.reserve(r));
+    EXPECT_FALSE((bool)ch.borrow(b));
+}
+
+TEST(slot_chan, commit_without_slot) {
+    auto ch = hce::slot_chan<int>::make(1);
+    hce::slot_chan<int>::reserved r;
+    hce::slot_chan<int>::borrowed b;
+
+    // nothing has been reserved
+    EXPECT_FALSE(r.commit());
+
+    // a slot can only be committed once
+    EXPECT_TRUE((bool)ch.reserve(r));
+    *r = 1;
+    EXPECT_TRUE(r.commit());
+    EXPECT_FALSE(r.commit());
+    EXPECT_EQ(1, ch.used());
+
+    EXPECT_TRUE((bool)ch.borrow(b));
+    EXPECT_EQ(1, *b);
+    b.release();
+
+    // the second commit did not queue an empty slot
+    EXPECT_EQ(0, ch.used());
+    EXPECT_TRUE((bool)ch.reserve(r));
+    *r = 2;
+    EXPECT_TRUE(r.commit());
+    EXPECT_TRUE((bool)ch.borrow(b));
+    EXPECT_EQ(2, *b);
+    b.release();
+
+    // every slot is free once the channel is closed, so a failed reservation 
+    // has nothing to commit
+    EXPECT_TRUE((bool)ch.reserve(r));
+    ch.close();
+    EXPECT_FALSE(r.commit());
+    EXPECT_FALSE((bool)ch.reserve(r));
+    EXPECT_FALSE(r.commit());
+    EXPECT_FALSE((bool)r);
+}
@@ -72,11 +72,11 @@ void validate_test(std::optional<double> check_sleep,
 
     if(check_busywait) {
         hce::timer::service::ticks ticks = hce::timer::service::get().get_ticks();
-        double busy_wait_rate = ((double)(ticks.busywait)/(ticks.runtime)) * 100;
+        double busy_wait_rate = ticks.busy_ratio() * 100;
         std::cout 
             << "timer service busy-wait microsecond threshold: " 
             << std::chrono::duration_cast<std::chrono::microseconds>(
-                hce::config::timer::busy_wait_threshold()).count()
+                hce::timer::service::get().get_thresholds().busy_wait).count()
             << std::endl;
         std::cout << "timer service busy-wait runtime rate: " <<  busy_wait_rate << "%" << std::endl;
         EXPECT_LT(busy_wait_rate, *check_busywait);
@@ -1093,3 +1093,130 @@ TEST_F(timer, cancel) {
 
     test::timer::validate_test({},{98.0},{1.0});
 }
+
+TEST_F(timer, adaptive_thresholds) {
+    auto& service = hce::timer::service::get();
+
+    // other tests have already tuned the thresholds
+    service.reset_thresholds();
+    const auto initial = service.get_thresholds();
+
+    EXPECT_EQ(hce::config::timer::busy_wait_threshold(), initial.busy_wait);
+    EXPECT_EQ(hce::config::timer::early_wakeup_threshold(), 
+              initial.early_wakeup);
+
+    /*
+     Sleeps longer than the early wakeup threshold end in a timed wait, and 
+     each timed wait samples the service thread's wakeup overshoot. That 
+     overshoot is far smaller than the initial busy-wait threshold, so 
+     tuning has to shrink both thresholds. A loaded machine occasionally 
+     oversleeps by more than that, so keep sampling until the smoothed 
+     estimates settle below the initial values.
+     */
+    auto thresholds = initial;
+
+    for(unsigned int i=0; i<100; ++i) {
+        hce::sleep(initial.early_wakeup + std::chrono::milliseconds(10));
+        thresholds = service.get_thresholds();
+
+        if(i >= 8 && 
+           thresholds.busy_wait < initial.busy_wait && 
+           thresholds.early_wakeup < initial.early_wakeup &&
+           thresholds.overshoot_deviation < initial.overshoot_deviation) 
+        {
+            break;
+        }
+    }
+
+    auto ticks = service.get_ticks();
+
+    std::cout << "timer service busy-wait microsecond threshold: " 
+              << hce::chrono::to<std::chrono::microseconds>(
+                  initial.busy_wait).count() 
+              << " -> "
+              << hce::chrono::to<std::chrono::microseconds>(
+                  thresholds.busy_wait).count() 
+              << std::endl;
+    std::cout << "timer service early wakeup microsecond threshold: " 
+              << hce::chrono::to<std::chrono::microseconds>(
+                  initial.early_wakeup).count() 
+              << " -> "
+              << hce::chrono::to<std::chrono::microseconds>(
+                  thresholds.early_wakeup).count() 
+              << std::endl;
+    std::cout << "timer service microsecond overshoot: " 
+              << hce::chrono::to<std::chrono::microseconds>(
+                  thresholds.overshoot).count() 
+              << " +/- "
+              << hce::chrono::to<std::chrono::microseconds>(
+                  thresholds.overshoot_deviation).count() 
+              << std::endl;
+    std::cout << "timer service busy-wait ratio: " << ticks.busy_ratio() 
+              << std::endl;
+
+    if(hce::config::timer::adaptive()) {
+        EXPECT_LT(thresholds.busy_wait, initial.busy_wait);
+        EXPECT_LT(thresholds.early_wakeup, initial.early_wakeup);
+        EXPECT_GT(thresholds.overshoot, hce::chrono::duration(0));
+        EXPECT_LT(thresholds.overshoot_deviation, 
+                  initial.overshoot_deviation);
+        EXPECT_GE(thresholds.busy_wait, 
+                  hce::config::timer::busy_wait_threshold_minimum());
+        EXPECT_LE(thresholds.busy_wait, 
+                  hce::config::timer::busy_wait_threshold_maximum());
+    } else {
+        EXPECT_EQ(initial.busy_wait, thresholds.busy_wait);
+        EXPECT_EQ(initial.early_wakeup, thresholds.early_wakeup);
+    }
+
+    EXPECT_GE(thresholds.early_wakeup, thresholds.busy_wait);
+    EXPECT_GE(ticks.busy_ratio(), 0.0);
+    EXPECT_LE(ticks.busy_ratio(), 1.0);
+
+    // the thresholds return to their initial values when reset
+    service.reset_thresholds();
+    thresholds = service.get_thresholds();
+    EXPECT_EQ(initial.busy_wait, thresholds.busy_wait);
+    EXPECT_EQ(initial.early_wakeup, thresholds.early_wakeup);
+    EXPECT_EQ(initial.overshoot, thresholds.overshoot);
+    EXPECT_EQ(initial.overshoot_deviation, thresholds.overshoot_deviation);
+}
+
+TEST_F(timer, backend) {
+    auto& service = hce::timer::service::get();
+
+#ifdef HCETIMERBACKEND
+    // the test configuration selected the backend
+    EXPECT_EQ((hce::config::timer::backend)HCETIMERBACKEND, 
+              hce::config::timer::service_backend());
+#endif
+
+#ifdef __linux__
+    EXPECT_EQ(hce::config::timer::service_backend(), service.backend());
+#else 
+    EXPECT_EQ(hce::config::timer::backend::condition_variable, 
+              service.backend());
+#endif
+
+    // timers work regardless of the backend
+    hce::sid sid;
+
+    for(size_t i = 1; i <= 10; ++i) {
+        auto start = hce::chrono::now();
+        EXPECT_TRUE((bool)hce::timer::start(sid, std::chrono::milliseconds(i)));
+        EXPECT_GE(hce::chrono::now() - start, std::chrono::milliseconds(i));
+    }
+
+    if(service.backend() == hce::config::timer::backend::timerfd) {
+        // the service thread sleeps in the kernel until each timeout instead 
+        // of busy-waiting
+        auto ticks = service.get_ticks();
+        EXPECT_GT(ticks.runtime, 0u);
+        EXPECT_EQ(0u, ticks.busywait);
+    }
+
+    // a cancelled timer wakes the service thread without timing out
+    auto awt = hce::timer::start(sid, std::chrono::hours(1));
+    EXPECT_TRUE(hce::timer::cancel(sid));
+    EXPECT_FALSE((bool)awt);
+}
@@ -0,0 +1,258 @@
+//SPDX-License-Identifier: MIT
+//Author: Blayne Dennis
+/*
+ Timer service benchmark harness.
+
+ Measures:
+ - `hce::sleep()` wakeup lateness distribution under concurrent load
+ - the timer service's busy-wait cost during the lateness measurement
+ - handler timer start/cancel throughput with many outstanding timers
+
+ Results are written to stdout as JSON so runs with different timer backends
+ and threshold settings (see `hce::config::timer`) can be compared.
+
+ usage: hce_bench_timer [--quick]
+
+ `--quick` reduces iteration counts and the largest outstanding timer count
+ for fast smoke runs.
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <ctime>
+
+#include "hce.hpp"
+
+namespace bench {
+
+struct settings {
+    size_t sleepers; // concurrent sleeping coroutines
+    size_t sleeps; // sleeps per coroutine
+    std::vector<size_t> outstanding; // outstanding timer counts to measure
+    size_t pairs; // start/cancel pairs per thread per measurement
+    size_t threads; // threads performing start/cancel pairs
+};
+
+// return nanoseconds as a double
+inline double nano(const hce::chrono::duration& d) {
+    return (double)hce::chrono::to<std::chrono::nanoseconds>(d).count();
+}
+
+// return the seconds of process cpu time consumed so far
+inline double cpu_seconds() {
+    return (double)std::clock() / (double)CLOCKS_PER_SEC;
+}
+
+// return the value at percentile p (0.0 to 1.0) in sorted samples
+inline double percentile(const std::vector<double>& sorted, double p) {
+    if(sorted.empty()) { return 0.0; }
+    size_t i = (size_t)(p * (double)(sorted.size() - 1) + 0.5);
+    return sorted[std::min(i, sorted.size() - 1)];
+}
+
+hce::co<void> co_sleeper(size_t offset,
+                         size_t sleeps,
+                         std::vector<double>* lateness) {
+    // a spread of durations which straddle the busy-wait thresholds
+    static const std::chrono::microseconds durations[] = {
+        std::chrono::microseconds(100),
+        std::chrono::microseconds(500),
+        std::chrono::microseconds(1000),
+        std::chrono::microseconds(5000),
+        std::chrono::microseconds(10000)
+    };
+
+    const size_t count = sizeof(durations) / sizeof(durations[0]);
+
+    for(size_t i = 0; i < sleeps; ++i) {
+        auto target = hce::chrono::now() + durations[(offset + i) % count];
+        co_await hce::sleep(target);
+        lateness->push_back(nano(hce::chrono::now() - target));
+    }
+
+    co_return;
+}
+
+std::string sleep_lateness(const settings& s) {
+    std::vector<std::vector<double>> results(s.sleepers);
+    std::vector<hce::awt<void>> awts;
+    awts.reserve(s.sleepers);
+
+    for(auto& r : results) { r.reserve(s.sleeps); }
+
+    auto& ts = hce::timer::service::get();
+    ts.reset_ticks();
+    const double cpu_start = cpu_seconds();
+    const auto start = hce::chrono::now();
+
+    for(size_t i = 0; i < s.sleepers; ++i) {
+        awts.push_back(hce::threadpool::schedule(
+            co_sleeper(i, s.sleeps, &(results[i]))));
+    }
+
+    // join all the sleepers
+    awts.clear();
+
+    const auto wall = hce::chrono::now() - start;
+    const double cpu = cpu_seconds() - cpu_start;
+    const auto ticks = ts.get_ticks();
+    const auto thresholds = ts.get_thresholds();
+
+    std::vector<double> samples;
+
+    for(auto& r : results) {
+        samples.insert(samples.end(), r.begin(), r.end());
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    const double mean = samples.empty()
+        ? 0.0
+        : std::accumulate(samples.begin(), samples.end(), 0.0) /
+          (double)samples.size();
+
+    std::stringstream ss;
+    ss << "{"
+       << "\"sleepers\":" << s.sleepers << ","
+       << "\"samples\":" << samples.size() << ","
+       << "\"lateness_ns\":{"
+       << "\"min\":" << (samples.empty() ? 0.0 : samples.front()) << ","
+       << "\"mean\":" << mean << ","
+       << "\"p50\":" << percentile(samples, 0.5) << ","
+       << "\"p99\":" << percentile(samples, 0.99) << ","
+       << "\"p999\":" << percentile(samples, 0.999) << ","
+       << "\"max\":" << (samples.empty() ? 0.0 : samples.back()) << "},"
+       << "\"busy_wait\":{"
+       << "\"runtime_us\":" << ticks.runtime << ","
+       << "\"busy_wait_us\":" << ticks.busywait << ","
+       << "\"busy_ratio\":" << ticks.busy_ratio() << ","
+       << "\"busy_wait_us_per_sleep\":"
+       << (samples.empty()
+           ? 0.0
+           : (double)ticks.busywait / (double)samples.size()) << ","
+       << "\"process_cpu_s\":" << cpu << ","
+       << "\"wall_s\":" << nano(wall) / 1e9 << "},"
+       << "\"thresholds_ns\":{"
+       << "\"busy_wait\":" << nano(thresholds.busy_wait) << ","
+       << "\"early_wakeup\":" << nano(thresholds.early_wakeup) << ","
+       << "\"overshoot\":" << nano(thresholds.overshoot) << ","
+       << "\"overshoot_deviation\":"
+       << nano(thresholds.overshoot_deviation) << "}"
+       << "}";
+    return ss.str();
+}
+
+// handler for benchmark timers, which never time out
+void noop_handler(void*, bool) { }
+
+std::string start_cancel_throughput(const settings& s, size_t outstanding) {
+    auto& ts = hce::timer::service::get();
+
+    // far enough in the future that no timer times out during the measurement
+    const auto timeout = hce::chrono::now() + std::chrono::hours(1);
+    std::vector<hce::sid> sids(outstanding);
+
+    // fill the service to the outstanding count
+    auto start = hce::chrono::now();
+
+    for(auto& sid : sids) {
+        ts.start(sid, timeout, &noop_handler, nullptr);
+    }
+
+    const double fill = nano(hce::chrono::now() - start);
+
+    // concurrently start and cancel timers on top of the outstanding timers
+    std::vector<std::thread> threads;
+    threads.reserve(s.threads);
+    start = hce::chrono::now();
+
+    for(size_t t = 0; t < s.threads; ++t) {
+        threads.emplace_back([&]{
+            hce::sid sid;
+
+            for(size_t i = 0; i < s.pairs; ++i) {
+                ts.start(sid, timeout, &noop_handler, nullptr);
+                ts.cancel(sid);
+            }
+        });
+    }
+
+    for(auto& thd : threads) { thd.join(); }
+
+    const double pairs = nano(hce::chrono::now() - start);
+
+    // drain the outstanding timers
+    start = hce::chrono::now();
+
+    for(auto& sid : sids) { ts.cancel(sid); }
+
+    const double drain = nano(hce::chrono::now() - start);
+    const double total_pairs = (double)(s.pairs * s.threads);
+
+    auto per_second = [](double ops, double ns) {
+        return ns > 0.0 ? ops / (ns / 1e9) : 0.0;
+    };
+
+    std::stringstream ss;
+    ss << "{"
+       << "\"outstanding\":" << outstanding << ","
+       << "\"threads\":" << s.threads << ","
+       << "\"start_per_s\":" << per_second((double)outstanding, fill) << ","
+       << "\"start_cancel_pairs_per_s\":"
+       << per_second(total_pairs, pairs) << ","
+       << "\"start_cancel_pair_ns\":"
+       << (s.pairs ? pairs / (double)s.pairs : 0.0) << ","
+       << "\"cancel_per_s\":" << per_second((double)outstanding, drain)
+       << "}";
+    return ss.str();
+}
+
+}
+
+int main(int argc, char** argv) {
+    auto lifecycle = hce::initialize();
+
+    bench::settings s{
+        64,
+        200,
+        { 1000, 100000, 1000000 },
+        100000,
+        std::max(1u, std::thread::hardware_concurrency())
+    };
+
+    for(int i = 1; i < argc; ++i) {
+        if(std::string(argv[i]) == "--quick") {
+            s.sleepers = 16;
+            s.sleeps = 50;
+            s.outstanding = { 1000, 100000 };
+            s.pairs = 10000;
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--quick]" << std::endl;
+            return 1;
+        }
+    }
+
+    auto& ts = hce::timer::service::get();
+
+    std::cout << "{"
+              << "\"backend\":\""
+              << (ts.backend() == hce::config::timer::backend::timerfd
+                  ? "timerfd"
+                  : "condition_variable") << "\","
+              << "\"adaptive\":"
+              << (hce::config::timer::adaptive() ? "true" : "false") << ","
+              << "\"sleep\":" << bench::sleep_lateness(s) << ","
+              << "\"start_cancel\":[";
+
+    for(size_t i = 0; i < s.outstanding.size(); ++i) {
+        if(i) { std::cout << ","; }
+        std::cout << bench::start_cancel_throughput(s, s.outstanding[i]);
+    }
+
+    std::cout << "]}" << std::endl;
+    return 0;
+}